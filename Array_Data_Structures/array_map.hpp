@@ -5,8 +5,10 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
+#include "size_hint.hpp"
 
 
 namespace ics {
@@ -22,6 +24,7 @@ template<class KEY,class T> class ArrayMap {
 	  ArrayMap          ();
 	  explicit ArrayMap (int initial_length);
 	  ArrayMap          (const ArrayMap<KEY,T>& to_copy);
+	  ArrayMap          (ArrayMap<KEY,T>&&      to_move);  //to_move is left empty
 	  explicit ArrayMap (const std::initializer_list<Entry>& il);
 
     //Iterable class must support "for-each" loop: .begin()/.end()/.size() and prefix ++ on returned result
@@ -30,27 +33,35 @@ template<class KEY,class T> class ArrayMap {
 
 
     //Queries
-    bool empty     () const;
-    int  size       () const;
-    bool has_key    (const KEY& key) const;
-    bool has_value  (const T& value) const;
+    bool      empty     () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    bool      has_value  (const T& value) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     T    put   (const KEY& key, const T& value);
+    T    put   (const KEY& key, T&& value);
     T    erase (const KEY& key);
     void clear ();
+    void reserve (size_type n);   //Room for n entries: no reallocation while size() <= n
+
+    //If key is not in the map, put key with the value T(args...); if it is, leave
+    //  its value unchanged (and construct no T). Either way, return key's value.
+    template <class... Args>
+    T&   emplace (const KEY& key, Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int put_all (const Iterable& i);
+    size_type put_all (const Iterable& i);
 
 
     //Operators
     T&       operator [] (const KEY&);
     const T& operator [] (const KEY&) const;
     ArrayMap<KEY,T>& operator = (const ArrayMap<KEY,T>& rhs);
+    ArrayMap<KEY,T>& operator = (ArrayMap<KEY,T>&& rhs);  //Swaps contents with rhs
     bool operator == (const ArrayMap<KEY,T>& rhs) const;
     bool operator != (const ArrayMap<KEY,T>& rhs) const;
 
@@ -80,13 +91,13 @@ template<class KEY,class T> class ArrayMap {
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        int              current;
+        size_type        current;
         ArrayMap<KEY,T>* ref_map;
-        int              expected_mod_count;
+        size_type        expected_mod_count;
         bool             can_erase = true;
 
         //Called in friends begin/end
-        Iterator(ArrayMap<KEY,T>* iterate_over, int initial);
+        Iterator(ArrayMap<KEY,T>* iterate_over, size_type initial);
     };
 
 
@@ -96,16 +107,16 @@ template<class KEY,class T> class ArrayMap {
 
     private:
       Entry* map;        //Unordered contiguous array
-      int length    = 0; //Physical length of array: must be >= .size()
-      int used      = 0; //Amount of array used
-      int mod_count = 0; //For sensing concurrent modification
+      size_type length    = 0; //Physical length of array: must be >= .size()
+      size_type used      = 0; //Amount of array used
+      size_type mod_count = 0; //For sensing concurrent modification
 
       //Helper methods
-      int  index_of         (const KEY& key) const;
-      T    change_at        (int i, const T& value);
-      T    erase_at         (int i);
-      void ensure_length    (int new_length);
-      void ensure_length_low(int new_length);
+      size_type index_of         (const KEY& key) const;
+      T         change_at        (size_type i, const T& value);
+      T         erase_at         (size_type i);
+      void      ensure_length    (size_type new_length);
+      void      ensure_length_low(size_type new_length);
 };
 
 
@@ -143,11 +154,21 @@ template<class KEY,class T>
 ArrayMap<KEY,T>::ArrayMap(const ArrayMap<KEY,T>& to_copy)
 : length(to_copy.length), used(to_copy.used) {
   map = new Entry[length];
-  for (int i=0; i<to_copy.used; ++i)
+  for (size_type i=0; i<to_copy.used; ++i)
     map[i] = to_copy.map[i];
 }
 
 
+template<class KEY,class T>
+ArrayMap<KEY,T>::ArrayMap(ArrayMap<KEY,T>&& to_move) {
+  map = new Entry[length];
+  std::swap(map,   to_move.map);
+  std::swap(length,to_move.length);
+  std::swap(used,  to_move.used);
+  ++to_move.mod_count;
+}
+
+
 template<class KEY,class T>
 ArrayMap<KEY,T>::ArrayMap(const std::initializer_list<Entry>& il)
 : length(il.size()) {
@@ -178,7 +199,7 @@ bool ArrayMap<KEY,T>::empty() const {
 
 
 template<class KEY,class T>
-int ArrayMap<KEY,T>::size() const {
+size_type ArrayMap<KEY,T>::size() const {
   return used;
 }
 
@@ -191,7 +212,7 @@ bool ArrayMap<KEY,T>::has_key (const KEY& element) const {
 
 template<class KEY,class T>
 bool ArrayMap<KEY,T>::has_value (const T& element) const {
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (map[i].second == element)
       return true;
 
@@ -206,7 +227,7 @@ std::string ArrayMap<KEY,T>::str() const {
 
   if (length != 0) {
     answer << "0:" << map[0].first << "->" << map[0].second;
-    for (int i=1; i<length; ++i)
+    for (size_type i=1; i<length; ++i)
       answer << "," << i << ":" << map[i].first << "->" << map[i].second;
   }
 
@@ -221,7 +242,7 @@ std::string ArrayMap<KEY,T>::str() const {
 
 template<class KEY,class T>
 T ArrayMap<KEY,T>::put(const KEY& key, const T& value) {
-  int i = index_of(key);
+  size_type i = index_of(key);
   if (i != -1)
     return change_at(i,value);
 
@@ -232,9 +253,40 @@ T ArrayMap<KEY,T>::put(const KEY& key, const T& value) {
 }
 
 
+template<class KEY,class T>
+T ArrayMap<KEY,T>::put(const KEY& key, T&& value) {
+  size_type i = index_of(key);
+  if (i != -1) {
+    T old_value = std::move(map[i].second);
+    map[i].second = std::move(value);
+    ++mod_count;
+    return old_value;
+  }
+
+  this->ensure_length(used+1);
+  map[used++] = Entry(key,std::move(value));
+  ++mod_count;
+  return map[used-1].second;
+}
+
+
+template<class KEY,class T>
+template<class... Args>
+T& ArrayMap<KEY,T>::emplace(const KEY& key, Args&&... args) {
+  size_type i = index_of(key);
+  if (i != -1)
+    return map[i].second;
+
+  this->ensure_length(used+1);
+  map[used++] = Entry(key,T(std::forward<Args>(args)...));
+  ++mod_count;
+  return map[used-1].second;
+}
+
+
 template<class KEY,class T>
 T ArrayMap<KEY,T>::erase(const KEY& key) {
-  int i = index_of(key);
+  size_type i = index_of(key);
   if (i != -1)
     return erase_at(i);
 
@@ -252,10 +304,18 @@ void ArrayMap<KEY,T>::clear() {
 }
 
 
+template<class KEY,class T>
+void ArrayMap<KEY,T>::reserve(size_type n) {
+  this->ensure_length(n);
+  ++mod_count;
+}
+
+
 template<class KEY,class T>
 template<class Iterable>
-int ArrayMap<KEY,T>::put_all(const Iterable& i) {
-  int count = 0;
+size_type ArrayMap<KEY,T>::put_all(const Iterable& i) {
+  this->ensure_length(used+size_hint(i));
+  size_type count = 0;
   for (auto m_entry : i) {
     ++count;
     put(m_entry.first, m_entry.second);
@@ -271,7 +331,7 @@ int ArrayMap<KEY,T>::put_all(const Iterable& i) {
 
 template<class KEY,class T>
 T& ArrayMap<KEY,T>::operator [] (const KEY& key) {
-  int i = index_of(key);
+  size_type i = index_of(key);
   if (i != -1)
     return map[i].second;
 
@@ -284,7 +344,7 @@ T& ArrayMap<KEY,T>::operator [] (const KEY& key) {
 
 template<class KEY,class T>
 const T& ArrayMap<KEY,T>::operator [] (const KEY& key) const {
-  int i = index_of(key);
+  size_type i = index_of(key);
   if (i != -1)
     return map[i].second;
 
@@ -301,7 +361,7 @@ ArrayMap<KEY,T>& ArrayMap<KEY,T>::operator = (const ArrayMap<KEY,T>& rhs) {
 
   this->ensure_length(rhs.used);
   used = rhs.used;
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     map[i] = rhs.map[i];
 
   ++mod_count;
@@ -309,6 +369,20 @@ ArrayMap<KEY,T>& ArrayMap<KEY,T>::operator = (const ArrayMap<KEY,T>& rhs) {
 }
 
 
+template<class KEY,class T>
+ArrayMap<KEY,T>& ArrayMap<KEY,T>::operator = (ArrayMap<KEY,T>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(map,   rhs.map);
+  std::swap(length,rhs.length);
+  std::swap(used,  rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
 template<class KEY,class T>
 bool ArrayMap<KEY,T>::operator == (const ArrayMap<KEY,T>& rhs) const {
   if (this == &rhs)
@@ -317,9 +391,9 @@ bool ArrayMap<KEY,T>::operator == (const ArrayMap<KEY,T>& rhs) const {
   if (used != rhs.size())
     return false;
 
-  for (int i=0; i<used; ++i) {
+  for (size_type i=0; i<used; ++i) {
   // Uses ! and ==, so != on T need not be defined
-    int ri = rhs.index_of(map[i].first);
+    size_type ri = rhs.index_of(map[i].first);
     if (ri == -1 || !(map[i].second == rhs.map[ri].second))
       return false;
   }
@@ -344,7 +418,7 @@ std::ostream& operator << (std::ostream& outs, const ArrayMap<KEY,T>& m) {
 
   if (!m.empty()) {
     outs << m.map[0].first << "->" << m.map[0].second;
-    for (int i=1; i<m.used; ++i) {
+    for (size_type i=1; i<m.used; ++i) {
       outs << "," << m.map[i].first << "->" << m.map[i].second;
     }
   }
@@ -375,8 +449,8 @@ auto ArrayMap<KEY,T>::end () const -> ArrayMap<KEY,T>::Iterator {
 //Private helper methods
 
 template<class KEY,class T>
-int ArrayMap<KEY,T>::index_of(const KEY& key) const {
-  for (int i=0; i<used; ++i)
+size_type ArrayMap<KEY,T>::index_of(const KEY& key) const {
+  for (size_type i=0; i<used; ++i)
     if (map[i].first == key)
       return i;
 
@@ -385,7 +459,7 @@ int ArrayMap<KEY,T>::index_of(const KEY& key) const {
 
 
 template<class KEY,class T>
-T ArrayMap<KEY,T>::change_at(int i, const T& value) {
+T ArrayMap<KEY,T>::change_at(size_type i, const T& value) {
   T old_value = map[i].second;
   map[i].second = value;
   ++mod_count;
@@ -394,9 +468,9 @@ T ArrayMap<KEY,T>::change_at(int i, const T& value) {
 
 
 template<class KEY,class T>
-T ArrayMap<KEY,T>::erase_at(int i) {
-  T erased = map[i].second;
-  map[i] = map[--used];
+T ArrayMap<KEY,T>::erase_at(size_type i) {
+  T erased = std::move(map[i].second);
+  map[i] = std::move(map[--used]);
   this->ensure_length_low(used);
   ++mod_count;
   return erased;
@@ -404,28 +478,28 @@ T ArrayMap<KEY,T>::erase_at(int i) {
 
 
 template<class KEY,class T>
-void ArrayMap<KEY,T>::ensure_length(int new_length) {
+void ArrayMap<KEY,T>::ensure_length(size_type new_length) {
   if (length >= new_length)
     return;
   Entry* old_map = map;
   length = std::max(new_length,2*length);
   map = new Entry[length];
-  for (int i=0; i<used; ++i)
-    map[i] = old_map[i];
+  for (size_type i=0; i<used; ++i)
+    map[i] = std::move(old_map[i]);
 
   delete [] old_map;
 }
 
 
   template<class KEY,class T>
-  void ArrayMap<KEY,T>::ensure_length_low(int new_length) {
+  void ArrayMap<KEY,T>::ensure_length_low(size_type new_length) {
   if (length < 4 * new_length)
     return;
   Entry* old_map = map;
   length = 2 * new_length;
   map = new Entry[length];
-  for (int i=0; i<used; ++i)
-    map[i] = old_map[i];
+  for (size_type i=0; i<used; ++i)
+    map[i] = std::move(old_map[i]);
 
   delete[] old_map;
 }
@@ -438,7 +512,7 @@ void ArrayMap<KEY,T>::ensure_length(int new_length) {
 //Iterator class definitions
 
 template<class KEY,class T>
-ArrayMap<KEY,T>::Iterator::Iterator(ArrayMap<KEY,T>* iterate_over, int initial) : current(initial), ref_map(iterate_over) {
+ArrayMap<KEY,T>::Iterator::Iterator(ArrayMap<KEY,T>* iterate_over, size_type initial) : current(initial), ref_map(iterate_over) {
   expected_mod_count = ref_map->mod_count;
 }
 
@@ -5,7 +5,10 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <algorithm>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "size_hint.hpp"
 
 
 namespace ics {
@@ -31,6 +34,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Ar
     ArrayPriorityQueue          (bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     explicit ArrayPriorityQueue (int initial_length, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     ArrayPriorityQueue          (const ArrayPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    ArrayPriorityQueue          (ArrayPriorityQueue<T,tgt>&& to_move);  //Uses to_move's gt; to_move is left empty
     explicit ArrayPriorityQueue (const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
 
     //Iterable class must support "for-each" loop: .begin()/.end()/.size() and prefix ++ on returned result
@@ -39,25 +43,32 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Ar
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
 
     int  enqueue (const T& element);
+    int  enqueue (T&& element);
     T    dequeue ();
     void clear   ();
+    void reserve (size_type n);   //Room for n values: no reallocation while size() <= n
+
+    //Enqueue T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int enqueue_all (const Iterable& i);
+    size_type enqueue_all (const Iterable& i);
 
 
     //Operators
     ArrayPriorityQueue<T,tgt>& operator = (const ArrayPriorityQueue<T,tgt>& rhs);
+    ArrayPriorityQueue<T,tgt>& operator = (ArrayPriorityQueue<T,tgt>&& rhs);  //Swaps contents (and gt) with rhs
     bool operator == (const ArrayPriorityQueue<T,tgt>& rhs) const;
     bool operator != (const ArrayPriorityQueue<T,tgt>& rhs) const;
 
@@ -88,13 +99,13 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Ar
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        int                        current;
+        size_type                  current;
         ArrayPriorityQueue<T,tgt>* ref_pq;
-        int                        expected_mod_count;
+        size_type                  expected_mod_count;
         bool                       can_erase = true;
 
         //Called in friends begin/end
-        Iterator(ArrayPriorityQueue<T,tgt>* iterate_over, int initial);
+        Iterator(ArrayPriorityQueue<T,tgt>* iterate_over, size_type initial);
     };
 
 
@@ -105,15 +116,16 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Ar
   private:
     bool (*gt) (const T& a, const T& b); // The gt used by enqueue (from template or constructor)
     T*  pq;                              // Smaller values in lower indexes (biggest is at used-1)
-    int length    = 0;                   //Physical length of array: must be >= .size()
-    int used      = 0;                   //Amount of array used:  invariant: 0 <= used <= length
-    int mod_count = 0;                   //For sensing concurrent modification
+    size_type length    = 0;             //Physical length of array: must be >= .size()
+    size_type used      = 0;             //Amount of array used:  invariant: 0 <= used <= length
+    size_type mod_count = 0;             //For sensing concurrent modification
 
 
     //Helper methods
-    int erase_at          (int i);
-    void ensure_length    (int new_length);
-    void ensure_length_low(int new_length);
+    bool call_gt          (const T& a, const T& b) const;  //tgt(a,b) if given (a direct call: inlinable), else gt(a,b)
+    int erase_at          (size_type i);
+    void ensure_length    (size_type new_length);
+    void ensure_length_low(size_type new_length);
   };
 
 
@@ -170,14 +182,25 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const ArrayPriorityQueue<T,tgt>& t
 
   if (gt == to_copy.gt) {
     used = to_copy.used;
-    for (int i=0; i<to_copy.used; ++i)
+    for (size_type i=0; i<to_copy.used; ++i)
       pq[i] = to_copy.pq[i];
   }else
-    for (int i=0; i<to_copy.used; ++i)
+    for (size_type i=0; i<to_copy.used; ++i)
       enqueue(to_copy.pq[i]);
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(ArrayPriorityQueue<T,tgt>&& to_move)
+: gt(to_move.gt) {
+  pq = new T[length];
+  std::swap(pq,    to_move.pq);
+  std::swap(length,to_move.length);
+  std::swap(used,  to_move.used);
+  ++to_move.mod_count;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
 : gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt), length(il.size()) {
@@ -187,8 +210,7 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const std::initializer_list<T>& il
     throw TemplateFunctionError("ArrayPriorityQueue::initializer_list constructor: both specified and different");
 
   pq = new T[length];
-  for (const T& pq_elem : il)
-    enqueue(pq_elem);
+  enqueue_all(il);
 }
 
 
@@ -202,8 +224,7 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const Iterable& i, bool (*cgt)(con
     throw TemplateFunctionError("ArrayPriorityQueue::Iterable constructor: both specified and different");
 
   pq = new T[length];
-  for (const T& v : i)
-    enqueue(v);
+  enqueue_all(i);
   }
 
 
@@ -218,7 +239,7 @@ bool ArrayPriorityQueue<T,tgt>::empty() const {
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int ArrayPriorityQueue<T,tgt>::size() const {
+size_type ArrayPriorityQueue<T,tgt>::size() const {
   return used;
 }
 
@@ -239,7 +260,7 @@ std::string ArrayPriorityQueue<T,tgt>::str() const {
 
   if (length != 0) {
     answer << "0:" << pq[0];
-    for (int i=1; i<length; ++i)
+    for (size_type i=1; i<length; ++i)
       answer << "," << i << ":" << pq[i];
   }
 
@@ -256,8 +277,22 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 int ArrayPriorityQueue<T,tgt>::enqueue(const T& element) {
   this->ensure_length(used+1);
   pq[used++] = element;
-  for (int i=used-2; i>=0; --i)
-    if (gt(pq[i],pq[i+1]))
+  for (size_type i=used-2; i>=0; --i)
+    if (call_gt(pq[i],pq[i+1]))
+      std::swap(pq[i],pq[i+1]);
+    else
+      break;
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int ArrayPriorityQueue<T,tgt>::enqueue(T&& element) {
+  this->ensure_length(used+1);
+  pq[used++] = std::move(element);
+  for (size_type i=used-2; i>=0; --i)
+    if (call_gt(pq[i],pq[i+1]))
       std::swap(pq[i],pq[i+1]);
     else
       break;
@@ -266,13 +301,20 @@ int ArrayPriorityQueue<T,tgt>::enqueue(const T& element) {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class... Args>
+int ArrayPriorityQueue<T,tgt>::emplace(Args&&... args) {
+  return enqueue(T(std::forward<Args>(args)...));
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T ArrayPriorityQueue<T,tgt>::dequeue() {
   if (this->empty())
     throw EmptyError("ArrayPriorityQueue::dequeue");
 
   ++mod_count;
-  T to_return = pq[--used];
+  T to_return = std::move(pq[--used]);
   this->ensure_length_low(used);
   return to_return;
 }
@@ -285,13 +327,33 @@ void ArrayPriorityQueue<T,tgt>::clear() {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void ArrayPriorityQueue<T,tgt>::reserve(size_type n) {
+  this->ensure_length(n);
+  ++mod_count;
+}
+
+
+//Append all the values, sort them, and merge them with the (already sorted)
+//  old ones: O(N log N) instead of shifting each new value into place, O(N^2).
+//Both sorts are stable, so equal priorities end up in the same order enqueue gives.
 template<class T, bool (*tgt)(const T& a, const T& b)>
 template <class Iterable>
-int ArrayPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
-  int count = 0;
-  for (const T& v : i)
-     count += enqueue(v);
+size_type ArrayPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
+  this->ensure_length(used+size_hint(i));
+  size_type old_used = used;
+  for (const T& v : i) {
+    this->ensure_length(used+1);
+    pq[used++] = v;
+  }
+
+  auto lower = [this] (const T& a, const T& b) {return call_gt(b,a);};
+  std::stable_sort(pq+old_used, pq+used, lower);
+  std::inplace_merge(pq, pq+old_used, pq+used, lower);
 
+  size_type count = used-old_used;
+  if (count != 0)
+    ++mod_count;
   return count;
 }
 
@@ -308,7 +370,7 @@ ArrayPriorityQueue<T,tgt>& ArrayPriorityQueue<T,tgt>::operator = (const ArrayPri
   gt = rhs.gt;   // if tgt != undefinedgt, gts are already equal (or compiler error)
   this->ensure_length(rhs.used);
   used = rhs.used;
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     pq[i] = rhs.pq[i];
 
   ++mod_count;
@@ -316,6 +378,21 @@ ArrayPriorityQueue<T,tgt>& ArrayPriorityQueue<T,tgt>::operator = (const ArrayPri
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+ArrayPriorityQueue<T,tgt>& ArrayPriorityQueue<T,tgt>::operator = (ArrayPriorityQueue<T,tgt>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(gt,    rhs.gt);
+  std::swap(pq,    rhs.pq);
+  std::swap(length,rhs.length);
+  std::swap(used,  rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
   bool ArrayPriorityQueue<T,tgt>::operator == (const ArrayPriorityQueue<T,tgt>& rhs) const {
   if (this == &rhs)
@@ -328,7 +405,7 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
     return false;
 
   ArrayPriorityQueue<T,tgt>::Iterator rhs_i = rhs.begin();
-  for (int i=used-1; i>=0; --i,++rhs_i)
+  for (size_type i=used-1; i>=0; --i,++rhs_i)
     // Uses ! and ==, so != on T need not be defined
     if (!(pq[i] == *rhs_i))
       return false;
@@ -349,7 +426,7 @@ std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T,tgt>&
 
   if (!p.empty()) {
     outs << p.pq[0];
-    for (int i=1; i<p.used; ++i)
+    for (size_type i=1; i<p.used; ++i)
       outs << ","<< p.pq[i];
   }
 
@@ -379,9 +456,15 @@ auto ArrayPriorityQueue<T,tgt>::end () const -> ArrayPriorityQueue<T,tgt>::Itera
 //Private helper methods
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int ArrayPriorityQueue<T,tgt>::erase_at(int i) {
-  for (int j=i; j<used-1; ++j)
-    pq[j] = pq[j+1];
+bool ArrayPriorityQueue<T,tgt>::call_gt (const T& a, const T& b) const {
+  return tgt != (gtfunc)undefinedgt<T> ? tgt(a,b) : gt(a,b);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int ArrayPriorityQueue<T,tgt>::erase_at(size_type i) {
+  for (size_type j=i; j<used-1; ++j)
+    pq[j] = std::move(pq[j+1]);
   --used;
   this->ensure_length_low(used);
   ++mod_count;
@@ -390,28 +473,28 @@ int ArrayPriorityQueue<T,tgt>::erase_at(int i) {
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void ArrayPriorityQueue<T,tgt>::ensure_length(int new_length) {
+void ArrayPriorityQueue<T,tgt>::ensure_length(size_type new_length) {
   if (length >= new_length)
     return;
   T* old_pq = pq;
   length = std::max(new_length,2*length);
   pq = new T[length];
-  for (int i=0; i<used; ++i)
-    pq[i] = old_pq[i];
+  for (size_type i=0; i<used; ++i)
+    pq[i] = std::move(old_pq[i]);
 
   delete [] old_pq;
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void ArrayPriorityQueue<T,tgt>::ensure_length_low(int new_length) {
+void ArrayPriorityQueue<T,tgt>::ensure_length_low(size_type new_length) {
   if (length < 4*new_length)
     return;
   T* old_pq = pq;
   length = 2*new_length;
   pq = new T[length];
-  for (int i=0; i<used; ++i)
-    pq[i] = old_pq[i];
+  for (size_type i=0; i<used; ++i)
+    pq[i] = std::move(old_pq[i]);
 
   delete [] old_pq;
 }
@@ -425,7 +508,7 @@ void ArrayPriorityQueue<T,tgt>::ensure_length_low(int new_length) {
 //Iterator class definitions
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::Iterator::Iterator(ArrayPriorityQueue<T,tgt>* iterate_over, int initial)
+ArrayPriorityQueue<T,tgt>::Iterator::Iterator(ArrayPriorityQueue<T,tgt>* iterate_over, size_type initial)
 : current(initial), ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count) {
 }
 
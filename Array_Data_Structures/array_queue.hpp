@@ -5,7 +5,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "size_hint.hpp"
 
 
 namespace ics {
@@ -19,6 +21,7 @@ template<class T> class ArrayQueue {
     ArrayQueue          ();
     explicit ArrayQueue (int initial_length);
     ArrayQueue          (const ArrayQueue<T>& to_copy);
+    ArrayQueue          (ArrayQueue<T>&&      to_move);  //to_move is left empty
     explicit ArrayQueue (const std::initializer_list<T>& il);
 
     //Iterable class must support "for-each" loop: .begin()/.end()/.size() and prefix ++ on returned result
@@ -27,24 +30,31 @@ template<class T> class ArrayQueue {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     int  enqueue (const T& element);
+    int  enqueue (T&& element);
     T    dequeue ();
     void clear   ();
+    void reserve (size_type n);   //Room for n values: no reallocation while size() <= n
+
+    //Enqueue T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int enqueue_all (const Iterable& i);
+    size_type enqueue_all (const Iterable& i);
 
 
     //Operators
     ArrayQueue<T>& operator = (const ArrayQueue<T>& rhs);
+    ArrayQueue<T>& operator = (ArrayQueue<T>&& rhs);      //Swaps contents with rhs
     bool operator == (const ArrayQueue<T>& rhs) const;
     bool operator != (const ArrayQueue<T>& rhs) const;
 
@@ -74,13 +84,13 @@ template<class T> class ArrayQueue {
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        int            current;
+        size_type      current;
         ArrayQueue<T>* ref_queue;
-        int            expected_mod_count;
+        size_type      expected_mod_count;
         bool           can_erase = true;
 
         //Called in friends begin/end
-        Iterator(ArrayQueue<T>* iterate_over, int initial);
+        Iterator(ArrayQueue<T>* iterate_over, size_type initial);
     };
 
 
@@ -90,16 +100,16 @@ template<class T> class ArrayQueue {
 
   private:
     T*  queue;          //Circular array with data stored in indexes front to rear-1
-    int length    =  1; //Physical length of array: must be strictly > .size()
-    int front     =  0; //Array index of front in queue
-    int rear      =  0; //Array index ONE BEYOND rear in queue
-    int mod_count =  0; //For sensing concurrent modification
+    size_type length    =  1; //Physical length of array: must be strictly > .size()
+    size_type front     =  0; //Array index of front in queue
+    size_type rear      =  0; //Array index ONE BEYOND rear in queue
+    size_type mod_count =  0; //For sensing concurrent modification
 
     //Helper methods
-    int  erase_at         (int i);
-    void ensure_length    (int new_length);
-    void ensure_length_low(int new_length);
-    bool is_in            (int i) const;
+    int  erase_at         (size_type i);
+    void ensure_length    (size_type new_length);
+    void ensure_length_low(size_type new_length);
+    bool is_in            (size_type i) const;
   };
 
 
@@ -139,12 +149,23 @@ ArrayQueue<T>::ArrayQueue(const ArrayQueue<T>& to_copy)
   queue = new T[length];
   front = 0;
   rear  = to_copy.size();
-  for (int i=0; i<rear; ++i)
+  for (size_type i=0; i<rear; ++i)
     queue[i] = to_copy.queue[(to_copy.front+i)%to_copy.length];
   //resulting queue starts at front of array, regardless of where to_copy starts
 }
 
 
+template<class T>
+ArrayQueue<T>::ArrayQueue(ArrayQueue<T>&& to_move) {
+  queue = new T[length];
+  std::swap(queue, to_move.queue);
+  std::swap(length,to_move.length);
+  std::swap(front, to_move.front);
+  std::swap(rear,  to_move.rear);
+  ++to_move.mod_count;
+}
+
+
 template<class T>
 ArrayQueue<T>::ArrayQueue(const std::initializer_list<T>& il)
 : length(il.size()) {
@@ -175,7 +196,7 @@ bool ArrayQueue<T>::empty() const {
 
 
 template<class T>
-int ArrayQueue<T>::size() const {
+size_type ArrayQueue<T>::size() const {
   return rear >= front ? rear-front : length-(front-rear);
 }
 
@@ -195,7 +216,7 @@ std::string ArrayQueue<T>::str() const {
   answer << "ArrayQueue[";
 
   if (length != 0)
-    for (int i=0; i<length; ++i) {
+    for (size_type i=0; i<length; ++i) {
       answer << i << ":";
       if (this->is_in(i))
         answer << queue[i];
@@ -221,12 +242,29 @@ int ArrayQueue<T>::enqueue(const T& element) {
 }
 
 
+template<class T>
+int ArrayQueue<T>::enqueue(T&& element) {
+  this->ensure_length(this->size()+1);
+  queue[rear] = std::move(element);
+  rear = (rear+1)%length;
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T>
+template<class... Args>
+int ArrayQueue<T>::emplace(Args&&... args) {
+  return enqueue(T(std::forward<Args>(args)...));
+}
+
+
 template<class T>
 T ArrayQueue<T>::dequeue() {
   if (this->empty())
     throw EmptyError("ArrayQueue::dequeue");
 
-  T answer = queue[front];
+  T answer = std::move(queue[front]);
   front = (front+1)%length;
   this->ensure_length_low(this->size());
   ++mod_count;
@@ -243,10 +281,18 @@ void ArrayQueue<T>::clear() {
 }
 
 
+template<class T>
+void ArrayQueue<T>::reserve(size_type n) {
+  this->ensure_length(n);
+  ++mod_count;
+}
+
+
 template<class T>
 template<class Iterable>
-int ArrayQueue<T>::enqueue_all(const Iterable& i) {
-  int count = 0;
+size_type ArrayQueue<T>::enqueue_all(const Iterable& i) {
+  this->ensure_length(this->size()+size_hint(i));
+  size_type count = 0;
   for (const T& v : i)
      count += enqueue(v);
 
@@ -266,7 +312,7 @@ ArrayQueue<T>& ArrayQueue<T>::operator = (const ArrayQueue<T>& rhs) {
   front = 0;
   rear = rhs.size();
   this->ensure_length(rear);
-  for (int i=0; i<rear; ++i)
+  for (size_type i=0; i<rear; ++i)
     queue[i] = rhs.queue[(rhs.front+i)%rhs.length];
   //resulting queue starts at front of array, regardless of where to_copy starts
 
@@ -275,17 +321,32 @@ ArrayQueue<T>& ArrayQueue<T>::operator = (const ArrayQueue<T>& rhs) {
 }
 
 
+template<class T>
+ArrayQueue<T>& ArrayQueue<T>::operator = (ArrayQueue<T>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(queue, rhs.queue);
+  std::swap(length,rhs.length);
+  std::swap(front, rhs.front);
+  std::swap(rear,  rhs.rear);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
 template<class T>
 bool ArrayQueue<T>::operator == (const ArrayQueue<T>& rhs) const {
   if (this == &rhs)
     return true;
 
-  int used = this->size();
+  size_type used = this->size();
   if (used != rhs.size())
     return false;
 
   ArrayQueue<T>::Iterator rhs_i = rhs.begin();
-  for (int i=0; i<used; ++i,++rhs_i)
+  for (size_type i=0; i<used; ++i,++rhs_i)
     // Uses ! and ==, so != on T need not be defined
     if (!(queue[(front+i)%length] == *rhs_i))
       return false;
@@ -306,7 +367,7 @@ std::ostream& operator << (std::ostream& outs, const ArrayQueue<T>& q) {
 
   if (!q.empty()) {
     outs << q.queue[q.front];
-    for (int i=(q.front+1)%q.length; i!=q.rear; i=(i+1)%q.length)
+    for (size_type i=(q.front+1)%q.length; i!=q.rear; i=(i+1)%q.length)
       outs << "," << q.queue[i];
   }
 
@@ -336,12 +397,12 @@ auto ArrayQueue<T>::end () const -> ArrayQueue<T>::Iterator {
 //Private helper methods
 
 template<class T>
-int ArrayQueue<T>::erase_at(int i) {
-  int shift_count = (rear >= i ? rear-i-1: length-(i-rear))-1;
-  int to   = i;
-  int from = (to+1)%length;
-  for (int i=0; i<=shift_count; ++i) {
-    queue[to] = queue[from];
+int ArrayQueue<T>::erase_at(size_type i) {
+  size_type shift_count = (rear >= i ? rear-i-1: length-(i-rear))-1;
+  size_type to   = i;
+  size_type from = (to+1)%length;
+  for (size_type i=0; i<=shift_count; ++i) {
+    queue[to] = std::move(queue[from]);
     to = from;
     from = (from+1)%length;
   }
@@ -353,17 +414,17 @@ int ArrayQueue<T>::erase_at(int i) {
 
 
 template<class T>
-void ArrayQueue<T>::ensure_length(int new_length) {
+void ArrayQueue<T>::ensure_length(size_type new_length) {
   //length must be > new_length; remember requirement of length at least size()+1
   if (length > new_length)
     return;
   T*  old_queue  = queue;
-  int old_length = length;
-  int used = this->size(); //must precede length change; see computation of size()!
+  size_type old_length = length;
+  size_type used = this->size(); //must precede length change; see computation of size()!
   length = 1+std::max(new_length,2*(length-1));
   queue  = new T[length];
-  for (int i=0; i<used; ++i)
-    queue[i] = old_queue[(front+i)%old_length];
+  for (size_type i=0; i<used; ++i)
+    queue[i] = std::move(old_queue[(front+i)%old_length]);
   front = 0;
   rear  = used;
 
@@ -372,17 +433,17 @@ void ArrayQueue<T>::ensure_length(int new_length) {
 
 
 template<class T>
-void ArrayQueue<T>::ensure_length_low(int new_length) {
+void ArrayQueue<T>::ensure_length_low(size_type new_length) {
   //length must be > new_length; remember requirement of length at least size()+1
   if (length-1 < 4*new_length)
     return;
   T*  old_queue  = queue;
-  int old_length = length;
-  int used = this->size(); //must precede length change!
+  size_type old_length = length;
+  size_type used = this->size(); //must precede length change!
   length = 1+2*new_length;
   queue  = new T[length];
-  for (int i=0; i<used; ++i)
-    queue[i] = old_queue[(front+i)%old_length];
+  for (size_type i=0; i<used; ++i)
+    queue[i] = std::move(old_queue[(front+i)%old_length]);
   front = 0;
   rear  = used;
 
@@ -391,7 +452,7 @@ void ArrayQueue<T>::ensure_length_low(int new_length) {
 
 
   template<class T>
-bool ArrayQueue<T>::is_in(int i) const {
+bool ArrayQueue<T>::is_in(size_type i) const {
   return  rear >= front ? (i>=front && i<rear) : (i>=front || i<rear);
 }
 
@@ -404,7 +465,7 @@ bool ArrayQueue<T>::is_in(int i) const {
 //Iterator class definitions
 
 template<class T>
-ArrayQueue<T>::Iterator::Iterator(ArrayQueue<T>* iterate_over, int initial)
+ArrayQueue<T>::Iterator::Iterator(ArrayQueue<T>* iterate_over, size_type initial)
 : current(initial), ref_queue(iterate_over), expected_mod_count(ref_queue->mod_count) {
 }
 
@@ -5,7 +5,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "size_hint.hpp"
 
 
 namespace ics {
@@ -19,6 +21,7 @@ template<class T> class ArraySet {
  	  ArraySet          ();
 	  explicit ArraySet (int initial_length);
 	  ArraySet          (const ArraySet<T>& to_copy);
+	  ArraySet          (ArraySet<T>&&      to_move);  //to_move is left empty
 	  explicit ArraySet (const std::initializer_list<T>& il);
 
     //Iterable class must support "for-each" loop: .begin()/.end()/.size() and prefix ++ on returned result
@@ -27,9 +30,9 @@ template<class T> class ArraySet {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    bool contains   (const T& element) const;
+    bool      empty      () const;
+    size_type size       () const;
+    bool      contains   (const T& element) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -38,24 +41,31 @@ template<class T> class ArraySet {
 
 
     //Commands
-    int  insert (const T& element);
-    int  erase  (const T& element);
-    void clear  ();
+    int       insert (const T& element);
+    int       insert (T&& element);
+    int       erase  (const T& element);
+    void      clear  ();
+    void      reserve(size_type n);   //Room for n values: no reallocation while size() <= n
+
+    //Insert T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
 
     //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
 
     template <class Iterable>
-    int insert_all(const Iterable& i);
+    size_type insert_all(const Iterable& i);
 
     template <class Iterable>
-    int erase_all(const Iterable& i);
+    size_type erase_all(const Iterable& i);
 
     template<class Iterable>
-    int retain_all(const Iterable& i);
+    size_type retain_all(const Iterable& i);
 
 
     //Operators
     ArraySet<T>& operator = (const ArraySet<T>& rhs);
+    ArraySet<T>& operator = (ArraySet<T>&& rhs);          //Swaps contents with rhs
     bool operator == (const ArraySet<T>& rhs) const;
     bool operator != (const ArraySet<T>& rhs) const;
     bool operator <= (const ArraySet<T>& rhs) const;
@@ -89,13 +99,13 @@ template<class T> class ArraySet {
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        int          current;
+        size_type    current;
         ArraySet<T>* ref_set;
-        int          expected_mod_count;
+        size_type    expected_mod_count;
         bool         can_erase = true;
 
         //Called in friends begin/end
-        Iterator(ArraySet<T>* iterate_over, int initial);
+        Iterator(ArraySet<T>* iterate_over, size_type initial);
     };
 
 
@@ -105,14 +115,14 @@ template<class T> class ArraySet {
 
   private:
     T*  set;           //Unordered contiguous array
-    int length    = 0; //Physical length of array: must be >= .size()
-    int used      = 0; //Amount of array used: invariant: 0 <= used <= length
-    int mod_count = 0; //For sensing concurrent modification
+    size_type length    = 0; //Physical length of array: must be >= .size()
+    size_type used      = 0; //Amount of array used: invariant: 0 <= used <= length
+    size_type mod_count = 0; //For sensing concurrent modification
 
     //Helper methods
-    int  erase_at       (int i);
-  void ensure_length    (int new_length);
-  void ensure_length_low(int new_length);
+    int  erase_at       (size_type i);
+  void ensure_length    (size_type new_length);
+  void ensure_length_low(size_type new_length);
   };
 
 
@@ -150,11 +160,21 @@ template<class T>
 ArraySet<T>::ArraySet(const ArraySet<T>& to_copy)
 : length(to_copy.length), used(to_copy.used) {
   set = new T[length];
-  for (int i=0; i<to_copy.used; ++i)
+  for (size_type i=0; i<to_copy.used; ++i)
     set[i] = to_copy.set[i];
 }
 
 
+template<class T>
+ArraySet<T>::ArraySet(ArraySet<T>&& to_move) {
+  set = new T[length];
+  std::swap(set,   to_move.set);
+  std::swap(length,to_move.length);
+  std::swap(used,  to_move.used);
+  ++to_move.mod_count;
+}
+
+
 template<class T>
 ArraySet<T>::ArraySet(const std::initializer_list<T>& il)
 : length(il.size()) {
@@ -185,14 +205,14 @@ bool ArraySet<T>::empty() const {
 
 
 template<class T>
-int ArraySet<T>::size() const {
+size_type ArraySet<T>::size() const {
   return used;
 }
 
 
 template<class T>
 bool ArraySet<T>::contains (const T& element) const {
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (set[i] == element)
       return true;
 
@@ -207,7 +227,7 @@ std::string ArraySet<T>::str() const {
 
   if (length != 0) {
     answer << "0:" << set[0];
-    for (int i=1; i<length; ++i)
+    for (size_type i=1; i<length; ++i)
       answer << "," << i << ":" << set[i];
   }
 
@@ -233,7 +253,7 @@ bool ArraySet<T>::contains_all (const Iterable& i) const {
 
 template<class T>
 int ArraySet<T>::insert(const T& element) {
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (set[i] == element)
       return 0;
 
@@ -244,9 +264,29 @@ int ArraySet<T>::insert(const T& element) {
 }
 
 
+template<class T>
+int ArraySet<T>::insert(T&& element) {
+  for (size_type i=0; i<used; ++i)
+    if (set[i] == element)
+      return 0;
+
+  this->ensure_length(used+1);
+  set[used++] = std::move(element);
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T>
+template<class... Args>
+int ArraySet<T>::emplace(Args&&... args) {
+  return insert(T(std::forward<Args>(args)...));
+}
+
+
 template<class T>
 int ArraySet<T>::erase(const T& element) {
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (set[i] == element)
       return erase_at(i);
 
@@ -262,10 +302,18 @@ void ArraySet<T>::clear() {
 }
 
 
+template<class T>
+void ArraySet<T>::reserve(size_type n) {
+  this->ensure_length(n);
+  ++mod_count;
+}
+
+
 template<class T>
 template<class Iterable>
-int ArraySet<T>::insert_all(const Iterable& i) {
-  int count = 0;
+size_type ArraySet<T>::insert_all(const Iterable& i) {
+  this->ensure_length(used+size_hint(i));
+  size_type count = 0;
   for (const T& v : i)
      count += insert(v);
 
@@ -275,8 +323,8 @@ int ArraySet<T>::insert_all(const Iterable& i) {
 
 template<class T>
 template<class Iterable>
-int ArraySet<T>::erase_all(const Iterable& i) {
-  int count = 0;
+size_type ArraySet<T>::erase_all(const Iterable& i) {
+  size_type count = 0;
   for (const T& v : i)
      count += erase(v);
 
@@ -286,10 +334,10 @@ int ArraySet<T>::erase_all(const Iterable& i) {
 
 template<class T>
 template<class Iterable>
-int ArraySet<T>::retain_all(const Iterable& i) {
+size_type ArraySet<T>::retain_all(const Iterable& i) {
   ArraySet s(i);
-  int count = 0;
-  for (int i=0; i<used; i++)
+  size_type count = 0;
+  for (size_type i=0; i<used; i++)
     if (!s.contains(set[i])) {
       erase_at(i);
       --i;
@@ -311,7 +359,7 @@ ArraySet<T>& ArraySet<T>::operator = (const ArraySet<T>& rhs) {
 
   this->ensure_length(rhs.used);
   used = rhs.used;
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     set[i] = rhs.set[i];
 
   ++mod_count;
@@ -319,6 +367,20 @@ ArraySet<T>& ArraySet<T>::operator = (const ArraySet<T>& rhs) {
 }
 
 
+template<class T>
+ArraySet<T>& ArraySet<T>::operator = (ArraySet<T>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(set,   rhs.set);
+  std::swap(length,rhs.length);
+  std::swap(used,  rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
 template<class T>
 bool ArraySet<T>::operator == (const ArraySet<T>& rhs) const {
   if (this == &rhs)
@@ -327,7 +389,7 @@ bool ArraySet<T>::operator == (const ArraySet<T>& rhs) const {
   if (used != rhs.size())
     return false;
 
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (!rhs.contains(set[i]))
       return false;
 
@@ -349,7 +411,7 @@ bool ArraySet<T>::operator <= (const ArraySet<T>& rhs) const {
   if (used > rhs.size())
     return false;
 
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (!rhs.contains(set[i]))
       return false;
 
@@ -365,7 +427,7 @@ bool ArraySet<T>::operator < (const ArraySet<T>& rhs) const {
   if (used >= rhs.size())
     return false;
 
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     if (!rhs.contains(set[i]))
       return false;
 
@@ -391,7 +453,7 @@ std::ostream& operator << (std::ostream& outs, const ArraySet<T>& s) {
 
   if (!s.empty()) {
     outs << s.set[0];
-    for (int i=1; i < s.used; ++i)
+    for (size_type i=1; i < s.used; ++i)
       outs << ","<< s.set[i];
   }
 
@@ -421,8 +483,8 @@ auto ArraySet<T>::end () const -> ArraySet<T>::Iterator {
 //Private helper methods
 
 template<class T>
-int ArraySet<T>::erase_at(int i) {
-  set[i] = set[--used];
+int ArraySet<T>::erase_at(size_type i) {
+  set[i] = std::move(set[--used]);
   this->ensure_length_low(used);
   ++mod_count;
   return 1;
@@ -430,28 +492,28 @@ int ArraySet<T>::erase_at(int i) {
 
 
 template<class T>
-void ArraySet<T>::ensure_length(int new_length) {
+void ArraySet<T>::ensure_length(size_type new_length) {
   if (length >= new_length)
     return;
   T* old_set = set;
   length = std::max(new_length,2*length);
   set = new T[length];
-  for (int i=0; i<used; ++i)
-    set[i] = old_set[i];
+  for (size_type i=0; i<used; ++i)
+    set[i] = std::move(old_set[i]);
 
   delete [] old_set;
 }
 
 
 template<class T>
-void ArraySet<T>::ensure_length_low(int new_length) {
+void ArraySet<T>::ensure_length_low(size_type new_length) {
   if (length < 4 * new_length)
     return;
   T *old_set = set;
   length = 2 * new_length;
   set = new T[length];
-  for (int i = 0; i < used; ++i)
-    set[i] = old_set[i];
+  for (size_type i = 0; i < used; ++i)
+    set[i] = std::move(old_set[i]);
 
   delete[] old_set;
 }
@@ -464,7 +526,7 @@ void ArraySet<T>::ensure_length_low(int new_length) {
 //Iterator class definitions
 
 template<class T>
-ArraySet<T>::Iterator::Iterator(ArraySet<T>* iterate_over, int initial)
+ArraySet<T>::Iterator::Iterator(ArraySet<T>* iterate_over, size_type initial)
 : current(initial), ref_set(iterate_over), expected_mod_count(ref_set->mod_count) {
 }
 
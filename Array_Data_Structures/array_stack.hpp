@@ -5,7 +5,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "size_hint.hpp"
 
 
 namespace ics {
@@ -19,6 +21,7 @@ template<class T> class ArrayStack {
     ArrayStack          ();
     explicit ArrayStack (int initial_length);
     ArrayStack          (const ArrayStack<T>&     to_copy);
+    ArrayStack          (ArrayStack<T>&&          to_move);  //to_move is left empty
     explicit ArrayStack (const std::initializer_list<T>& il);
 
     //Iterable class must support "for-each" loop: .begin()/.end()/.size() and prefix ++ on returned result
@@ -27,24 +30,31 @@ template<class T> class ArrayStack {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     int  push (const T& element);
+    int  push (T&& element);
     T    pop  ();
     void clear();
+    void reserve(size_type n);   //Room for n values: no reallocation while size() <= n
+
+    //Push T(args...)
+    template <class... Args>
+    int emplace(Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int push_all(const Iterable& i);
+    size_type push_all(const Iterable& i);
 
 
     //Operators
     ArrayStack<T>& operator = (const ArrayStack<T>& rhs);
+    ArrayStack<T>& operator = (ArrayStack<T>&& rhs);      //Swaps contents with rhs
     bool operator == (const ArrayStack<T>& rhs) const;
     bool operator != (const ArrayStack<T>& rhs) const;
 
@@ -74,13 +84,13 @@ template<class T> class ArrayStack {
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        int            current;
+        size_type      current;
         ArrayStack<T>* ref_stack;
-        int            expected_mod_count;
+        size_type      expected_mod_count;
         bool           can_erase = true;
 
         //Called in friends begin/end
-        Iterator(ArrayStack<T>* iterate_over, int initial);
+        Iterator(ArrayStack<T>* iterate_over, size_type initial);
     };
 
 
@@ -90,14 +100,14 @@ template<class T> class ArrayStack {
 
     private:
       T*  stack;         //Bottom of stack is at index 0, grows to bigger indexes
-      int length    = 0; //Physical length of array: must be >= .size()
-      int used      = 0; //Amount of array used: invariant: 0 <= used <= length
-      int mod_count = 0; //For sensing attempts to concurrently modify stack during iteration
+      size_type length    = 0; //Physical length of array: must be >= .size()
+      size_type used      = 0; //Amount of array used: invariant: 0 <= used <= length
+      size_type mod_count = 0; //For sensing attempts to concurrently modify stack during iteration
 
       //Helper methods
-      int erase_at          (int i);
-      void ensure_length    (int new_length);
-      void ensure_length_low(int new_length);
+      int                   erase_at          (size_type i);
+      void                  ensure_length    (size_type new_length);
+      void ensure_length_low(size_type new_length);
   };
 
 
@@ -134,11 +144,21 @@ template<class T>
 ArrayStack<T>::ArrayStack(const ArrayStack<T>& to_copy)
 : length(to_copy.length), used(to_copy.used) {
   stack = new T[length];
-  for (int i=0; i<to_copy.used; ++i)
+  for (size_type i=0; i<to_copy.used; ++i)
     stack[i] = to_copy.stack[i];
 }
 
 
+template<class T>
+ArrayStack<T>::ArrayStack(ArrayStack<T>&& to_move) {
+  stack = new T[length];
+  std::swap(stack, to_move.stack);
+  std::swap(length,to_move.length);
+  std::swap(used,  to_move.used);
+  ++to_move.mod_count;
+}
+
+
 template<class T>
 ArrayStack<T>::ArrayStack(const std::initializer_list<T>& il)
 : length(il.size()) {
@@ -169,7 +189,7 @@ bool ArrayStack<T>::empty() const {
 
 
 template<class T>
-int ArrayStack<T>::size() const {
+size_type ArrayStack<T>::size() const {
   return used;
 }
 
@@ -190,7 +210,7 @@ std::string ArrayStack<T>::str() const {
 
   if (length != 0) {
     answer << "0:" << stack[0];
-    for (int i=1; i<length; ++i)
+    for (size_type i=1; i<length; ++i)
       answer << "," << i << ":" << stack[i];
   }
 
@@ -212,13 +232,29 @@ int ArrayStack<T>::push(const T& element) {
 }
 
 
+template<class T>
+int ArrayStack<T>::push(T&& element) {
+  this->ensure_length(used+1);
+  stack[used++] = std::move(element);
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T>
+template<class... Args>
+int ArrayStack<T>::emplace(Args&&... args) {
+  return push(T(std::forward<Args>(args)...));
+}
+
+
 template<class T>
 T ArrayStack<T>::pop() {
   if (this->empty())
     throw EmptyError("ArrayStack::pop");
 
   ++mod_count;
-  T to_return = stack[--used];
+  T to_return = std::move(stack[--used]);
   this->ensure_length_low(used);
   return to_return;
 }
@@ -232,10 +268,18 @@ void ArrayStack<T>::clear() {
 }
 
 
+template<class T>
+void ArrayStack<T>::reserve(size_type n) {
+  this->ensure_length(n);
+  ++mod_count;
+}
+
+
 template<class T>
 template<class Iterable>
-int ArrayStack<T>::push_all(const Iterable& i) {
-  int count = 0;
+size_type ArrayStack<T>::push_all(const Iterable& i) {
+  this->ensure_length(used+size_hint(i));
+  size_type count = 0;
   for (const T& v : i)
      count += push(v);
 
@@ -254,7 +298,7 @@ ArrayStack<T>& ArrayStack<T>::operator = (const ArrayStack<T>& rhs) {
 
   this->ensure_length(rhs.used);
   used = rhs.used;
-  for (int i=0; i<used; ++i)
+  for (size_type i=0; i<used; ++i)
     stack[i] = rhs.stack[i];
 
   ++mod_count;
@@ -262,6 +306,20 @@ ArrayStack<T>& ArrayStack<T>::operator = (const ArrayStack<T>& rhs) {
 }
 
 
+template<class T>
+ArrayStack<T>& ArrayStack<T>::operator = (ArrayStack<T>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(stack, rhs.stack);
+  std::swap(length,rhs.length);
+  std::swap(used,  rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
 template<class T>
 bool ArrayStack<T>::operator == (const ArrayStack<T>& rhs) const {
   if (this == &rhs)
@@ -272,7 +330,7 @@ bool ArrayStack<T>::operator == (const ArrayStack<T>& rhs) const {
 
   ArrayStack<T>::Iterator rhs_i = rhs.begin();
   // Uses ! and ==, so != on T need not be defined
-  for (int i=used-1; i>=0; --i,++rhs_i)
+  for (size_type i=used-1; i>=0; --i,++rhs_i)
     if (!(stack[i] == *rhs_i))
       return false;
 
@@ -292,7 +350,7 @@ std::ostream& operator << (std::ostream& outs, const ArrayStack<T>& s) {
 
   if (!s.empty()) {
     outs << s.stack[0];
-    for (int i=1; i<s.used; ++i)
+    for (size_type i=1; i<s.used; ++i)
       outs << "," << s.stack[i];
   }
 
@@ -322,9 +380,9 @@ auto ArrayStack<T>::end () const -> ArrayStack<T>::Iterator {
 //Private helper methods
 
 template<class T>
-int ArrayStack<T>::erase_at(int i) {
-  for (int j=i; j<used-1; ++j)
-    stack[j] = stack[j+1];
+int ArrayStack<T>::erase_at(size_type i) {
+  for (size_type j=i; j<used-1; ++j)
+    stack[j] = std::move(stack[j+1]);
   --used;
   this->ensure_length_low(used);
   ++mod_count;
@@ -333,28 +391,28 @@ int ArrayStack<T>::erase_at(int i) {
 
 
 template<class T>
-void ArrayStack<T>::ensure_length(int new_length) {
+void ArrayStack<T>::ensure_length(size_type new_length) {
   if (length >= new_length)
     return;
   T* old_stack = stack;
   length = std::max(new_length,2*length);
   stack = new T[length];
-  for (int i=0; i<used; ++i)
-    stack[i] = old_stack[i];
+  for (size_type i=0; i<used; ++i)
+    stack[i] = std::move(old_stack[i]);
 
   delete [] old_stack;
 }
 
 
 template<class T>
-void ArrayStack<T>::ensure_length_low(int new_length) {
+void ArrayStack<T>::ensure_length_low(size_type new_length) {
   if (length < 4*new_length)
     return;
   T* old_stack = stack;
   length =2*new_length;
   stack = new T[length];
-  for (int i=0; i<used; ++i)
-    stack[i] = old_stack[i];
+  for (size_type i=0; i<used; ++i)
+    stack[i] = std::move(old_stack[i]);
 
   delete [] old_stack;
 }
@@ -368,7 +426,7 @@ void ArrayStack<T>::ensure_length_low(int new_length) {
 //Iterator class definitions
 
 template<class T>
-ArrayStack<T>::Iterator::Iterator(ArrayStack<T>* iterate_over, int initial)
+ArrayStack<T>::Iterator::Iterator(ArrayStack<T>* iterate_over, size_type initial)
 : current(initial), ref_stack(iterate_over), expected_mod_count(ref_stack->mod_count) {
 }
 
@@ -0,0 +1,198 @@
+#ifndef BLOOM_FILTER_HPP_
+#define BLOOM_FILTER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "ics_hash.hpp"
+
+
+namespace ics {
+
+namespace bloom_detail {
+
+//The same 8 odd multipliers as Parquet's split-block filter: one picks the bit in each word
+const std::uint32_t salt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                               0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+}
+
+
+//A blocked Bloom filter over the int hash codes that the hash containers cache
+//  in their nodes: the containers use it (when turned on) to answer most
+//  lookups of absent keys without computing a bin or walking its list.
+//Each code sets 8 bits, one in each 64-bit word of one 64-byte (cache line)
+//  block, so a lookup reads just one cache line: a false answer from
+//  may_contain means the code was never inserted; a true answer may be wrong
+//  (a false positive) about 0.5% of the time when sized at bits_per_key.
+//Bits cannot be removed: a container counts erases with note_erase and
+//  rebuilds (reset, then reinserts every code) when the filter is stale or full.
+//
+//Statistics (cumulative across resets, until clear_stats) are counted without
+//  atomic read-modify-writes, so they may undercount when many threads query
+//  one filter at once (the bits themselves are only read by may_contain).
+//  Counting lookups writes on every may_contain call, so (like the containers'
+//  probe counts: see hash_stats.hpp) it is opt-in, with -DICS_HASH_PROBE_STATS.
+class BloomFilter {
+  public:
+    explicit BloomFilter (int expected_keys = 0);
+
+    //Queries
+    bool may_contain (int hash_code) const;   //false: definitely never inserted
+    int  capacity    () const;                //Keys it is sized for (at bits_per_key)
+    bool full        () const;                //More keys inserted than it is sized for
+    bool stale       () const;                //More than half the keys inserted since reset were erased
+
+    //Commands
+    void insert      (int hash_code);
+    void note_erase  (int count = 1);         //count keys inserted since reset were erased
+    void reset       (int expected_keys);     //Clear all bits; size for expected_keys
+
+    //Statistics
+    void      note_false_positive () const;   //Caller found absent a key that may_contain did not reject
+    long long lookups             () const;   //Calls to may_contain (0 unless compiled with -DICS_HASH_PROBE_STATS)
+    long long rejections          () const;   //... that returned false
+    long long false_positives     () const;   //... that returned true for an absent key
+    double    false_positive_rate () const;   //false_positives/(false_positives+rejections): absent keys not rejected
+    void      clear_stats         ();
+
+    static const int bits_per_key = 16;
+
+  private:
+    static const int block_words = 8;         //8 64-bit words: one 64-byte cache line
+
+    std::vector<std::uint64_t> words;         //blocks*block_words words, plus slack to align the first block
+    int blocks   = 1;
+    int inserted = 0;                         //Since reset
+    int erased   = 0;                         //Since reset
+
+    mutable std::atomic<long long> lookup_count     {0};
+    mutable std::atomic<long long> rejection_count  {0};
+    mutable std::atomic<long long> false_pos_count  {0};
+
+    const std::uint64_t* block_of (std::uint64_t h) const;   //The 64-byte-aligned block that h selects
+    static std::uint64_t mix      (int hash_code);           //Spread hash_code's 32 bits over 64
+    static void bump (std::atomic<long long>& count);        //++count, not atomically (see above)
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//BloomFilter definitions
+
+inline BloomFilter::BloomFilter (int expected_keys) {
+  reset(expected_keys);
+}
+
+
+inline bool BloomFilter::may_contain (int hash_code) const {
+#ifdef ICS_HASH_PROBE_STATS
+  bump(lookup_count);
+#endif /* ICS_HASH_PROBE_STATS */
+  std::uint64_t h = mix(hash_code);
+  const std::uint64_t* block = block_of(h);
+  std::uint32_t key = std::uint32_t(h);
+  for (int w=0; w<block_words; ++w)
+    if ((block[w] & (std::uint64_t(1) << ((key*bloom_detail::salt[w]) >> 26))) == 0) {
+      bump(rejection_count);
+      return false;
+    }
+  return true;
+}
+
+
+inline int BloomFilter::capacity () const {
+  return blocks*block_words*64/bits_per_key;
+}
+
+
+inline bool BloomFilter::full () const {
+  return inserted > capacity();
+}
+
+
+inline bool BloomFilter::stale () const {
+  return erased > inserted/2;
+}
+
+
+inline void BloomFilter::insert (int hash_code) {
+  std::uint64_t h = mix(hash_code);
+  std::uint64_t* block = const_cast<std::uint64_t*>(block_of(h));
+  std::uint32_t key = std::uint32_t(h);
+  for (int w=0; w<block_words; ++w)
+    block[w] |= std::uint64_t(1) << ((key*bloom_detail::salt[w]) >> 26);
+  ++inserted;
+}
+
+
+inline void BloomFilter::note_erase (int count) {
+  erased += count;
+}
+
+
+inline void BloomFilter::reset (int expected_keys) {
+  blocks = std::max(1,int((std::int64_t(std::max(expected_keys,1))*bits_per_key + 511)/512));
+  words.assign(std::size_t(blocks)*block_words + block_words-1, 0);
+  inserted = 0;
+  erased   = 0;
+}
+
+
+inline void BloomFilter::note_false_positive () const {
+  bump(false_pos_count);
+}
+
+
+inline long long BloomFilter::lookups () const {
+  return lookup_count.load(std::memory_order_relaxed);
+}
+
+
+inline long long BloomFilter::rejections () const {
+  return rejection_count.load(std::memory_order_relaxed);
+}
+
+
+inline long long BloomFilter::false_positives () const {
+  return false_pos_count.load(std::memory_order_relaxed);
+}
+
+
+inline double BloomFilter::false_positive_rate () const {
+  long long absent = false_positives() + rejections();
+  return absent == 0 ? 0.0 : double(false_positives())/double(absent);
+}
+
+
+inline void BloomFilter::clear_stats () {
+  lookup_count    = 0;
+  rejection_count = 0;
+  false_pos_count = 0;
+}
+
+
+//The high 32 bits of h pick the block (multiply-shift: no divide); the low 32
+//  bits pick the bits within it
+inline const std::uint64_t* BloomFilter::block_of (std::uint64_t h) const {
+  std::uintptr_t first = (reinterpret_cast<std::uintptr_t>(words.data()) + 63) & ~std::uintptr_t(63);
+  std::uint64_t  b     = ((h >> 32)*std::uint64_t(blocks)) >> 32;
+  return reinterpret_cast<const std::uint64_t*>(first) + b*block_words;
+}
+
+
+inline std::uint64_t BloomFilter::mix (int hash_code) {
+  return hash_mix(std::uint32_t(hash_code));
+}
+
+
+inline void BloomFilter::bump (std::atomic<long long>& count) {
+  count.store(count.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+}
+
+}
+
+#endif /* BLOOM_FILTER_HPP_ */
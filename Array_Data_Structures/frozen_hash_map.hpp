@@ -0,0 +1,615 @@
+#ifndef FROZEN_HASH_MAP_HPP_
+#define FROZEN_HASH_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+#include "ics_exceptions.hpp"
+#include "ics_hash.hpp"
+#include "pair.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+template<class KEY,class T, int (*thash)(const KEY& a)> class HashMap;
+
+
+//An immutable map, usually made by HashMap::freeze() from a map that is built
+//  once and then only read. Its keys and values are in two flat arrays (no
+//  nodes, no bins, no trailers), placed by a minimal perfect hash of their
+//  hash codes: a lookup reads one displacement, computes the key's slot from
+//  it, and compares the one key stored there (no collision chains).
+//The perfect hash is CHD-style (hash, displace, and compress): keys are
+//  grouped into buckets of about keys_per_bucket keys; the largest buckets are
+//  placed first, each trying displacements until all its keys land in free
+//  slots; a bucket with one key just records the free slot it takes.
+//Keys whose hash code equals an earlier key's (distinct keys can share a
+//  32-bit code) cannot be told apart by the perfect hash, so they are stored
+//  after the placed keys, sorted by hash code, and searched only when a key's
+//  own slot does not match.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> class FrozenHashMap {
+  public:
+    typedef ics::pair<KEY,T> Entry;
+    typedef int (*hashfunc) (const KEY& a);
+
+    //Destructor/Constructors
+    ~FrozenHashMap ();
+
+    FrozenHashMap          (int (*chash)(const KEY& a) = undefinedhash<KEY>);   //Empty
+    FrozenHashMap          (const FrozenHashMap<KEY,T,thash>& to_copy);
+    FrozenHashMap          (FrozenHashMap<KEY,T,thash>&& to_move);              //to_move is left empty
+    explicit FrozenHashMap (const std::initializer_list<Entry>& il, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    //If a key appears more than once, its last value is kept (as if each entry were put)
+    template <class Iterable>
+    explicit FrozenHashMap (const Iterable& i, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Heterogeneous lookup: key is a LOOKUP (e.g., StringView for std::string keys), so no KEY
+    //  is built; LOOKUP == KEY must be defined and lookup_hash(key) must equal hash(KEY(key))
+    template <class LOOKUP>
+    bool     has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;
+    template <class LOOKUP>
+    const T& get     (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;  //KeyError if absent, like []
+
+
+    //Operators
+
+    const T& operator [] (const KEY&) const;   //KeyError if absent
+    FrozenHashMap<KEY,T,thash>& operator = (const FrozenHashMap<KEY,T,thash>& rhs);
+    FrozenHashMap<KEY,T,thash>& operator = (FrozenHashMap<KEY,T,thash>&& rhs);   //Swaps contents (and hash) with rhs
+    bool operator == (const FrozenHashMap<KEY,T,thash>& rhs) const;
+    bool operator != (const FrozenHashMap<KEY,T,thash>& rhs) const;
+
+    template<class KEY2,class T2, int (*hash2)(const KEY2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const FrozenHashMap<KEY2,T2,hash2>& m);
+
+
+    //Keys and values are stored apart, so an Iterator produces each Entry by value
+    //  (a copy); there is no erase (or ->), as a FrozenHashMap never changes
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of FrozenHashMap<KEY,T,thash>
+        std::string str  () const;
+        FrozenHashMap<KEY,T,thash>::Iterator& operator ++ ();
+        FrozenHashMap<KEY,T,thash>::Iterator  operator ++ (int);
+        bool operator == (const FrozenHashMap<KEY,T,thash>::Iterator& rhs) const;
+        bool operator != (const FrozenHashMap<KEY,T,thash>::Iterator& rhs) const;
+        Entry operator * () const;
+        friend std::ostream& operator << (std::ostream& outs, const FrozenHashMap<KEY,T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator FrozenHashMap<KEY,T,thash>::begin () const;
+        friend Iterator FrozenHashMap<KEY,T,thash>::end   () const;
+
+      private:
+        int                               current;  //Index into keys/values
+        const FrozenHashMap<KEY,T,thash>* ref_map;
+
+        //Called in friends begin/end
+        Iterator(const FrozenHashMap<KEY,T,thash>* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    static const int keys_per_bucket = 3;     //Average; each bucket has one displacement
+
+
+  private:
+    template<class KEY2,class T2, int (*hash2)(const KEY2& a)> friend class HashMap;
+
+    int (*hash)(const KEY& k);                //Hashing function used (from template or constructor)
+    std::vector<KEY>           keys;          //keys[0..placed-1] by perfect hash; then keys sharing a hash code, sorted by it
+    std::vector<T>             values;        //values[i] is keys[i]'s value
+    std::vector<int>           shared_codes;  //shared_codes[i] is hash(keys[placed+i])
+    std::vector<std::uint32_t> displacement;  //One per bucket: a displacement, or direct_slot|slot
+    int           placed = 0;                 //# keys placed by the perfect hash (all distinct hash codes)
+    std::uint64_t seed   = 0;                 //Varies the bucket/slot hashes; changed if building fails
+
+    static const std::uint32_t direct_slot      = 0x80000000u;  //Flags a displacement that is the slot itself
+    static const std::uint32_t max_displacement = 1u << 20;     //Tries per bucket before choosing a new seed
+
+    //Used by HashMap::freeze: codes[i] is hash(entries[i].first), and the keys are distinct
+    FrozenHashMap (std::vector<Entry>&& entries, std::vector<int>&& codes, int (*the_hash)(const KEY& a));
+
+    //Helper methods
+    int  bucket_of (int hash_code) const;                        //In [0,displacement.size())
+    int  slot_of   (int hash_code, std::uint32_t d) const;       //In [0,placed)
+    template <class LOOKUP>
+    int  find_key  (const LOOKUP& key, int hash_code) const;     //Index of key in keys, or -1
+    void build     (std::vector<Entry>& entries, std::vector<int>& codes, bool distinct);
+    bool place     (const std::vector<int>& codes, const std::vector<int>& order, int distinct_codes, std::vector<int>& slot);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//FrozenHashMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::~FrozenHashMap() {
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::FrozenHashMap(int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("FrozenHashMap::default constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("FrozenHashMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::FrozenHashMap(const FrozenHashMap<KEY,T,thash>& to_copy)
+: hash(to_copy.hash), keys(to_copy.keys), values(to_copy.values), shared_codes(to_copy.shared_codes),
+  displacement(to_copy.displacement), placed(to_copy.placed), seed(to_copy.seed) {
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::FrozenHashMap(FrozenHashMap<KEY,T,thash>&& to_move)
+: hash(to_move.hash) {
+  std::swap(keys,        to_move.keys);
+  std::swap(values,      to_move.values);
+  std::swap(shared_codes,to_move.shared_codes);
+  std::swap(displacement,to_move.displacement);
+  std::swap(placed,      to_move.placed);
+  std::swap(seed,        to_move.seed);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::FrozenHashMap(const std::initializer_list<Entry>& il, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("FrozenHashMap::initializer_list constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("FrozenHashMap::initializer_list constructor: both specified and different");
+
+  std::vector<Entry> entries(il.begin(),il.end());
+  std::vector<int>   codes;
+  codes.reserve(entries.size());
+  for (const Entry& e : entries)
+    codes.push_back(hash(e.first));
+  build(entries,codes,false);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class Iterable>
+FrozenHashMap<KEY,T,thash>::FrozenHashMap(const Iterable& i, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("FrozenHashMap::Iterable constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("FrozenHashMap::Iterable constructor: both specified and different");
+
+  std::vector<Entry> entries;
+  std::vector<int>   codes;
+  for (const Entry& e : i) {
+    entries.push_back(e);
+    codes.push_back(hash(e.first));
+  }
+  build(entries,codes,false);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::FrozenHashMap(std::vector<Entry>&& entries, std::vector<int>&& codes, int (*the_hash)(const KEY& k))
+: hash(the_hash) {
+  build(entries,codes,true);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::empty() const {
+  return keys.empty();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+int FrozenHashMap<KEY,T,thash>::size() const {
+  return int(keys.size());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::has_key (const KEY& key) const {
+  return find_key(key,hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::has_value (const T& value) const {
+  for (const T& v : values)
+    if (v == value)
+      return true;
+  return false;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string FrozenHashMap<KEY,T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "FrozenHashMap[";
+  if (!keys.empty()) {
+    answer << std::endl;
+    for (int i=0; i<size(); ++i)
+      answer << "  " << (i < placed ? "slot[" : "shared[") << (i < placed ? i : i-placed) << "] = "
+             << keys[i] << "->" << values[i] << std::endl;
+  }
+  answer << "](placed=" << placed << ",shared=" << shared_codes.size() << ",buckets=" << displacement.size()
+         << ",seed=" << seed << ")";
+  return answer.str();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+bool FrozenHashMap<KEY,T,thash>::has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  return find_key(key,lookup_hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+const T& FrozenHashMap<KEY,T,thash>::get (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  int i = find_key(key,lookup_hash(key));
+  if (i == -1) {
+    std::ostringstream answer;
+    answer << "FrozenHashMap::get: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  return values[i];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const T& FrozenHashMap<KEY,T,thash>::operator [] (const KEY& key) const {
+  int i = find_key(key,hash(key));
+  if (i == -1) {
+    std::ostringstream answer;
+    answer << "FrozenHashMap::operator []: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  return values[i];
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>& FrozenHashMap<KEY,T,thash>::operator = (const FrozenHashMap<KEY,T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+  hash         = rhs.hash;
+  keys         = rhs.keys;
+  values       = rhs.values;
+  shared_codes = rhs.shared_codes;
+  displacement = rhs.displacement;
+  placed       = rhs.placed;
+  seed         = rhs.seed;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>& FrozenHashMap<KEY,T,thash>::operator = (FrozenHashMap<KEY,T,thash>&& rhs) {
+  std::swap(hash,        rhs.hash);
+  std::swap(keys,        rhs.keys);
+  std::swap(values,      rhs.values);
+  std::swap(shared_codes,rhs.shared_codes);
+  std::swap(displacement,rhs.displacement);
+  std::swap(placed,      rhs.placed);
+  std::swap(seed,        rhs.seed);
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::operator == (const FrozenHashMap<KEY,T,thash>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (size() != rhs.size())
+    return false;
+  for (int i=0; i<size(); ++i) {
+    int j = rhs.find_key(keys[i],rhs.hash(keys[i]));
+    if (j == -1 || !(values[i] == rhs.values[j]))
+      return false;
+  }
+  return true;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::operator != (const FrozenHashMap<KEY,T,thash>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::ostream& operator << (std::ostream& outs, const FrozenHashMap<KEY,T,thash>& m) {
+  outs << "map[";
+  for (int i=0; i<m.size(); ++i)
+    outs << (i == 0 ? "" : ",") << m.keys[i] << "->" << m.values[i];
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto FrozenHashMap<KEY,T,thash>::begin () const -> FrozenHashMap<KEY,T,thash>::Iterator {
+  return Iterator(this,0);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto FrozenHashMap<KEY,T,thash>::end () const -> FrozenHashMap<KEY,T,thash>::Iterator {
+  return Iterator(this,size());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Multiply-shift ranges a 32-bit hash into [0,n) without dividing
+template<class KEY,class T, int (*thash)(const KEY& a)>
+int FrozenHashMap<KEY,T,thash>::bucket_of (int hash_code) const {
+  std::uint64_t h = hash_mix(std::uint32_t(hash_code) ^ seed);
+  return int(((h >> 32)*std::uint64_t(displacement.size())) >> 32);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+int FrozenHashMap<KEY,T,thash>::slot_of (int hash_code, std::uint32_t d) const {
+  if (d & direct_slot)
+    return int(d & ~direct_slot);
+  std::uint64_t h = hash_mix(((std::uint64_t(d) << 32) | std::uint32_t(hash_code)) + seed);
+  return int(((h & 0xffffffffu)*std::uint64_t(placed)) >> 32);
+}
+
+
+//One probe: compare the key in hash_code's slot; only if that fails (and some
+//  keys share hash codes) binary search the shared codes
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+int FrozenHashMap<KEY,T,thash>::find_key (const LOOKUP& key, int hash_code) const {
+  if (placed == 0)
+    return -1;
+  int s = slot_of(hash_code,displacement[bucket_of(hash_code)]);
+  if (key == keys[s])
+    return s;
+  for (auto i = std::lower_bound(shared_codes.begin(),shared_codes.end(),hash_code); i != shared_codes.end() && *i == hash_code; ++i)
+    if (key == keys[placed + (i-shared_codes.begin())])
+      return placed + int(i-shared_codes.begin());
+  return -1;
+}
+
+
+//Sort the entries by hash code: the first key with each code is placed by the
+//  perfect hash; later keys with the same code are shared (or, unless distinct,
+//  replace an equal key before them). Then move each entry to its slot.
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void FrozenHashMap<KEY,T,thash>::build (std::vector<Entry>& entries, std::vector<int>& codes, bool distinct) {
+  int n = int(entries.size());
+  std::vector<int> order(n);
+  for (int i=0; i<n; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(),order.end(),[&codes](int a, int b){return codes[a] < codes[b];});
+
+  std::vector<int> first, shared;     //Indexes into entries: one per code (in code order); the rest (also)
+  for (int i=0; i<n; ) {
+    int run_end = i+1;
+    while (run_end < n && codes[order[run_end]] == codes[order[i]])
+      ++run_end;
+    std::vector<int> run;             //Distinct keys with this code, each index its last occurrence
+    for (int r=i; r<run_end; ++r) {
+      bool replaced = false;
+      if (!distinct)
+        for (int& k : run)
+          if (entries[k].first == entries[order[r]].first) {
+            k = order[r];
+            replaced = true;
+            break;
+          }
+      if (!replaced)
+        run.push_back(order[r]);
+    }
+    first.push_back(run[0]);
+    shared.insert(shared.end(),run.begin()+1,run.end());
+    i = run_end;
+  }
+
+  placed = int(first.size());
+  std::vector<int> slot;              //slot[j] is the slot of entries[first[j]]
+  for (seed = 0; !place(codes,first,placed,slot); ++seed)
+    ;
+
+  std::vector<int> at(placed);        //at[s] is the index in entries placed in slot s
+  for (int j=0; j<placed; ++j)
+    at[slot[j]] = first[j];
+  keys.reserve(placed+shared.size());
+  values.reserve(placed+shared.size());
+  for (int s=0; s<placed; ++s) {
+    keys.push_back(std::move(entries[at[s]].first));
+    values.push_back(std::move(entries[at[s]].second));
+  }
+  for (int i : shared) {              //Already in hash code order
+    keys.push_back(std::move(entries[i].first));
+    values.push_back(std::move(entries[i].second));
+    shared_codes.push_back(codes[i]);
+  }
+}
+
+
+//Try to place the distinct_codes codes[order[j]] with the current seed: returns
+//  false if some bucket needs more than max_displacement tries
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::place (const std::vector<int>& codes, const std::vector<int>& order, int distinct_codes, std::vector<int>& slot) {
+  int buckets = std::max(1,(distinct_codes+keys_per_bucket-1)/keys_per_bucket);
+  displacement.assign(buckets,0);
+
+  //Group the codes by bucket (counting sort), then order the buckets largest first
+  std::vector<int> bucket(distinct_codes), start(buckets+1,0);
+  for (int j=0; j<distinct_codes; ++j)
+    ++start[(bucket[j] = bucket_of(codes[order[j]]))+1];
+  for (int b=0; b<buckets; ++b)
+    start[b+1] += start[b];
+  std::vector<int> members(distinct_codes), fill(start.begin(),start.end()-1);
+  for (int j=0; j<distinct_codes; ++j)
+    members[fill[bucket[j]]++] = j;
+  std::vector<int> by_size(buckets);
+  for (int b=0; b<buckets; ++b)
+    by_size[b] = b;
+  std::stable_sort(by_size.begin(),by_size.end(),[&start](int a, int b){return start[a+1]-start[a] > start[b+1]-start[b];});
+
+  slot.assign(distinct_codes,-1);
+  std::vector<bool> taken(distinct_codes,false);
+  std::vector<int>  tried;
+  int next_free = 0;                  //No free slot below this (for buckets with one key)
+  for (int b : by_size) {
+    int size = start[b+1]-start[b];
+    if (size == 0)
+      break;
+    if (size == 1) {
+      while (taken[next_free])
+        ++next_free;
+      taken[next_free] = true;
+      slot[members[start[b]]] = next_free;
+      displacement[b] = direct_slot | std::uint32_t(next_free);
+      continue;
+    }
+    for (std::uint32_t d=0; ; ++d) {
+      if (d == max_displacement)
+        return false;
+      tried.clear();
+      for (int m=start[b]; m<start[b+1]; ++m) {
+        int s = slot_of(codes[order[members[m]]],d);
+        if (taken[s])
+          break;
+        taken[s] = true;              //Also catches two of this bucket's keys in one slot
+        tried.push_back(s);
+      }
+      if (int(tried.size()) == size) {
+        displacement[b] = d;
+        for (int m=start[b]; m<start[b+1]; ++m)
+          slot[members[m]] = tried[m-start[b]];
+        break;
+      }
+      for (int s : tried)
+        taken[s] = false;
+    }
+  }
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash>::Iterator::Iterator(const FrozenHashMap<KEY,T,thash>* iterate_over, int initial)
+: current(initial), ref_map(iterate_over) {
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string FrozenHashMap<KEY,T,thash>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_map->str() << "(current=" << current << ")";
+  return answer.str();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto FrozenHashMap<KEY,T,thash>::Iterator::operator ++ () -> FrozenHashMap<KEY,T,thash>::Iterator& {
+  if (current < ref_map->size())
+    ++current;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto FrozenHashMap<KEY,T,thash>::Iterator::operator ++ (int) -> FrozenHashMap<KEY,T,thash>::Iterator {
+  Iterator to_return(*this);
+  if (current < ref_map->size())
+    ++current;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::Iterator::operator == (const FrozenHashMap<KEY,T,thash>::Iterator& rhs) const {
+  if (ref_map != rhs.ref_map)
+    throw ComparingDifferentIteratorsError("FrozenHashMap::Iterator ==");
+  return current == rhs.current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool FrozenHashMap<KEY,T,thash>::Iterator::operator != (const FrozenHashMap<KEY,T,thash>::Iterator& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto FrozenHashMap<KEY,T,thash>::Iterator::operator * () const -> Entry {
+  if (current < 0 || current >= ref_map->size()) {
+    std::ostringstream where;
+    where << current << " when size = " << ref_map->size();
+    throw IteratorPositionIllegal("FrozenHashMap::Iterator::operator * Iterator illegal: "+where.str());
+  }
+  return Entry(ref_map->keys[current],ref_map->values[current]);
+}
+
+}
+
+#endif /* FROZEN_HASH_MAP_HPP_ */
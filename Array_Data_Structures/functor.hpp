@@ -0,0 +1,24 @@
+#ifndef FUNCTOR_HPP_
+#define FUNCTOR_HPP_
+
+
+namespace ics {
+
+//The containers take their hash/comparison functions as function-pointer
+//  template arguments (e.g., HashMap<std::string,int,hash_str>); when one is
+//  supplied there, the containers call it directly, so the compiler can inline
+//  it. functor_hash/functor_compare turn a stateless functor type into such a
+//  function, so functors get the same treatment:
+//    HashMap<std::string,int,functor_hash<std::string,std::hash<std::string>>>
+//    HeapPriorityQueue<int,functor_compare<int,std::less<int>>>
+//The functor type must be default constructible: Hasher()(a) / Compare()(a,b)
+//  is called for each use.
+template<class KEY, class Hasher>
+int functor_hash (const KEY& a) {return int(Hasher()(a));}
+
+template<class T, class Compare>
+bool functor_compare (const T& a, const T& b) {return Compare()(a,b);}
+
+}
+
+#endif /* FUNCTOR_HPP_ */
@@ -0,0 +1,122 @@
+#ifndef HASH_STATS_HPP_
+#define HASH_STATS_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+
+
+namespace ics {
+
+//A summary of a chained hash table's health, from HashMap/HashSet::stats(),
+//  for tables too big to inspect with str(). With a hash function that
+//  spreads its values well, chain lengths follow a Poisson distribution:
+//  longest_chain stays small (under 10 for millions of values at load 1), and
+//  a search probes about 1+load_factor/2 values when it finds what it looks
+//  for (a hit) and load_factor values when it does not (a miss). A poor hash
+//  function (e.g., one ignoring part of each value) shows up as a long
+//  longest_chain, many empty_bins, and probe averages far above these.
+//
+//Probes are the values a search compares (a BloomFilter rejection probes
+//  none). Counting them is opt-in: compile with -DICS_HASH_PROBE_STATS to count
+//  them in every search (has_key/contains/[]/put/insert/erase...). Otherwise
+//  probes_counted is false and the probe counts are 0: counting writes shared
+//  counters on each search, so concurrent readers of one table would contend
+//  for their cache line (and updates could be lost).
+struct HashStats {
+  long long bins           = 0;      //Including an old table being moved into a new one
+  long long used           = 0;
+  double    load_factor    = 0.0;    //used/bins
+  long long empty_bins     = 0;
+  int       longest_chain  = 0;
+  std::vector<long long> chain_lengths;  //chain_lengths[k] is the # of bins with k values (0 <= k <= longest_chain)
+  long long rehashes       = 0;      //# times the values were moved to a table with a different # of bins
+
+  bool      probes_counted = false;
+  long long hits           = 0;      //Searches that found their value...
+  long long hit_probes     = 0;      //...and the values they compared
+  long long misses         = 0;      //Searches that did not...
+  long long miss_probes    = 0;      //...and the values they compared
+
+  double average_probes_hit  () const {return hits   == 0 ? 0.0 : double(hit_probes)/double(hits);}
+  double average_probes_miss () const {return misses == 0 ? 0.0 : double(miss_probes)/double(misses);}
+
+  std::string str () const {
+    std::ostringstream answer;
+    answer << "HashStats(bins=" << bins << ",used=" << used << ",load_factor=" << load_factor
+           << ",empty_bins=" << empty_bins << ",longest_chain=" << longest_chain << ",chain_lengths=[";
+    for (int k=0; k<int(chain_lengths.size()); ++k)
+      answer << (k == 0 ? "" : ",") << k << ":" << chain_lengths[k];
+    answer << "],rehashes=" << rehashes;
+    if (probes_counted)
+      answer << ",hits=" << hits << ",average_probes_hit=" << average_probes_hit()
+             << ",misses=" << misses << ",average_probes_miss=" << average_probes_miss();
+    answer << ")";
+    return answer.str();
+  }
+
+  //Add one bin holding length values
+  void add_chain (int length) {
+    if (length >= int(chain_lengths.size()))
+      chain_lengths.resize(length+1,0);
+    ++chain_lengths[length];
+    if (length == 0)
+      ++empty_bins;
+    if (length > longest_chain)
+      longest_chain = length;
+  }
+};
+
+
+inline std::ostream& operator << (std::ostream& outs, const HashStats& s) {
+  outs << s.str();
+  return outs;
+}
+
+
+//Counts the searches of one hash table and the values they probe, for HashStats.
+//Searches are const, so the counts are mutable; like BloomFilter's statistics,
+//  they are bumped without atomic read-modify-writes, so they may undercount
+//  when many threads search one table at once. A copied table starts at 0.
+class ProbeCounter {
+  public:
+    ProbeCounter () {}
+    ProbeCounter (const ProbeCounter&) {}
+    ProbeCounter& operator = (const ProbeCounter&) {return *this;}
+
+#ifdef ICS_HASH_PROBE_STATS
+    void hit  (int probes) const {bump(hits,1);   bump(hit_probes,probes);}
+    void miss (int probes) const {bump(misses,1); bump(miss_probes,probes);}
+
+    void fill (HashStats& s) const {
+      s.probes_counted = true;
+      s.hits        = hits.load(std::memory_order_relaxed);
+      s.hit_probes  = hit_probes.load(std::memory_order_relaxed);
+      s.misses      = misses.load(std::memory_order_relaxed);
+      s.miss_probes = miss_probes.load(std::memory_order_relaxed);
+    }
+
+    void clear () {hits = 0; hit_probes = 0; misses = 0; miss_probes = 0;}
+
+  private:
+    mutable std::atomic<long long> hits        {0};
+    mutable std::atomic<long long> hit_probes  {0};
+    mutable std::atomic<long long> misses      {0};
+    mutable std::atomic<long long> miss_probes {0};
+
+    static void bump (std::atomic<long long>& count, int by) {
+      count.store(count.load(std::memory_order_relaxed)+by, std::memory_order_relaxed);
+    }
+#else
+    void hit  (int) const {}
+    void miss (int) const {}
+    void fill (HashStats&) const {}
+    void clear () {}
+#endif /* ICS_HASH_PROBE_STATS */
+};
+
+}
+
+#endif /* HASH_STATS_HPP_ */
@@ -0,0 +1,188 @@
+#ifndef ICS_HASH_HPP_
+#define ICS_HASH_HPP_
+
+#include <string>
+#include <tuple>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include "pair.hpp"
+
+
+namespace ics {
+
+//Well-mixed 64-bit hashes, to use instead of wrapping std::hash (which is
+//  the identity function for integers in many libraries).
+//hash64(a) is overloaded for integers, pointers, std::string, C-strings,
+//  ics::pair and std::tuple; hash_sequence hashes any Iterable's values in order.
+//hash_of<T> has the int (*)(const T&) signature the hash containers want:
+//  e.g., HashMap<std::string,int,hash_of<std::string>>.
+//Strings are hashed by a wyhash-style function: 48/16 bytes at a time, each
+//  step folding a 64x64->128 bit multiplication ("mum") of key and secret words.
+
+
+namespace hash_detail {
+
+const std::uint64_t secret[4] = {UINT64_C(0xa0761d6478bd642f), UINT64_C(0xe7037ed1a0b428db),
+                                 UINT64_C(0x8ebc6af09c88c6e3), UINT64_C(0x589965cc75374cc3)};
+
+//Multiply a and b to 128 bits: a becomes the low and b the high 64 bits
+inline void mum (std::uint64_t& a, std::uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = (__uint128_t)a * b;
+  a = std::uint64_t(r);
+  b = std::uint64_t(r >> 64);
+#else
+  std::uint64_t ha = a >> 32, la = std::uint32_t(a), hb = b >> 32, lb = std::uint32_t(b);
+  std::uint64_t rh = ha*hb, rm0 = ha*lb, rm1 = hb*la, rl = la*lb;
+  std::uint64_t t  = rl + (rm0 << 32);
+  std::uint64_t c  = t < rl;
+  std::uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  a = lo;
+  b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline std::uint64_t mix (std::uint64_t a, std::uint64_t b) {mum(a,b); return a ^ b;}
+
+//Unaligned reads in native byte order (hash values are not portable across machines)
+inline std::uint64_t read8 (const unsigned char* p) {std::uint64_t v; std::memcpy(&v,p,8); return v;}
+inline std::uint64_t read4 (const unsigned char* p) {std::uint32_t v; std::memcpy(&v,p,4); return v;}
+inline std::uint64_t read3 (const unsigned char* p, std::size_t k)
+{return (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[k >> 1]) << 8) | p[k-1];}
+
+
+//Tuple elements are combined first to last, like hash_sequence
+template<std::size_t I, class... Ts>
+struct tuple_hasher {
+  static std::uint64_t hash (const std::tuple<Ts...>& t);
+};
+
+template<class... Ts>
+struct tuple_hasher<0, Ts...> {
+  static std::uint64_t hash (const std::tuple<Ts...>&)   {return UINT64_C(0x9e3779b97f4a7c15);}
+};
+
+}
+
+
+//Mix all 64 bits of x into all 64 bits of the result (splitmix64's finalizer)
+inline std::uint64_t hash_mix (std::uint64_t x) {
+  x ^= x >> 30;
+  x *= UINT64_C(0xbf58476d1ce4e5b9);
+  x ^= x >> 27;
+  x *= UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+
+//Order matters: hash_combine(a,b) != hash_combine(b,a) (unlike a*b or a^b)
+inline std::uint64_t hash_combine (std::uint64_t seed, std::uint64_t h) {
+  return hash_detail::mix(seed ^ hash_detail::secret[0], h ^ hash_detail::secret[1]);
+}
+
+
+inline std::uint64_t hash_bytes (const void* key, std::size_t len, std::uint64_t seed = 0) {
+  using namespace hash_detail;
+  const unsigned char* p = static_cast<const unsigned char*>(key);
+  seed ^= mix(seed ^ secret[0], secret[1]);
+  std::uint64_t a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+      b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+    }else if (len > 0) {
+      a = read3(p,len);
+      b = 0;
+    }else
+      a = b = 0;
+  }else{
+    std::size_t i = len;
+    if (i > 48) {
+      std::uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = mix(read8(p)    ^ secret[1], read8(p+8)  ^ seed);
+        see1 = mix(read8(p+16) ^ secret[2], read8(p+24) ^ see1);
+        see2 = mix(read8(p+32) ^ secret[3], read8(p+40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = mix(read8(p) ^ secret[1], read8(p+8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+  a ^= secret[1];
+  b ^= seed;
+  mum(a,b);
+  return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//hash64 overloads
+
+inline std::uint64_t hash64 (unsigned long long i) {return hash_mix(i);}
+inline std::uint64_t hash64 (long long i)          {return hash_mix(std::uint64_t(i));}
+inline std::uint64_t hash64 (unsigned long i)      {return hash_mix(i);}
+inline std::uint64_t hash64 (long i)               {return hash_mix(std::uint64_t(i));}
+inline std::uint64_t hash64 (unsigned int i)       {return hash_mix(i);}
+inline std::uint64_t hash64 (int i)                {return hash_mix(std::uint64_t(i));}
+inline std::uint64_t hash64 (unsigned short i)     {return hash_mix(i);}
+inline std::uint64_t hash64 (short i)              {return hash_mix(std::uint64_t(i));}
+inline std::uint64_t hash64 (unsigned char i)      {return hash_mix(i);}
+inline std::uint64_t hash64 (signed char i)        {return hash_mix(std::uint64_t(i));}
+inline std::uint64_t hash64 (char i)               {return hash_mix(std::uint64_t(i));}
+inline std::uint64_t hash64 (bool b)               {return hash_mix(b);}
+
+inline std::uint64_t hash64 (const std::string& s) {return hash_bytes(s.data(),s.size());}
+inline std::uint64_t hash64 (const char* s)        {return hash_bytes(s,std::strlen(s));}
+
+template<class T>
+std::uint64_t hash64 (const T* p) {return hash_mix(std::uint64_t(reinterpret_cast<std::uintptr_t>(p)));}
+
+template<class F,class S>
+std::uint64_t hash64 (const pair<F,S>& p) {return hash_combine(hash64(p.first),hash64(p.second));}
+
+template<class... Ts>
+std::uint64_t hash64 (const std::tuple<Ts...>& t) {return hash_detail::tuple_hasher<sizeof...(Ts),Ts...>::hash(t);}
+
+
+//Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+template<class Iterable>
+std::uint64_t hash_sequence (const Iterable& i) {
+  std::uint64_t answer = UINT64_C(0x9e3779b97f4a7c15);
+  for (const auto& v : i)
+    answer = hash_combine(answer,hash64(v));
+  return answer;
+}
+
+
+//Fold a 64-bit hash into the int that the hash containers use.
+//The containers' hash codes (the int hash functions, and the codes cached in
+//  their nodes) are 32 bits, so they can pick among at most 2^32 bins. Past
+//  about 2^32 keys, chains grow and the keys in a chain increasingly share one
+//  code, so comparing cached codes stops saving key comparisons. Widening the
+//  cached codes and compress to std::uint64_t (e.g., keeping hash64(a) when the
+//  container's hash is hash_of) is left for a follow-up change.
+inline int hash_fold (std::uint64_t h) {return int(std::uint32_t(h ^ (h >> 32)));}
+
+template<class T>
+int hash_of (const T& a) {return hash_fold(hash64(a));}
+
+
+template<std::size_t I, class... Ts>
+std::uint64_t hash_detail::tuple_hasher<I,Ts...>::hash (const std::tuple<Ts...>& t) {
+  return hash_combine(tuple_hasher<I-1,Ts...>::hash(t),hash64(std::get<I-1>(t)));
+}
+
+}
+
+#endif /* ICS_HASH_HPP_ */
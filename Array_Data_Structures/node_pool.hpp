@@ -0,0 +1,183 @@
+#ifndef NODE_POOL_HPP_
+#define NODE_POOL_HPP_
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+
+
+namespace ics {
+
+//A size-class slab allocator for the small, fixed-size nodes (LN/TN) of the
+//  linked, tree, and hash data structures, which allocate and free one node
+//  per operation (and many trailers).
+//Each size class (every multiple of 16 bytes up to max_bytes) has a free list
+//  per thread, so allocating/freeing a node is a few instructions and takes
+//  no lock. An empty free list is refilled with a batch of blocks that some
+//  thread gave back, or else with a new 64KB slab carved into blocks.
+//A thread gives its free list back (as one batch) when it exits, or when it
+//  has freed max_cached more blocks than it allocated: so a thread that frees
+//  nodes allocated by another thread does not hoard them.
+//Slabs are never returned to the system: a container's freed nodes are reused
+//  by the next container using the same size class.
+//
+//Node classes get this allocator by deriving from PoolAllocated, e.g.,
+//  class LN : public PoolAllocated {...}
+//Compile with -DICS_NO_NODE_POOL to allocate nodes with the normal new/delete
+//  (e.g., so tools like valgrind/AddressSanitizer see each node separately).
+class NodePool {
+  public:
+    static void* allocate   (std::size_t bytes);
+    static void  deallocate (void* p, std::size_t bytes);
+
+    static const std::size_t granularity = 16;         //Block sizes (and alignment) are multiples of this
+    static const std::size_t max_bytes   = 256;        //Larger requests use ::operator new
+    static const std::size_t slab_bytes  = 64*1024;
+    static const int         max_cached  = 4096;       //Most net frees before a thread gives its blocks back
+
+  private:
+    static const std::size_t size_classes = max_bytes/granularity;
+
+    struct Block {Block* next; Block* next_batch;};    //A free block links to the next (and a batch's first to the next batch)
+    struct Slab  {Slab*  next;};                       //Header (granularity bytes) at the front of each slab
+
+    //Shared by all threads (guarded by lock); allocated once and never deleted,
+    //  so the slabs stay reachable (and usable) until the program ends
+    struct Shared {
+      std::mutex lock;
+      Block*     batches[size_classes] = {};           //Free lists given back by threads
+      Slab*      slabs                 = nullptr;
+    };
+
+    //One per thread: its destructor gives back all its free lists
+    struct Cache {
+      ~Cache();
+      Block* free [size_classes] = {};
+      int    freed[size_classes] = {};                 //Frees minus allocations since the list was last refilled/given back
+    };
+
+    static Shared& shared    ();
+    static Cache&  cache     ();
+    static Block*  refill    (std::size_t size_class);        //A non-empty list of free blocks of size_class
+    static void    give_back (std::size_t size_class, Block*& list);  //Put list in Shared::batches; list becomes empty
+};
+
+
+//Base class for a node class whose objects are allocated from the NodePool.
+//It is empty, so it adds nothing to the size of the node.
+struct PoolAllocated {
+#ifndef ICS_NO_NODE_POOL
+  static void* operator new    (std::size_t bytes)          {return NodePool::allocate(bytes);}
+  static void  operator delete (void* p, std::size_t bytes) {NodePool::deallocate(p,bytes);}
+#endif
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//NodePool definitions
+
+inline void* NodePool::allocate (std::size_t bytes) {
+  if (bytes > max_bytes)
+    return ::operator new(bytes);
+
+  std::size_t size_class = bytes == 0 ? 0 : (bytes-1)/granularity;
+  Cache&  c    = cache();
+  Block*& list = c.free[size_class];
+  if (list == nullptr) {
+    list = refill(size_class);
+    c.freed[size_class] = 0;
+  }else if (c.freed[size_class] > 0)
+    --c.freed[size_class];
+
+  Block* to_return = list;
+  list = list->next;
+  return to_return;
+}
+
+
+inline void NodePool::deallocate (void* p, std::size_t bytes) {
+  if (p == nullptr)
+    return;
+  if (bytes > max_bytes) {
+    ::operator delete(p);
+    return;
+  }
+
+  std::size_t size_class = bytes == 0 ? 0 : (bytes-1)/granularity;
+  Cache&  c    = cache();
+  Block*& list = c.free[size_class];
+  Block*  b    = static_cast<Block*>(p);
+  b->next = list;
+  list    = b;
+  if (++c.freed[size_class] >= max_cached) {
+    give_back(size_class,list);
+    c.freed[size_class] = 0;
+  }
+}
+
+
+inline NodePool::Shared& NodePool::shared () {
+  static Shared* s = new Shared();
+  return *s;
+}
+
+
+inline NodePool::Cache& NodePool::cache () {
+  static thread_local Cache c;
+  return c;
+}
+
+
+//Static objects destroyed after this thread's Cache may still free nodes: those
+//  blocks go on the (now empty) lists and are not reused
+inline NodePool::Cache::~Cache () {
+  for (std::size_t c=0; c<size_classes; ++c)
+    if (free[c] != nullptr)
+      give_back(c,free[c]);
+}
+
+
+inline void NodePool::give_back (std::size_t size_class, Block*& list) {
+  Shared& s = shared();
+  std::lock_guard<std::mutex> guard(s.lock);
+  list->next_batch      = s.batches[size_class];
+  s.batches[size_class] = list;
+  list = nullptr;
+}
+
+
+inline NodePool::Block* NodePool::refill (std::size_t size_class) {
+  Shared& s = shared();
+  std::lock_guard<std::mutex> guard(s.lock);
+
+  //Take a batch that some thread gave back, if any
+  if (s.batches[size_class] != nullptr) {
+    Block* to_return = s.batches[size_class];
+    s.batches[size_class] = to_return->next_batch;
+    return to_return;
+  }
+
+  //Otherwise carve a new slab into a list of blocks (in address order)
+  char* slab = static_cast<char*>(::operator new(slab_bytes));
+  Slab* header = reinterpret_cast<Slab*>(slab);
+  header->next = s.slabs;
+  s.slabs      = header;
+
+  std::size_t block_bytes = (size_class+1)*granularity;
+  Block*  to_return = nullptr;
+  Block** tail      = &to_return;
+  for (char* b = slab+granularity; b+block_bytes <= slab+slab_bytes; b += block_bytes) {
+    *tail = reinterpret_cast<Block*>(b);
+    tail  = &(*tail)->next;
+  }
+  *tail = nullptr;
+  return to_return;
+}
+
+}
+
+#endif /* NODE_POOL_HPP_ */
@@ -3,6 +3,7 @@
 
 
 #include <iostream>
+#include <utility>
 
 namespace ics {
 
@@ -11,18 +12,28 @@ class pair {
   public:
     pair(){}
     pair(const F& f,const S& s) : first(f), second(s) {/*first = f; second = s; std::cout << "in pair:" << first << "/" << second << std::endl;*/}
+    template<class F2,class S2>
+    pair(F2&& f,S2&& s) : first(std::forward<F2>(f)), second(std::forward<S2>(s)) {}
+    pair(const pair<F,S>& p)                      = default;
+    pair(pair<F,S>&& p)                           = default;   //Declared: the virtual destructor suppresses it
+    pair<F,S>& operator = (const pair<F,S>& rhs)  = default;
+    pair<F,S>& operator = (pair<F,S>&& rhs)       = default;
     virtual ~pair(){}
       F first;
       S second;
       bool operator == (const pair<F,S>& rhs) const {return first == rhs.first && second == rhs.second;}
       bool operator != (const pair<F,S>& rhs) const {return !(*this==rhs);}
 
+      //Compare with a pair of other types, if F == F2 and S == S2 are defined (e.g., StringView and std::string)
+      template<class F2,class S2>
+      bool operator == (const pair<F2,S2>& rhs) const {return first == rhs.first && second == rhs.second;}
+
       template<class F2,class S2>
       friend std::ostream& operator << (std::ostream& outs, const pair<F2,S2>& p);
 };
 
 template<class F,class S>
-pair<F,S> make_pair(F f, S s){return pair<F,S>(f,s);}
+pair<F,S> make_pair(F f, S s){return pair<F,S>(std::move(f),std::move(s));}
 
 template<class F,class S>
 std::ostream& operator << (std::ostream& outs, const pair<F,S>& p){
@@ -0,0 +1,80 @@
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+//Helpers for the containers' parallel bulk operations (e.g., HashMap::build_parallel).
+//Work is split into contiguous chunks, one per thread, so threads write disjoint
+//  data and need no locking; t's chunk of 0..n-1 is [chunk_begin(n,t,threads),
+//  chunk_begin(n,t+1,threads)).
+
+//The # of threads to use for n items: requested (0 means hardware_concurrency),
+//  but at most one per grain items and at least 1
+inline int threads_for (int requested, size_type n, size_type grain) {
+  if (requested <= 0)
+    requested = std::max(1,int(std::thread::hardware_concurrency()));
+  return int(std::max<size_type>(1,std::min<size_type>(requested,n/grain)));
+}
+
+
+inline size_type chunk_begin (size_type n, int t, int threads) {
+  return n*t/threads;
+}
+
+
+//Calls work(t) for each t in [0,threads): work(0) on the calling thread, the
+//  others on new threads; returns when all have returned
+template<class Work>
+void on_threads (int threads, const Work& work) {
+  std::vector<std::thread> workers;
+  for (int t=1; t<threads; ++t)
+    workers.push_back(std::thread(work,t));
+  work(0);
+  for (std::thread& w : workers)
+    w.join();
+}
+
+
+//A stable parallel counting sort of 0..n-1 by part_of(i) (in [0,parts)): afterward
+//  order[start[p]..start[p+1]-1] are the i with part_of(i) == p, in increasing order.
+//Each thread counts its chunk's parts; then (knowing where the earlier chunks'
+//  items in each part go) places them: so no two threads write the same element.
+template<class PartOf>
+void partition_parallel (size_type n, int parts, const PartOf& part_of, int threads,
+                         std::vector<size_type>& order, std::vector<size_type>& start) {
+  std::vector<size_type> counts(size_type(threads)*parts,0);   //counts[t*parts+p]: chunk t's items in part p
+  on_threads(threads, [&] (int t) {
+    size_type* count = &counts[size_type(t)*parts];
+    for (size_type i=chunk_begin(n,t,threads); i<chunk_begin(n,t+1,threads); ++i)
+      ++count[part_of(i)];
+  });
+
+  start.assign(parts+1,0);
+  size_type next = 0;
+  for (int p=0; p<parts; ++p) {
+    start[p] = next;
+    for (int t=0; t<threads; ++t) {
+      size_type in_chunk = counts[size_type(t)*parts+p];
+      counts[size_type(t)*parts+p] = next;                     //Now: where chunk t's items in part p go
+      next += in_chunk;
+    }
+  }
+  start[parts] = next;
+
+  order.resize(n);
+  on_threads(threads, [&] (int t) {
+    size_type* place = &counts[size_type(t)*parts];
+    for (size_type i=chunk_begin(n,t,threads); i<chunk_begin(n,t+1,threads); ++i)
+      order[place[part_of(i)]++] = i;
+  });
+}
+
+}
+
+#endif /* PARALLEL_HPP_ */
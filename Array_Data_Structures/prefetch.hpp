@@ -0,0 +1,25 @@
+#ifndef PREFETCH_HPP_
+#define PREFETCH_HPP_
+
+
+namespace ics {
+
+//Batched lookups (HashMap::find_many, HashSet::contains_many) hash a batch of
+//  keys, prefetch the memory each lookup will read first, and only then
+//  search; so the cache misses of the whole batch overlap instead of each
+//  lookup waiting for its own. prefetch(p) asks for the cache line holding p
+//  without waiting for it (and never faults, even if p is invalid); it does
+//  nothing where the compiler has no prefetch builtin.
+const int lookup_batch = 16;    //Keys per batch: enough to hide a miss, few enough to stay cached
+
+inline void prefetch (const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+}
+
+#endif /* PREFETCH_HPP_ */
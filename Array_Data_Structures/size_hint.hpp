@@ -0,0 +1,36 @@
+#ifndef SIZE_HINT_HPP_
+#define SIZE_HINT_HPP_
+
+#include <cstddef>
+
+
+namespace ics {
+
+//Sizes, counts, and indexes in the containers: 64 bits on 64-bit platforms, so
+//  a container can hold more than 2^31 values. It is signed, so code that
+//  counts down to 0 or uses -1 as "no index" works as it did with int.
+typedef std::ptrdiff_t size_type;
+
+
+//Bulk operations (put_all, insert_all, enqueue_all, ...) accept any Iterable,
+//  but only some Iterables (all the ics containers, std containers, and
+//  std::initializer_list) know their size. size_hint(i) is i.size() for those
+//  and 0 (unknown) for the rest, so a container can make room for all of i's
+//  values once, before inserting them, rather than growing repeatedly.
+namespace size_detail {
+
+template<class Iterable>
+auto size_of (const Iterable& i, int) -> decltype(size_type(i.size())) {return size_type(i.size());}
+
+template<class Iterable>
+size_type size_of (const Iterable&, long) {return 0;}
+
+}
+
+
+template<class Iterable>
+size_type size_hint (const Iterable& i) {return size_detail::size_of(i,0);}
+
+}
+
+#endif /* SIZE_HINT_HPP_ */
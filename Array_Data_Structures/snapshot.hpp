@@ -0,0 +1,309 @@
+#ifndef SNAPSHOT_HPP_
+#define SNAPSHOT_HPP_
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include "ics_exceptions.hpp"
+#include "ics_hash.hpp"
+#include "string_view.hpp"
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+//A snapshot is a binary image of a HashMap or HashSet whose keys (and values)
+//  are trivially copyable (e.g., int, double, a struct of them) or std::string.
+//save_map_snapshot/save_set_snapshot write one to a stream (open it with
+//  std::ios::binary); load_map_snapshot/load_set_snapshot rebuild a container
+//  from one, reserving all its bins first, so loading never rehashes.
+//A MappedHashMap (mapped_hash_map.hpp) answers lookups straight from a map's
+//  snapshot file, by mapping it into memory: nothing is read until it is used.
+//
+//Layout (all offsets/sizes in bytes, from the start of the snapshot):
+//  Header : 64 bytes, below; version changes whenever the layout does
+//  Index  : slots (a power of 2, at least 2*count) Slots: an open-addressing
+//           (linear probing) table of every key's hash code and the offset of
+//           its entry; a Slot whose entry is 0 is empty
+//  Entries: count entries, each a key then (for a map) its value
+//A trivially copyable key/value is stored as its bytes; a std::string as its
+//  length (8 bytes) then its characters. Each is padded to a multiple of 8
+//  bytes, so each starts 8-byte aligned.
+//Numbers are stored in the byte order of the machine saving the snapshot,
+//  so a snapshot can be loaded only on a machine with the same byte order
+//  (otherwise its version will not match). load_map_snapshot/load_set_snapshot
+//  recompute each key's hash code (they put/insert it), so they may use any hash
+//  function; a MappedHashMap probes the index by the stored hash codes, so it
+//  needs the hash function the snapshot was saved with.
+namespace snapshot_detail {
+
+const char          magic[8]    = {'I','C','S','S','N','A','P','\n'};
+const std::uint32_t version     = 1;
+const std::uint32_t set_kind    = 1;
+const std::uint32_t map_kind    = 2;
+const std::uint32_t string_size = 0;   //key_size/value_size of std::string
+
+struct Header {
+  char          magic[8];
+  std::uint32_t version;
+  std::uint32_t kind;             //set_kind or map_kind
+  std::uint32_t key_size;         //sizeof(KEY), or string_size
+  std::uint32_t value_size;       //sizeof(T), or string_size (0 for a set)
+  std::uint64_t count;            //# entries
+  std::uint64_t slots;            //# Slots in the index
+  std::uint64_t index_offset;
+  std::uint64_t entries_offset;
+  std::uint64_t bytes;            //Size of the whole snapshot
+};
+
+struct Slot {
+  std::int32_t  hash_code;
+  std::uint32_t unused;
+  std::uint64_t entry;            //Offset of the entry; 0 means the slot is empty
+};
+
+static_assert(sizeof(Header) == 64, "snapshot Header must be 64 bytes");
+static_assert(sizeof(Slot)   == 16, "snapshot Slot must be 16 bytes");
+
+
+inline std::uint64_t padded (std::uint64_t bytes) {return (bytes+7) & ~std::uint64_t(7);}
+
+inline void write_padding (std::ostream& out, std::uint64_t bytes) {
+  static const char zeros[8] = {};
+  out.write(zeros,std::streamsize(padded(bytes)-bytes));
+}
+
+//The first slot to probe for hash_code (slots is a power of 2)
+inline std::uint64_t home_slot (int hash_code, std::uint64_t slots) {
+  return hash_mix(std::uint32_t(hash_code)) & (slots-1);
+}
+
+
+//How a key/value of type T is stored: bytes, bytes_at (of the stored one at p,
+//  which must end by end: else IcsError), write (to a stream), read (a copy),
+//  view (without copying: const T& or StringView), and equals
+template<class T>
+struct Codec {
+  static_assert(std::is_trivially_copyable<T>::value, "snapshot: keys/values must be trivially copyable or std::string");
+  static_assert(alignof(T) <= 8, "snapshot: keys/values must need at most 8-byte alignment");
+
+  typedef const T& View;
+  static const std::uint32_t size = sizeof(T);
+
+  static std::uint64_t bytes    (const T&)          {return padded(sizeof(T));}
+  static std::uint64_t bytes_at (const char*, const char*) {return padded(sizeof(T));}
+  static View          view     (const char* p)     {return *reinterpret_cast<const T*>(p);}
+  static T             read     (const char* p)     {return view(p);}
+  static void write (std::ostream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v),sizeof(T));
+    write_padding(out,sizeof(T));
+  }
+  template <class LOOKUP>
+  static bool equals (const char* p, const LOOKUP& key) {return key == view(p);}
+};
+
+
+template<>
+struct Codec<std::string> {
+  typedef StringView View;
+  static const std::uint32_t size = string_size;
+
+  static std::uint64_t length   (const char* p)         {std::uint64_t n; std::memcpy(&n,p,8); return n;}
+  static std::uint64_t bytes    (const std::string& s)  {return 8 + padded(s.size());}
+  static std::uint64_t bytes_at (const char* p, const char* end) {
+    if (end-p < 8 || length(p) > std::uint64_t(end-p-8))   //Before padding, which could wrap around
+      throw IcsError("snapshot: corrupt std::string length");
+    return 8 + padded(length(p));
+  }
+  static View          view     (const char* p)         {return StringView(p+8,length(p));}
+  static std::string   read     (const char* p)         {return std::string(p+8,length(p));}
+  static void write (std::ostream& out, const std::string& s) {
+    std::uint64_t n = s.size();
+    out.write(reinterpret_cast<const char*>(&n),8);
+    out.write(s.data(),std::streamsize(n));
+    write_padding(out,n);
+  }
+  template <class LOOKUP>
+  static bool equals (const char* p, const LOOKUP& key) {return key == view(p);}
+};
+
+
+//Builds the Header and index while a container's entries are added (in the
+//  order they will be written), then writes both
+class Layout {
+  public:
+    Layout (std::uint32_t kind, std::uint32_t key_size, std::uint32_t value_size, std::uint64_t count) {
+      std::memcpy(header.magic,magic,8);
+      header.version    = version;
+      header.kind       = kind;
+      header.key_size   = key_size;
+      header.value_size = value_size;
+      header.count      = count;
+      header.slots      = 1;
+      while (header.slots < 2*header.count)
+        header.slots *= 2;
+      header.index_offset   = sizeof(Header);
+      header.entries_offset = header.index_offset + header.slots*sizeof(Slot);
+      header.bytes          = header.entries_offset;
+      index.assign(std::size_t(header.slots),Slot{0,0,0});
+    }
+
+    void add (int hash_code, std::uint64_t entry_bytes) {
+      std::uint64_t s = home_slot(hash_code,header.slots);
+      while (index[s].entry != 0)
+        s = (s+1) & (header.slots-1);
+      index[s] = Slot{hash_code,0,header.bytes};
+      header.bytes += entry_bytes;
+    }
+
+    void write (std::ostream& out) const {
+      out.write(reinterpret_cast<const char*>(&header),sizeof(Header));
+      out.write(reinterpret_cast<const char*>(index.data()),std::streamsize(index.size()*sizeof(Slot)));
+    }
+
+  private:
+    Header            header;
+    std::vector<Slot> index;
+};
+
+
+//Throws IcsError (with who in its message) unless h describes a snapshot of this
+//  kind/key_size/value_size whose parts fit in bytes
+inline void check_header (const Header& h, std::uint32_t kind, std::uint32_t key_size, std::uint32_t value_size,
+                          std::uint64_t bytes, const std::string& who) {
+  if (std::memcmp(h.magic,magic,8) != 0)
+    throw IcsError(who+": not a snapshot");
+  if (h.version != version)
+    throw IcsError(who+": unsupported snapshot version (or byte order)");
+  if (h.kind != kind)
+    throw IcsError(who+(kind == map_kind ? ": snapshot is of a set, not a map" : ": snapshot is of a map, not a set"));
+  if (h.key_size != key_size || (kind == map_kind && h.value_size != value_size))
+    throw IcsError(who+": snapshot's key/value types differ");
+  if (h.slots == 0 || (h.slots & (h.slots-1)) != 0 || h.slots <= h.count || h.slots > bytes/sizeof(Slot) || h.index_offset != sizeof(Header) ||
+      h.entries_offset != h.index_offset + h.slots*sizeof(Slot) || h.bytes < h.entries_offset || h.bytes > bytes)
+    throw IcsError(who+": corrupt snapshot header");
+}
+
+
+//Reads (and checks) the Header, skips the index, and returns the entries
+//  (in uint64_t words, so each is 8-byte aligned)
+inline std::vector<std::uint64_t> read_entries (std::istream& in, Header& h, std::uint32_t kind,
+                                                std::uint32_t key_size, std::uint32_t value_size, const std::string& who) {
+  if (!in.read(reinterpret_cast<char*>(&h),sizeof(Header)))
+    throw IcsError(who+": not a snapshot (too short)");
+  check_header(h,kind,key_size,value_size,h.bytes,who);
+  in.ignore(std::streamsize(h.entries_offset-h.index_offset));
+  std::vector<std::uint64_t> entries(std::size_t((h.bytes-h.entries_offset)/8));
+  if (!in.read(reinterpret_cast<char*>(entries.data()),std::streamsize(entries.size()*8)))
+    throw IcsError(who+": snapshot is truncated");
+  return entries;
+}
+
+
+//The entry part (key or value) after the one of type T at p; IcsError if
+//  that part does not end by end
+template<class T>
+const char* skip (const char* p, const char* end, const std::string& who) {
+  if (end-p < 8)
+    throw IcsError(who+": corrupt snapshot entry");
+  std::uint64_t bytes = Codec<T>::bytes_at(p,end);
+  if (bytes > std::uint64_t(end-p))
+    throw IcsError(who+": corrupt snapshot entry");
+  return p + bytes;
+}
+
+}
+
+
+
+
+//Write m (a HashMap, or any map with Entry, public hash, size, and begin/end) to out
+template<class Map>
+void save_map_snapshot (std::ostream& out, const Map& m) {
+  typedef typename Map::Entry Entry;
+  typedef typename std::decay<decltype(std::declval<Entry>().first)>::type  KEY;
+  typedef typename std::decay<decltype(std::declval<Entry>().second)>::type T;
+  using namespace snapshot_detail;
+
+  Layout layout(map_kind,Codec<KEY>::size,Codec<T>::size,std::uint64_t(m.size()));
+  for (const Entry& e : m)
+    layout.add(m.hash(e.first),Codec<KEY>::bytes(e.first)+Codec<T>::bytes(e.second));
+  layout.write(out);
+  for (const Entry& e : m) {
+    Codec<KEY>::write(out,e.first);
+    Codec<T>::write(out,e.second);
+  }
+  if (!out)
+    throw IcsError("save_map_snapshot: write failed");
+}
+
+
+//Write s (a HashSet, or any set with public hash, size, and begin/end) to out
+template<class Set>
+void save_set_snapshot (std::ostream& out, const Set& s) {
+  typedef typename std::decay<decltype(*s.begin())>::type T;
+  using namespace snapshot_detail;
+
+  Layout layout(set_kind,Codec<T>::size,0,std::uint64_t(s.size()));
+  for (const T& e : s)
+    layout.add(s.hash(e),Codec<T>::bytes(e));
+  layout.write(out);
+  for (const T& e : s)
+    Codec<T>::write(out,e);
+  if (!out)
+    throw IcsError("save_set_snapshot: write failed");
+}
+
+
+//Replace m's entries by those in the snapshot read from in (each key is hashed by m's hash
+//  function as it is put). IcsError if in is not a snapshot of such a map.
+template<class Map>
+void load_map_snapshot (std::istream& in, Map& m) {
+  typedef typename Map::Entry Entry;
+  typedef typename std::decay<decltype(std::declval<Entry>().first)>::type  KEY;
+  typedef typename std::decay<decltype(std::declval<Entry>().second)>::type T;
+  using namespace snapshot_detail;
+
+  Header h;
+  std::vector<std::uint64_t> entries = read_entries(in,h,map_kind,Codec<KEY>::size,Codec<T>::size,"load_map_snapshot");
+  m.clear();
+  m.reserve(size_type(h.count));
+  const char* p   = reinterpret_cast<const char*>(entries.data());
+  const char* end = p + entries.size()*8;
+  for (std::uint64_t i=0; i<h.count; ++i) {
+    const char* v    = skip<KEY>(p,end,"load_map_snapshot");
+    const char* next = skip<T>(v,end,"load_map_snapshot");
+    m.put(Codec<KEY>::read(p),Codec<T>::read(v));
+    p = next;
+  }
+}
+
+
+//Replace s's values by those in the snapshot read from in (each value is hashed by s's hash
+//  function as it is inserted). IcsError if in is not a snapshot of such a set.
+template<class Set>
+void load_set_snapshot (std::istream& in, Set& s) {
+  typedef typename std::decay<decltype(*s.begin())>::type T;
+  using namespace snapshot_detail;
+
+  Header h;
+  std::vector<std::uint64_t> entries = read_entries(in,h,set_kind,Codec<T>::size,0,"load_set_snapshot");
+  s.clear();
+  s.reserve(size_type(h.count));
+  const char* p   = reinterpret_cast<const char*>(entries.data());
+  const char* end = p + entries.size()*8;
+  for (std::uint64_t i=0; i<h.count; ++i) {
+    const char* next = skip<T>(p,end,"load_set_snapshot");
+    s.insert(Codec<T>::read(p));
+    p = next;
+  }
+}
+
+}
+
+#endif /* SNAPSHOT_HPP_ */
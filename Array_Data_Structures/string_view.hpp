@@ -0,0 +1,71 @@
+#ifndef STRING_VIEW_HPP_
+#define STRING_VIEW_HPP_
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include "ics_hash.hpp"
+
+
+namespace ics {
+
+//A read-only view of characters stored elsewhere (in a std::string, a C-string,
+//  or the middle of a line being parsed), like C++17's std::string_view: it
+//  does not own (or copy) its characters, so they must outlive the view.
+//It is for looking up std::string keys without building a std::string:
+//  StringView == std::string compares the characters, and hash64/hash_of of a
+//  StringView equal those of a std::string with the same characters, e.g.,
+//    HashMap<std::string,int,hash_of<std::string>> m;
+//    m.has_key(StringView(line.data()+start,length), hash_of<StringView>)
+class StringView {
+  public:
+    StringView ()                             : chars(""), length(0) {}
+    StringView (const char* s)                : chars(s), length(std::strlen(s)) {}
+    StringView (const char* s, std::size_t n) : chars(s), length(n) {}
+    StringView (const std::string& s)         : chars(s.data()), length(s.size()) {}
+#if __cplusplus >= 201703L
+    StringView (std::string_view s)           : chars(s.data()), length(s.size()) {}
+#endif
+
+    const char* data  () const {return chars;}
+    std::size_t size  () const {return length;}
+    bool        empty () const {return length == 0;}
+    std::string str   () const {return std::string(chars,length);}
+
+    bool operator == (const StringView& rhs) const {return length == rhs.length && std::memcmp(chars,rhs.chars,length) == 0;}
+    bool operator != (const StringView& rhs) const {return !(*this == rhs);}
+
+  private:
+    const char* chars;
+    std::size_t length;
+};
+
+
+//Mixed comparisons (so neither side is converted to a std::string)
+inline bool operator == (const StringView& a, const std::string& b) {return a == StringView(b);}
+inline bool operator == (const std::string& a, const StringView& b) {return StringView(a) == b;}
+inline bool operator == (const StringView& a, const char* b)        {return a == StringView(b);}
+inline bool operator == (const char* a, const StringView& b)        {return StringView(a) == b;}
+inline bool operator != (const StringView& a, const std::string& b) {return !(a == b);}
+inline bool operator != (const std::string& a, const StringView& b) {return !(a == b);}
+inline bool operator != (const StringView& a, const char* b)        {return !(a == b);}
+inline bool operator != (const char* a, const StringView& b)        {return !(a == b);}
+
+
+inline std::ostream& operator << (std::ostream& outs, const StringView& s) {
+  outs.write(s.data(),s.size());
+  return outs;
+}
+
+
+//Same as hash64(const std::string&) for the same characters
+inline std::uint64_t hash64 (const StringView& s) {return hash_bytes(s.data(),s.size());}
+
+}
+
+#endif /* STRING_VIEW_HPP_ */
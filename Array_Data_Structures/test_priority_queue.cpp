@@ -578,6 +578,28 @@
 //}
 //
 //
+//TEST_F(PriorityQueueTest, enqueue_all_bulk) {
+//  PriorityQueueTypeInt q;
+//  q.enqueue(500);
+//  ics::ArrayStack<int> many, few;
+//  for (int i=0; i<1000; ++i)
+//    many.push(i*7919%1000);          //0..999, scrambled
+//  for (int i=0; i<5; ++i)
+//    few.push(1000-i);
+//  ASSERT_EQ(1000,q.enqueue_all(many));
+//  ASSERT_EQ(5,q.enqueue_all(few));
+//  ASSERT_EQ(1006,q.size());
+//
+//  int previous = q.dequeue();
+//  for (int i=1; i<1006; ++i) {
+//    int next = q.dequeue();
+//    ASSERT_LE(previous,next);
+//    previous = next;
+//  }
+//  ASSERT_EQ(1000,previous);
+//}
+//
+//
 //TEST_F(PriorityQueueTest, large_scale) {
 //  PriorityQueueTypeInt lq;
 //  ics::ArrayPriorityQueue<int,gt_int> lq_ref;
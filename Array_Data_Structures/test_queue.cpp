@@ -443,6 +443,24 @@
 //}
 //
 //
+//TEST_F(QueueTest, move_and_emplace) {
+//  QueueType q;
+//  load(q,"abc");
+//  QueueType moved(std::move(q));
+//  ASSERT_EQ(3,moved.size());
+//  ASSERT_TRUE(q.empty());
+//  q.enqueue("d");                    //a moved-from queue is still usable
+//  q = std::move(moved);
+//  ASSERT_EQ(1,moved.size());
+//  ASSERT_EQ("d",moved.peek());
+//
+//  ASSERT_EQ(1,q.emplace(2,'e'));     //std::string(2,'e')
+//  ASSERT_TRUE(unload(q,"abc"));
+//  ASSERT_EQ("ee",q.dequeue());
+//  ASSERT_TRUE(q.empty());
+//}
+//
+//
 //TEST_F(QueueTest, large_scale) {
 //  QueueType2 lq;
 //  for (int test=1; test<=5; ++test) {
@@ -0,0 +1,562 @@
+#ifndef CONCURRENT_HASH_MAP_HPP_
+#define CONCURRENT_HASH_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <mutex>
+#include <initializer_list>
+#include <utility>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "size_hint.hpp"
+#include "array_queue.hpp"
+#include "hash_map.hpp"
+
+
+namespace ics {
+
+
+//A map that many threads may use at once: keys are split across shard_count
+//  independent HashMaps (shards), each guarded by its own mutex, so threads
+//  working on keys in different shards never wait for each other.
+//A key's shard is chosen by the high bits of its (mixed) hash code; the shard's
+//  HashMap chooses a bin from lower bits, so the two choices are independent.
+//Every operation locks exactly one shard, except those that look at the whole
+//  map (size, empty, has_value, clear, str, <<), which lock each shard in turn:
+//  with other threads writing, their answers are only a recent approximation.
+//There is no operator [] (a returned reference would outlive the lock): use
+//  get to read a value and put or compute to change one.
+//
+//The Iterator is weakly consistent: it copies one shard's entries at a time (under
+//  that shard's lock) and steps through the copies. It never throws
+//  ConcurrentModificationError; it sees each entry present for the whole
+//  iteration exactly once, and may or may not see entries put/erased during it.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> class ConcurrentHashMap {
+  public:
+    typedef ics::pair<KEY,T>   Entry;
+    typedef int (*hashfunc) (const KEY& a);
+
+    //Destructor/Constructors
+    ~ConcurrentHashMap ();
+
+    ConcurrentHashMap          (double the_load_threshold = 1.0, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    explicit ConcurrentHashMap (int initial_shards, double the_load_threshold = 1.0, int (*chash)(const KEY& k) = undefinedhash<KEY>);
+    explicit ConcurrentHashMap (const std::initializer_list<Entry>& il, double the_load_threshold = 1.0, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit ConcurrentHashMap (const Iterable& i, double the_load_threshold = 1.0, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Mutexes cannot be copied: use put_all to copy another map's entries
+    ConcurrentHashMap (const ConcurrentHashMap<KEY,T,thash>& to_copy)                                  = delete;
+    ConcurrentHashMap<KEY,T,thash>& operator = (const ConcurrentHashMap<KEY,T,thash>& rhs)            = delete;
+
+
+    //Queries
+    bool      empty      () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    bool      has_value  (const T& value) const;
+    T         get        (const KEY& key) const;  //Copy of key's value; throws KeyError if key is not in the map
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    put   (const KEY& key, T&& value);
+    T    erase (const KEY& key);
+    void clear ();
+    void reserve (size_type n);   //Grow every shard now to hold its share of n keys
+
+    //Atomically update key's value in place (an absent key first maps to T(), like
+    //  HashMap's operator []) by calling update(value); returns the updated value.
+    //  e.g., m.compute(word, [](int& count){++count;})
+    //update runs while the key's shard is locked: it must not use this map.
+    template <class Update>
+    T compute (const KEY& key, Update update);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    size_type put_all(const Iterable& i);
+
+
+    //Operators
+
+    template<class KEY2,class T2, int (*hash2)(const KEY2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const ConcurrentHashMap<KEY2,T2,hash2>& m);
+
+
+
+  public:
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of ConcurrentHashMap<T>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        ConcurrentHashMap<KEY,T,thash>::Iterator& operator ++ ();
+        ConcurrentHashMap<KEY,T,thash>::Iterator  operator ++ (int);
+        bool operator == (const ConcurrentHashMap<KEY,T,thash>::Iterator& rhs) const;
+        bool operator != (const ConcurrentHashMap<KEY,T,thash>::Iterator& rhs) const;
+        const Entry& operator *  () const;
+        const Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const ConcurrentHashMap<KEY,T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator ConcurrentHashMap<KEY,T,thash>::begin () const;
+        friend Iterator ConcurrentHashMap<KEY,T,thash>::end   () const;
+
+      private:
+        //If can_erase is false, the front of snapshot has been erased (must ++ to reach the next value)
+        int                             shard;     //Index of the shard being iterated over; shard_count at the end
+        ArrayQueue<Entry>               snapshot;  //Entries in shard not yet iterated over; front is current
+        ConcurrentHashMap<KEY,T,thash>* ref_map;
+        bool                            can_erase = true;
+
+        //Helper methods
+        void advance_cursors();
+
+        //Called in friends begin/end
+        Iterator(ConcurrentHashMap<KEY,T,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    static const int default_shard_count = 16;
+
+
+  private:
+    struct Shard {
+      Shard (double the_load_threshold, hashfunc h) : map(the_load_threshold,h) {}
+
+      std::mutex           lock;   //Held while map is read or changed
+      HashMap<KEY,T,thash> map;
+    };
+
+    int (*hash)(const KEY& k);   //Hashing function used (from template or constructor)
+    Shard** shards = nullptr;    //Pointer to array of shard_count pointers to Shards
+    int shard_count = 1;         //# shards in array: a power of 2
+    int shard_bits  = 0;         //shard_count == 2^shard_bits
+
+
+    //Helper methods
+    void   check_hash        (const char* constructor, int (*chash)(const KEY& a)) const;
+    void   allocate_shards   (int at_least, double the_load_threshold);  //shard_count >= at_least
+    Shard& shard_for         (const KEY& key) const;                     //The shard that key belongs in
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConcurrentHashMap class and related definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const int ConcurrentHashMap<KEY,T,thash>::default_shard_count;
+
+
+//Destructor/Constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+ConcurrentHashMap<KEY,T,thash>::~ConcurrentHashMap() {
+  for (int s=0; s<shard_count; ++s)
+    delete shards[s];
+  delete[] shards;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+ConcurrentHashMap<KEY,T,thash>::ConcurrentHashMap(double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  check_hash("default",chash);
+  allocate_shards(default_shard_count,the_load_threshold);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+ConcurrentHashMap<KEY,T,thash>::ConcurrentHashMap(int initial_shards, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  check_hash("shard_count",chash);
+  allocate_shards(initial_shards,the_load_threshold);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+ConcurrentHashMap<KEY,T,thash>::ConcurrentHashMap(const std::initializer_list<Entry>& il, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  check_hash("initializer_list",chash);
+  allocate_shards(default_shard_count,the_load_threshold);
+  put_all(il);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class Iterable>
+ConcurrentHashMap<KEY,T,thash>::ConcurrentHashMap(const Iterable& i, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+  check_hash("Iterable",chash);
+  allocate_shards(default_shard_count,the_load_threshold);
+  put_all(i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool ConcurrentHashMap<KEY,T,thash>::empty() const {
+  for (int s=0; s<shard_count; ++s) {
+    std::lock_guard<std::mutex> guard(shards[s]->lock);
+    if (!shards[s]->map.empty())
+      return false;
+  }
+
+  return true;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type ConcurrentHashMap<KEY,T,thash>::size() const {
+  size_type answer = 0;
+  for (int s=0; s<shard_count; ++s) {
+    std::lock_guard<std::mutex> guard(shards[s]->lock);
+    answer += shards[s]->map.size();
+  }
+
+  return answer;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool ConcurrentHashMap<KEY,T,thash>::has_key (const KEY& key) const {
+  Shard& s = shard_for(key);
+  std::lock_guard<std::mutex> guard(s.lock);
+  return s.map.has_key(key);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool ConcurrentHashMap<KEY,T,thash>::has_value (const T& value) const {
+  for (int s=0; s<shard_count; ++s) {
+    std::lock_guard<std::mutex> guard(shards[s]->lock);
+    if (shards[s]->map.has_value(value))
+      return true;
+  }
+
+  return false;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T ConcurrentHashMap<KEY,T,thash>::get (const KEY& key) const {
+  Shard& s = shard_for(key);
+  std::lock_guard<std::mutex> guard(s.lock);
+  if (s.map.has_key(key))
+    return static_cast<const HashMap<KEY,T,thash>&>(s.map)[key];
+
+  std::ostringstream answer;
+  answer << "ConcurrentHashMap::get: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string ConcurrentHashMap<KEY,T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "ConcurrentHashMap[" << std::endl;
+  for (int s=0; s<shard_count; ++s) {
+    std::lock_guard<std::mutex> guard(shards[s]->lock);
+    answer << "  shard[" << s << "] = " << shards[s]->map.str() << std::endl;
+  }
+  answer  << "](shard_count=" << shard_count << ")";
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T ConcurrentHashMap<KEY,T,thash>::put(const KEY& key, const T& value) {
+  Shard& s = shard_for(key);
+  std::lock_guard<std::mutex> guard(s.lock);
+  return s.map.put(key,value);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T ConcurrentHashMap<KEY,T,thash>::put(const KEY& key, T&& value) {
+  Shard& s = shard_for(key);
+  std::lock_guard<std::mutex> guard(s.lock);
+  return s.map.put(key,std::move(value));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T ConcurrentHashMap<KEY,T,thash>::erase(const KEY& key) {
+  Shard& s = shard_for(key);
+  std::lock_guard<std::mutex> guard(s.lock);
+  if (s.map.has_key(key))
+    return s.map.erase(key);
+
+  std::ostringstream answer;
+  answer << "ConcurrentHashMap::erase: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void ConcurrentHashMap<KEY,T,thash>::clear() {
+  for (int s=0; s<shard_count; ++s) {
+    std::lock_guard<std::mutex> guard(shards[s]->lock);
+    shards[s]->map.clear();
+  }
+}
+
+
+//Keys hash evenly over the shards, so each gets about n/shard_count of them
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void ConcurrentHashMap<KEY,T,thash>::reserve(size_type n) {
+  for (int s=0; s<shard_count; ++s) {
+    std::lock_guard<std::mutex> guard(shards[s]->lock);
+    shards[s]->map.reserve(n/shard_count+1);
+  }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class Update>
+T ConcurrentHashMap<KEY,T,thash>::compute(const KEY& key, Update update) {
+  Shard& s = shard_for(key);
+  std::lock_guard<std::mutex> guard(s.lock);
+  T& value = s.map[key];
+  update(value);
+  return value;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class Iterable>
+size_type ConcurrentHashMap<KEY,T,thash>::put_all(const Iterable& i) {
+  if (size_hint(i) != 0)
+    reserve(size()+size_hint(i));
+  size_type count = 0;
+  for (const Entry& m_entry : i) {
+    ++count;
+    put(m_entry.first, m_entry.second);
+  }
+
+  return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::ostream& operator << (std::ostream& outs, const ConcurrentHashMap<KEY,T,thash>& m) {
+  outs << "map[";
+
+  size_type printed = 0;
+  for (const auto& kv : m)
+    outs << (printed++ == 0? "" : ",") << kv.first << "->" << kv.second;
+
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto ConcurrentHashMap<KEY,T,thash>::begin () const -> ConcurrentHashMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<ConcurrentHashMap<KEY,T,thash>*>(this),true);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto ConcurrentHashMap<KEY,T,thash>::end () const -> ConcurrentHashMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<ConcurrentHashMap<KEY,T,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void ConcurrentHashMap<KEY,T,thash>::check_hash (const char* constructor, int (*chash)(const KEY& a)) const {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError(std::string("ConcurrentHashMap::") + constructor + " constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError(std::string("ConcurrentHashMap::") + constructor + " constructor: both specified and different");
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void ConcurrentHashMap<KEY,T,thash>::allocate_shards (int at_least, double the_load_threshold) {
+  for (shard_count = 1, shard_bits = 0; shard_count < at_least && shard_bits < 16; shard_count <<= 1)
+    ++shard_bits;
+
+  shards = new Shard*[shard_count];
+  for (int s=0; s<shard_count; ++s)
+    shards[s] = new Shard(the_load_threshold,hash);
+}
+
+
+//Multiply-shift (as in HashMap::compress), but keeping the top shard_bits of the
+//  high 32 bits: HashMap's compress uses the bottom bits, so a shard's keys still
+//  spread over all of its bins.
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto ConcurrentHashMap<KEY,T,thash>::shard_for (const KEY& key) const -> Shard& {
+  std::uint64_t high = (std::uint64_t(std::uint32_t(hash(key))) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  return *shards[int(high >> (32 - shard_bits))];
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+//Dequeue the current entry; when a shard's copies run out, copy the next non-empty shard's
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void ConcurrentHashMap<KEY,T,thash>::Iterator::advance_cursors(){
+  if (!snapshot.empty())
+    snapshot.dequeue();
+
+  while (snapshot.empty() && ++shard < ref_map->shard_count) {
+    Shard& s = *ref_map->shards[shard];
+    std::lock_guard<std::mutex> guard(s.lock);
+    snapshot.enqueue_all(s.map);
+  }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+ConcurrentHashMap<KEY,T,thash>::Iterator::Iterator(ConcurrentHashMap<KEY,T,thash>* iterate_over, bool from_begin)
+: shard(-1), ref_map(iterate_over) {
+  if (!from_begin)
+    shard = ref_map->shard_count;
+  else
+    advance_cursors();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+ConcurrentHashMap<KEY,T,thash>::Iterator::~Iterator()
+{}
+
+
+//Erases the current entry's key from the map if it is still there (another thread may have erased it)
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto ConcurrentHashMap<KEY,T,thash>::Iterator::erase() -> Entry {
+  if (!can_erase)
+    throw CannotEraseError("ConcurrentHashMap::Iterator::erase Iterator cursor already erased");
+  if (shard == ref_map->shard_count)
+    throw CannotEraseError("ConcurrentHashMap::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  Entry to_return = snapshot.peek();
+  Shard& s = *ref_map->shards[shard];
+  std::lock_guard<std::mutex> guard(s.lock);
+  if (s.map.has_key(to_return.first))
+    s.map.erase(to_return.first);
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string ConcurrentHashMap<KEY,T,thash>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_map->str() << "(shard=" << shard << ",snapshot=" << snapshot.str() << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  ConcurrentHashMap<KEY,T,thash>::Iterator::operator ++ () -> ConcurrentHashMap<KEY,T,thash>::Iterator& {
+  if (shard == ref_map->shard_count)
+    return *this;
+
+  advance_cursors();
+  can_erase = true;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  ConcurrentHashMap<KEY,T,thash>::Iterator::operator ++ (int) -> ConcurrentHashMap<KEY,T,thash>::Iterator {
+  if (shard == ref_map->shard_count)
+    return *this;
+
+  Iterator to_return(*this);
+  advance_cursors();
+  can_erase = true;
+
+  return to_return;
+}
+
+
+//Iterators are equal if they are at the same position in the same shard (both at the end, often)
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool ConcurrentHashMap<KEY,T,thash>::Iterator::operator == (const ConcurrentHashMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("ConcurrentHashMap::Iterator::operator ==");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("ConcurrentHashMap::Iterator::operator ==");
+
+  return this->shard == rhsASI->shard && this->snapshot.size() == rhsASI->snapshot.size();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool ConcurrentHashMap<KEY,T,thash>::Iterator::operator != (const ConcurrentHashMap<KEY,T,thash>::Iterator& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto ConcurrentHashMap<KEY,T,thash>::Iterator::operator *() const -> const Entry& {
+  if (!can_erase || shard == ref_map->shard_count)
+    throw IteratorPositionIllegal("ConcurrentHashMap::Iterator::operator * Iterator illegal");
+
+  return snapshot.peek();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto ConcurrentHashMap<KEY,T,thash>::Iterator::operator ->() const -> const Entry* {
+  if (!can_erase || shard == ref_map->shard_count)
+    throw IteratorPositionIllegal("ConcurrentHashMap::Iterator::operator -> Iterator illegal");
+
+  return &snapshot.peek();
+}
+
+
+}
+
+#endif /* CONCURRENT_HASH_MAP_HPP_ */
@@ -0,0 +1,985 @@
+#ifndef CUCKOO_HASH_MAP_HPP_
+#define CUCKOO_HASH_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <vector>
+#include <utility>              //For std::swap function
+#include <initializer_list>
+#include <algorithm>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "size_hint.hpp"
+#include "ics_hash.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+//A bucketized cuckoo map with the same interface as HashMap: each key may live
+//  in only two buckets of slots entries each, chosen by two different mixes of
+//  its hash code, so a lookup reads at most those two buckets (plus the stash,
+//  which is almost always empty). put kicks an entry out of a full bucket into
+//  its other bucket (and so on, up to max_kicks times); an entry still left
+//  over goes in the stash. A stash holding more than max_stash entries grows
+//  the table, however full it is. Only entries that no table size can place are
+//  not counted: those whose two buckets are already full of keys with the same
+//  hash code (more than 2*slots keys share it), so they stay in the stash.
+//Each slot caches its entry's hash code, compared before keys and reused when
+//  moving entries, so hash is called once per put/lookup.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> class CuckooHashMap {
+  public:
+    typedef ics::pair<KEY,T>   Entry;
+    typedef int (*hashfunc) (const KEY& a);
+
+    //Destructor/Constructors
+    ~CuckooHashMap ();
+
+    CuckooHashMap          (double the_load_threshold = 0.9, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    explicit CuckooHashMap (int initial_bins, double the_load_threshold = 0.9, int (*chash)(const KEY& k) = undefinedhash<KEY>);
+    CuckooHashMap          (const CuckooHashMap<KEY,T,thash>& to_copy, double the_load_threshold = 0.9, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    CuckooHashMap          (CuckooHashMap<KEY,T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
+    explicit CuckooHashMap (const std::initializer_list<Entry>& il, double the_load_threshold = 0.9, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit CuckooHashMap (const Iterable& i, double the_load_threshold = 0.9, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+
+    //Queries
+    bool      empty      () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    bool      has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+    size_type stash_size () const; //# entries in the stash (searched by every lookup when not 0)
+
+    //Heterogeneous lookup: key is a LOOKUP (e.g., StringView for std::string keys), so no KEY
+    //  is built; LOOKUP == KEY must be defined and lookup_hash(key) must equal hash(KEY(key))
+    template <class LOOKUP>
+    bool     has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;
+    template <class LOOKUP>
+    const T& get     (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;  //KeyError if absent, like []
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    put   (const KEY& key, T&& value);
+    T    erase (const KEY& key);
+    void clear ();
+    void reserve (size_type n);   //Grow now, so putting up to n keys never rehashes
+    void rehash  (size_type n);   //Use >= n buckets (fewer if possible, but enough for size() keys)
+
+    //If key is not in the map, put key with the value T(args...); if it is, leave
+    //  its value unchanged (and construct no T). Either way, return key's value.
+    template <class... Args>
+    T&   emplace (const KEY& key, Args&&... args);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    size_type put_all(const Iterable& i);
+
+
+    //Operators
+
+    T&       operator [] (const KEY&);
+    const T& operator [] (const KEY&) const;
+    CuckooHashMap<KEY,T,thash>& operator = (const CuckooHashMap<KEY,T,thash>& rhs);
+    CuckooHashMap<KEY,T,thash>& operator = (CuckooHashMap<KEY,T,thash>&& rhs);   //Swaps contents (and hash) with rhs
+    bool operator == (const CuckooHashMap<KEY,T,thash>& rhs) const;
+    bool operator != (const CuckooHashMap<KEY,T,thash>& rhs) const;
+
+    template<class KEY2,class T2, int (*hash2)(const KEY2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const CuckooHashMap<KEY2,T2,hash2>& m);
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of CuckooHashMap<KEY,T,thash>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        CuckooHashMap<KEY,T,thash>::Iterator& operator ++ ();
+        CuckooHashMap<KEY,T,thash>::Iterator  operator ++ (int);
+        bool operator == (const CuckooHashMap<KEY,T,thash>::Iterator& rhs) const;
+        bool operator != (const CuckooHashMap<KEY,T,thash>::Iterator& rhs) const;
+        Entry& operator *  () const;
+        Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const CuckooHashMap<KEY,T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator CuckooHashMap<KEY,T,thash>::begin () const;
+        friend Iterator CuckooHashMap<KEY,T,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it):
+        //  erasing moves the last entry of a bucket (or the stash) into the erased slot
+        size_type                   current;  //Location (see locate); stop: -1
+        CuckooHashMap<KEY,T,thash>* ref_map;
+        size_type                   expected_mod_count;
+        bool                        can_erase = true;
+
+        //Helper methods
+        void advance_cursors();
+
+        //Called in friends begin/end
+        Iterator(CuckooHashMap<KEY,T,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    static const int slots     = 4;      //Entries per bucket
+    static const int max_kicks = 256;    //Entries moved by one put before using the stash
+    static const int max_stash = 4;      //Stash size (not counting entries no table can place) that grows the table
+    static constexpr double max_load_threshold = 0.95;
+
+
+  private:
+    class Bucket {
+      public:
+        int   count = 0;               //slot[0..count-1] are used
+        int   hash_code[slots] = {};   //hash(slot[i].first), cached
+        Entry slot[slots];
+    };
+
+    class Stashed {
+      public:
+        Stashed () {}
+        Stashed (Entry v, int h) : value(std::move(v)), hash_code(h) {}
+
+        Entry value;
+        int   hash_code = 0;
+    };
+
+    int (*hash)(const KEY& k);    //Hashing function used (from template or constructor)
+    Bucket* map   = nullptr;      //Pointer to array of bins buckets
+    std::vector<Stashed> stash;   //Entries that fit in neither of their buckets
+    double load_threshold;        //used/(bins*slots) <= load_threshold
+    size_type bins      = 1;      //# buckets in array (a power of 2)
+    size_type used      = 0;      //Cache for number of key->value pairs in the hash table
+    size_type mod_count = 0;      //For sensing concurrent modification
+    std::uint32_t kick_state = 1; //xorshift state: picks which entry put kicks out
+
+
+    //Helper methods
+    size_type bucket1          (int hash_code)           const;  //hash_code's two buckets (different when bins > 1)
+    size_type bucket2          (int hash_code)           const;
+    size_type bins_for         (size_type n)             const;  //Fewest buckets (a power of 2) holding n keys within load_threshold
+    template <class LOOKUP>
+    size_type find_key         (const LOOKUP& key, int hash_code) const;  //Returns key's location or -1
+    Entry& entry_at            (size_type location)      const;  //bucket*slots+i: map[bucket].slot[i]; bins*slots+i: stash[i]
+    bool  place                (Entry e, int hash_code);         //Cuckoo insert (key not present); false if it was stashed
+    void  remove_at            (size_type location);             //Move the bucket's (or stash's) last entry into location
+
+    void  allocate_table       (size_type new_bins);             //Allocate empty map of new_bins buckets
+    void  ensure_load_threshold(size_type new_used);             //Reallocate if load_factor > load_threshold
+    size_type stuck_in_stash   ()                        const;  //# stashed entries whose buckets are full of their hash code
+    void  ensure_stash         ();                               //Reallocate until the stash is small enough (see above)
+    void  resize_table         (size_type new_bins);             //Re-place all entries in a new table of new_bins buckets
+    void  delete_table         ();                               //Deallocate map (== nullptr)
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CuckooHashMap class and related definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+constexpr double CuckooHashMap<KEY,T,thash>::max_load_threshold;
+
+
+//Destructor/Constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::~CuckooHashMap() {
+  delete_table();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::CuckooHashMap(double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("CuckooHashMap::default constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("CuckooHashMap::default constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::CuckooHashMap(int initial_bins, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("CuckooHashMap::length constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("CuckooHashMap::length constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  while (bins < initial_bins)
+    bins *= 2;
+  allocate_table(bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::CuckooHashMap(const CuckooHashMap<KEY,T,thash>& to_copy, double the_load_threshold, int (*chash)(const KEY& a))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    hash = to_copy.hash;
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("CuckooHashMap::copy constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  if (hash == to_copy.hash && to_copy.used <= load_threshold*to_copy.bins*slots) {
+    allocate_table(to_copy.bins);
+    std::copy(to_copy.map, to_copy.map+bins, map);
+    stash = to_copy.stash;
+    used  = to_copy.used;
+  }else{
+    allocate_table(bins_for(to_copy.used));
+    for (const Entry& e : to_copy)
+      put(e.first,e.second);
+  }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::CuckooHashMap(CuckooHashMap<KEY,T,thash>&& to_move)
+: hash(to_move.hash), load_threshold(to_move.load_threshold) {
+  allocate_table(bins);        //Becomes to_move's (empty) table after swapping
+  std::swap(map, to_move.map);
+  std::swap(stash,to_move.stash);
+  std::swap(bins,to_move.bins);
+  std::swap(used,to_move.used);
+  ++to_move.mod_count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::CuckooHashMap(const std::initializer_list<Entry>& il, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("CuckooHashMap::initializer_list constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("CuckooHashMap::initializer_list constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(il.size()));
+
+  for (const Entry& m_entry : il)
+    put(m_entry.first,m_entry.second);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class Iterable>
+CuckooHashMap<KEY,T,thash>::CuckooHashMap(const Iterable& i, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("CuckooHashMap::Iterable constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("CuckooHashMap::Iterable constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(size_hint(i)));
+
+  for (const Entry& m_entry : i)
+    put(m_entry.first,m_entry.second);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::empty() const {
+  return used == 0;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type CuckooHashMap<KEY,T,thash>::size() const {
+  return used;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::has_key (const KEY& key) const {
+  return find_key(key,hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::has_value (const T& value) const {
+  for (size_type b=0; b<bins; ++b)
+    for (int i=0; i<map[b].count; ++i)
+      if (value == map[b].slot[i].second)
+        return true;
+  for (const Stashed& s : stash)
+    if (value == s.value.second)
+      return true;
+
+  return false;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string CuckooHashMap<KEY,T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "CuckooHashMap[";
+  if (bins != 0) {
+    answer << std::endl;
+    for (size_type b=0; b<bins; ++b) {
+      answer << "  bucket[" << b << "] = ";
+      for (int i=0; i<map[b].count; ++i)
+        answer << (i == 0 ? "" : ",") << map[b].slot[i].first << "->" << map[b].slot[i].second;
+      answer << std::endl;
+    }
+    answer << "  stash = ";
+    for (size_type i=0; i<size_type(stash.size()); ++i)
+      answer << (i == 0 ? "" : ",") << stash[i].value.first << "->" << stash[i].value.second;
+    answer << std::endl;
+  }
+  answer  << "](load_threshold=" << load_threshold << ",bins=" << bins << ",used=" <<used <<",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type CuckooHashMap<KEY,T,thash>::stash_size() const {
+  return size_type(stash.size());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+bool CuckooHashMap<KEY,T,thash>::has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  return find_key(key,lookup_hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+const T& CuckooHashMap<KEY,T,thash>::get (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  size_type l = find_key(key,lookup_hash(key));
+  if (l != -1)
+    return entry_at(l).second;
+
+  std::ostringstream answer;
+  answer << "CuckooHashMap::get: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T CuckooHashMap<KEY,T,thash>::put(const KEY& key, const T& value) {
+  T to_return;
+  int code = hash(key);
+  size_type l = find_key(key,code);
+  if (l != -1) {
+    to_return = entry_at(l).second;
+    entry_at(l).second = value;
+  }else{
+    to_return = value;
+    ensure_load_threshold(used+1);
+    ++used;
+    if (!place(Entry(key,value),code))
+      ensure_stash();
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T CuckooHashMap<KEY,T,thash>::put(const KEY& key, T&& value) {
+  T to_return;
+  int code = hash(key);
+  size_type l = find_key(key,code);
+  if (l != -1) {
+    to_return = std::move(entry_at(l).second);
+    entry_at(l).second = std::move(value);
+  }else{
+    to_return = value;
+    ensure_load_threshold(used+1);
+    ++used;
+    if (!place(Entry(key,std::move(value)),code))
+      ensure_stash();
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T CuckooHashMap<KEY,T,thash>::erase(const KEY& key) {
+  size_type l = find_key(key,hash(key));
+  if (l == -1) {
+    std::ostringstream answer;
+    answer << "CuckooHashMap::erase: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  T to_return = std::move(entry_at(l).second);
+  remove_at(l);
+
+  --used;
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::clear() {
+  //Keep the bucket array; just empty every bucket
+  for (size_type b=0; b<bins; ++b) {
+    for (int i=0; i<map[b].count; ++i)
+      map[b].slot[i] = Entry();
+    map[b].count = 0;
+  }
+  stash.clear();
+
+  used = 0;
+  ++mod_count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::reserve(size_type n) {
+  if (bins_for(n) > bins)
+    rehash(bins_for(n));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::rehash(size_type n) {
+  size_type new_bins = bins_for(used);
+  while (new_bins < n)
+    new_bins *= 2;
+  ++mod_count;
+  if (new_bins != bins)
+    resize_table(new_bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class Iterable>
+size_type CuckooHashMap<KEY,T,thash>::put_all(const Iterable& i) {
+  reserve(used+size_hint(i));
+  size_type count = 0;
+  for (const Entry& m_entry : i) {
+    ++count;
+    put(m_entry.first, m_entry.second);
+  }
+
+  return count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class... Args>
+T& CuckooHashMap<KEY,T,thash>::emplace(const KEY& key, Args&&... args) {
+  int code = hash(key);
+  size_type l = find_key(key,code);
+  if (l != -1)
+    return entry_at(l).second;
+
+  ensure_load_threshold(used+1);
+  ++used;
+  ++mod_count;
+  if (!place(Entry(key,T(std::forward<Args>(args)...)),code))
+    ensure_stash();
+  return entry_at(find_key(key,code)).second;   //Kicks (or growing) may have moved it
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T& CuckooHashMap<KEY,T,thash>::operator [] (const KEY& key) {
+  int code = hash(key);
+  size_type l = find_key(key,code);
+  if (l != -1)
+    return entry_at(l).second;
+
+  ensure_load_threshold(used+1);
+  ++used;
+  ++mod_count;
+  if (!place(Entry(key,T()),code))
+    ensure_stash();
+  return entry_at(find_key(key,code)).second;   //Kicks (or growing) may have moved it
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const T& CuckooHashMap<KEY,T,thash>::operator [] (const KEY& key) const {
+  size_type l = find_key(key,hash(key));
+  if (l != -1)
+    return entry_at(l).second;
+
+  std::ostringstream answer;
+  answer << "CuckooHashMap::operator []: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>& CuckooHashMap<KEY,T,thash>::operator = (const CuckooHashMap<KEY,T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  if (hash == rhs.hash && rhs.used <= load_threshold*rhs.bins*slots) {
+    delete_table();
+    allocate_table(rhs.bins);
+    std::copy(rhs.map, rhs.map+bins, map);
+    stash = rhs.stash;
+    used  = rhs.used;
+  }else{
+    clear();
+    for (const Entry& e : rhs)
+      put(e.first,e.second);
+  }
+  ++mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>& CuckooHashMap<KEY,T,thash>::operator = (CuckooHashMap<KEY,T,thash>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(hash,          rhs.hash);
+  std::swap(load_threshold,rhs.load_threshold);
+  std::swap(map,           rhs.map);
+  std::swap(stash,         rhs.stash);
+  std::swap(bins,          rhs.bins);
+  std::swap(used,          rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::operator == (const CuckooHashMap<KEY,T,thash>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.size())
+    return false;
+
+  for (const Entry& e : *this) {
+    // Uses ! and ==, so != on T need not be defined
+    size_type rhs_l = rhs.find_key(e.first,rhs.hash(e.first));
+    if (rhs_l == -1 || !(e.second == rhs.entry_at(rhs_l).second))
+      return false;
+  }
+
+  return true;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::operator != (const CuckooHashMap<KEY,T,thash>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::ostream& operator << (std::ostream& outs, const CuckooHashMap<KEY,T,thash>& m) {
+  outs << "map[";
+
+  size_type printed = 0;
+  for (const typename CuckooHashMap<KEY,T,thash>::Entry& e : m)
+    outs << (printed++ == 0? "" : ",") << e.first << "->" << e.second;
+
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto CuckooHashMap<KEY,T,thash>::begin () const -> CuckooHashMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<CuckooHashMap<KEY,T,thash>*>(this),true);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto CuckooHashMap<KEY,T,thash>::end () const -> CuckooHashMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<CuckooHashMap<KEY,T,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Multiply-shift (as in HashMap) for the first bucket; splitmix64's finalizer,
+//  which mixes the code's bits differently, for the second
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type CuckooHashMap<KEY,T,thash>::bucket1 (int hash_code) const {
+  std::uint64_t mixed = (std::uint64_t(std::uint32_t(hash_code)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  return size_type(mixed & std::uint64_t(bins - 1));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type CuckooHashMap<KEY,T,thash>::bucket2 (int hash_code) const {
+  size_type b = size_type(hash_mix(std::uint32_t(hash_code)) & std::uint64_t(bins - 1));
+  return b != bucket1(hash_code) ? b : b ^ (bins > 1 ? 1 : 0);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type CuckooHashMap<KEY,T,thash>::bins_for (size_type n) const {
+  size_type answer = 1;
+  while (n > load_threshold*answer*slots)
+    answer *= 2;
+  return answer;
+}
+
+
+//Reads at most two buckets: all of key's slots are there (or in the stash)
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+size_type CuckooHashMap<KEY,T,thash>::find_key (const LOOKUP& key, int hash_code) const {
+  size_type b = bucket1(hash_code);
+  for (int i=0; i<map[b].count; ++i)
+    if (hash_code == map[b].hash_code[i] && key == map[b].slot[i].first)  //cheap int test first
+      return b*slots+i;
+
+  b = bucket2(hash_code);
+  for (int i=0; i<map[b].count; ++i)
+    if (hash_code == map[b].hash_code[i] && key == map[b].slot[i].first)
+      return b*slots+i;
+
+  for (size_type i=0; i<size_type(stash.size()); ++i)
+    if (hash_code == stash[i].hash_code && key == stash[i].value.first)
+      return bins*slots+i;
+
+  return -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto CuckooHashMap<KEY,T,thash>::entry_at (size_type location) const -> Entry& {
+  if (location >= bins*slots)
+    return const_cast<Entry&>(stash[location-bins*slots].value);
+  return map[location/slots].slot[location%slots];
+}
+
+
+//If both buckets are full, kick a random entry out of one to its other bucket,
+//  and so on: a random walk, which (unlike always kicking the same slot) cannot cycle
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::place (Entry e, int hash_code) {
+  size_type b = bucket1(hash_code);
+  if (map[b].count == slots)
+    b = bucket2(hash_code);
+
+  for (int kicks=0; kicks<=max_kicks; ++kicks) {
+    Bucket& bucket = map[b];
+    if (bucket.count < slots) {
+      bucket.slot[bucket.count]      = std::move(e);
+      bucket.hash_code[bucket.count] = hash_code;
+      ++bucket.count;
+      return true;
+    }
+
+    kick_state ^= kick_state << 13;
+    kick_state ^= kick_state >> 17;
+    kick_state ^= kick_state << 5;
+    int victim = kick_state % slots;
+    std::swap(bucket.slot[victim],e);
+    std::swap(bucket.hash_code[victim],hash_code);
+    b = (b == bucket1(hash_code) ? bucket2(hash_code) : bucket1(hash_code));
+  }
+
+  stash.push_back(Stashed(std::move(e),hash_code));
+  return false;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::remove_at (size_type location) {
+  if (location >= bins*slots) {
+    size_type i = location-bins*slots;
+    if (i != size_type(stash.size())-1)
+      stash[i] = std::move(stash.back());
+    stash.pop_back();
+    return;
+  }
+
+  Bucket& bucket = map[location/slots];
+  int     i      = int(location%slots);
+  int     last   = --bucket.count;
+  if (i != last) {
+    bucket.slot[i]      = std::move(bucket.slot[last]);
+    bucket.hash_code[i] = bucket.hash_code[last];
+  }
+  bucket.slot[last] = Entry();     //release key/value resources held by the vacated slot
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::allocate_table (size_type new_bins) {
+  bins = new_bins;
+  map  = new Bucket[bins];
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::ensure_load_threshold(size_type new_used) {
+  if (new_used <= load_threshold*bins*slots)
+    return;
+
+  resize_table(2*bins);
+}
+
+
+//Growing cannot place these: a key goes only in its two buckets, chosen by its hash code
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type CuckooHashMap<KEY,T,thash>::stuck_in_stash() const {
+  size_type stuck = 0;
+  for (const Stashed& s : stash) {
+    bool full = true;
+    for (size_type b : {bucket1(s.hash_code), bucket2(s.hash_code)})
+      for (int i=0; i<slots && full; ++i)
+        full = i < map[b].count && map[b].hash_code[i] == s.hash_code;
+    stuck += full;
+  }
+  return stuck;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::ensure_stash() {
+  while (size_type(stash.size()) > max_stash && size_type(stash.size())-stuck_in_stash() > max_stash)
+    resize_table(2*bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::resize_table(size_type new_bins) {
+  Bucket*   old_map   = map;
+  size_type old_bins  = bins;
+  std::vector<Stashed> old_stash;
+  std::swap(stash,old_stash);
+
+  allocate_table(new_bins);
+  for (size_type b=0; b<old_bins; ++b)
+    for (int i=0; i<old_map[b].count; ++i)
+      place(std::move(old_map[b].slot[i]),old_map[b].hash_code[i]);
+  for (Stashed& s : old_stash)
+    place(std::move(s.value),s.hash_code);
+
+  delete [] old_map;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::delete_table () {
+  delete[] map;
+  map = nullptr;
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+//Locations run through every bucket's slots, then the stash
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void CuckooHashMap<KEY,T,thash>::Iterator::advance_cursors(){
+  size_type table_end = ref_map->bins*slots;
+  for (size_type l = current+1; l < table_end; ++l)
+    if (l%slots < ref_map->map[l/slots].count) {
+      current = l;
+      return;
+    }
+    else
+      l = (l/slots+1)*slots-1;    //Skip the rest of this bucket's (empty) slots
+
+  size_type in_stash = std::max(current+1,table_end)-table_end;
+  current = (in_stash < size_type(ref_map->stash.size()) ? table_end+in_stash : -1);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::Iterator::Iterator(CuckooHashMap<KEY,T,thash>* iterate_over, bool from_begin)
+: current(-1), ref_map(iterate_over), expected_mod_count(ref_map->mod_count) {
+  if (from_begin)
+    advance_cursors();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+CuckooHashMap<KEY,T,thash>::Iterator::~Iterator()
+{}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto CuckooHashMap<KEY,T,thash>::Iterator::erase() -> Entry {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("CuckooHashMap::Iterator::erase Iterator cursor already erased");
+  if (current == -1)
+    throw CannotEraseError("CuckooHashMap::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  Entry to_return = std::move(ref_map->entry_at(current));
+  ref_map->remove_at(current);
+
+  --ref_map->used;
+  ++ref_map->mod_count;
+  expected_mod_count = ref_map->mod_count;
+
+  //A later entry may have moved into current; if not, move on to the next one now
+  size_type table_end = ref_map->bins*slots;
+  bool      filled    = (current < table_end ? current%slots < ref_map->map[current/slots].count
+                                             : current-table_end < size_type(ref_map->stash.size()));
+  if (!filled)
+    advance_cursors();
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string CuckooHashMap<KEY,T,thash>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_map->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  CuckooHashMap<KEY,T,thash>::Iterator::operator ++ () -> CuckooHashMap<KEY,T,thash>::Iterator& {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::operator ++");
+
+  if (current == -1)
+    return *this;
+
+  if (can_erase)
+    advance_cursors();
+
+  can_erase = true;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  CuckooHashMap<KEY,T,thash>::Iterator::operator ++ (int) -> CuckooHashMap<KEY,T,thash>::Iterator {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::operator ++(int)");
+
+  if (current == -1)
+    return *this;
+
+  Iterator to_return(*this);
+  if (can_erase)
+    advance_cursors();
+  can_erase = true;
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::Iterator::operator == (const CuckooHashMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("CuckooHashMap::Iterator::operator ==");
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::operator ==");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("CuckooHashMap::Iterator::operator ==");
+
+  return this->current == rhsASI->current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool CuckooHashMap<KEY,T,thash>::Iterator::operator != (const CuckooHashMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("CuckooHashMap::Iterator::operator !=");
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::operator !=");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("CuckooHashMap::Iterator::operator !=");
+
+  return this->current != rhsASI->current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+pair<KEY,T>& CuckooHashMap<KEY,T,thash>::Iterator::operator *() const {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::operator *");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("CuckooHashMap::Iterator::operator * Iterator illegal");
+
+  return ref_map->entry_at(current);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+pair<KEY,T>* CuckooHashMap<KEY,T,thash>::Iterator::operator ->() const {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("CuckooHashMap::Iterator::operator ->");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("CuckooHashMap::Iterator::operator -> Iterator illegal");
+
+  return &(ref_map->entry_at(current));
+}
+
+
+}
+
+#endif /* CUCKOO_HASH_MAP_HPP_ */
@@ -0,0 +1,889 @@
+#ifndef DENSE_HASH_MAP_HPP_
+#define DENSE_HASH_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <utility>              //For std::swap function
+#include <initializer_list>
+#include <algorithm>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+//A map with the same interface as HashMap that remembers insertion order (like
+//  Python's dict): entries are appended to one flat array (dense), and a separate
+//  index array of ints, probed linearly, holds the dense slot number of each key.
+//  Iteration, has_value, <<, and == sweep dense front to back, so they read memory
+//  sequentially and see the entries in the order their keys were first put.
+//erase leaves a hole in dense (and a DELETED marker in index); holes are squeezed
+//  out when index is rebuilt, or by erase once they outnumber the entries.
+//dense has room for load_threshold*bins entries, so at least one index slot stays
+//  EMPTY and a probe always stops: load_threshold is limited to max_load_threshold.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> class DenseHashMap {
+  public:
+    typedef ics::pair<KEY,T>   Entry;
+    typedef int (*hashfunc) (const KEY& a);
+
+    //Destructor/Constructors
+    ~DenseHashMap ();
+
+    DenseHashMap          (double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    explicit DenseHashMap (int initial_bins, double the_load_threshold = 0.75, int (*chash)(const KEY& k) = undefinedhash<KEY>);
+    DenseHashMap          (const DenseHashMap<KEY,T,thash>& to_copy, double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    DenseHashMap          (DenseHashMap<KEY,T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
+    explicit DenseHashMap (const std::initializer_list<Entry>& il, double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit DenseHashMap (const Iterable& i, double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+
+    //Queries
+    bool      empty      () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    bool      has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Heterogeneous lookup: key is a LOOKUP (e.g., StringView for std::string keys), so no KEY
+    //  is built; LOOKUP == KEY must be defined and lookup_hash(key) must equal hash(KEY(key))
+    template <class LOOKUP>
+    bool     has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;
+    template <class LOOKUP>
+    const T& get     (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;  //KeyError if absent, like []
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);   //A new key goes last in the order; an old key keeps its place
+    T    put   (const KEY& key, T&& value);
+    T    erase (const KEY& key);
+    void clear ();
+    void reserve (size_type n);   //Grow now, so putting up to n keys never rebuilds index
+    void rehash  (size_type n);   //Use >= n index slots (fewer if possible, but enough for size() keys); removes holes
+    void shrink_to_fit ();  //Fewest index slots (and dense entries) holding size() keys
+
+    //If key is not in the map, put key with the value T(args...); if it is, leave
+    //  its value unchanged (and construct no T). Either way, return key's value.
+    template <class... Args>
+    T&   emplace (const KEY& key, Args&&... args);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    size_type put_all(const Iterable& i);
+
+
+    //Operators
+
+    T&       operator [] (const KEY&);
+    const T& operator [] (const KEY&) const;
+    DenseHashMap<KEY,T,thash>& operator = (const DenseHashMap<KEY,T,thash>& rhs);
+    DenseHashMap<KEY,T,thash>& operator = (DenseHashMap<KEY,T,thash>&& rhs);   //Swaps contents (and hash) with rhs
+    bool operator == (const DenseHashMap<KEY,T,thash>& rhs) const;            //Same entries; order is irrelevant
+    bool operator != (const DenseHashMap<KEY,T,thash>& rhs) const;
+
+    template<class KEY2,class T2, int (*hash2)(const KEY2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const DenseHashMap<KEY2,T2,hash2>& m);
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of DenseHashMap<KEY,T,thash>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        DenseHashMap<KEY,T,thash>::Iterator& operator ++ ();
+        DenseHashMap<KEY,T,thash>::Iterator  operator ++ (int);
+        bool operator == (const DenseHashMap<KEY,T,thash>::Iterator& rhs) const;
+        bool operator != (const DenseHashMap<KEY,T,thash>::Iterator& rhs) const;
+        Entry& operator *  () const;
+        Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const DenseHashMap<KEY,T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator DenseHashMap<KEY,T,thash>::begin () const;
+        friend Iterator DenseHashMap<KEY,T,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
+        size_type                  current;  //dense slot (insertion order); stop: -1
+        DenseHashMap<KEY,T,thash>* ref_map;
+        size_type                  expected_mod_count;
+        bool                       can_erase = true;
+
+        //Helper methods
+        void advance_cursors();
+
+        //Called in friends begin/end
+        Iterator(DenseHashMap<KEY,T,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    static constexpr double max_load_threshold = 0.9;  //Must be < 1: probing stops only at an EMPTY index slot
+
+
+  private:
+    class DN {
+      public:
+        Entry value;
+        int   hash_code = 0;      //hash(value.first), cached: compared before keys and reused when index is rebuilt
+        bool  erased    = false;  //A hole left by erase: value is Entry() and no index slot refers to it
+    };
+
+    static const size_type EMPTY   = -1;  //index slot never used since index was built: a probe stops here
+    static const size_type DELETED = -2;  //index slot whose entry was erased: a probe continues past it
+
+    int (*hash)(const KEY& k);  //Hashing function used (from template or constructor)
+    DN*        dense = nullptr; //Entries in insertion order (holes where erased); room for capacity()
+    size_type* index = nullptr; //bins slots: a dense slot number, EMPTY, or DELETED
+    double load_threshold;      //filled/bins <= load_threshold
+    size_type bins      = 1;    //# slots in index (a power of 2)
+    size_type filled    = 0;    //dense[0..filled-1] are entries or holes
+    size_type used      = 0;    //Cache for number of key->value pairs in the hash table (filled - # holes)
+    size_type mod_count = 0;    //For sensing concurrent modification
+
+
+    //Helper methods
+    size_type compress         (int hash_code)           const;  //hash code (already computed) ranged to [0,bins-1]; bins is a power of 2
+    size_type capacity         ()                        const;  //# entries (and holes) dense holds: load_threshold*bins
+    size_type bins_for         (size_type n)             const;  //Fewest index slots (a power of 2) with capacity() >= n
+    template <class LOOKUP>
+    size_type find_key         (const LOOKUP& key, int hash_code) const;  //Returns index slot of key's dense slot or -1
+    size_type append           (Entry e, int hash_code);         //Put e (key not present) last; returns its dense slot
+    void  erase_slot           (size_type slot);                 //Make dense[index[slot]] a hole; index[slot] DELETED
+
+    void  allocate_table       (size_type new_bins);             //Allocate empty dense/index for new_bins slots
+    void  ensure_capacity      (size_type new_filled);           //Rebuild if dense has no room for new_filled entries
+    void  resize_table         (size_type new_bins);             //Move entries (in order, without holes) to new dense/index
+    void  delete_table         ();                               //Deallocate dense/index (both == nullptr)
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DenseHashMap class and related definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+constexpr double DenseHashMap<KEY,T,thash>::max_load_threshold;
+
+
+//Destructor/Constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::~DenseHashMap() {
+  delete_table();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::DenseHashMap(double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("DenseHashMap::default constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("DenseHashMap::default constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::DenseHashMap(int initial_bins, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("DenseHashMap::length constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("DenseHashMap::length constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  while (bins < initial_bins)
+    bins *= 2;
+  allocate_table(bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::DenseHashMap(const DenseHashMap<KEY,T,thash>& to_copy, double the_load_threshold, int (*chash)(const KEY& a))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    hash = to_copy.hash;
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("DenseHashMap::copy constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(to_copy.used));
+  for (size_type d=0; d<to_copy.filled; ++d)
+    if (!to_copy.dense[d].erased) {
+      const Entry& e = to_copy.dense[d].value;
+      append(e, hash == to_copy.hash ? to_copy.dense[d].hash_code : hash(e.first));
+    }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::DenseHashMap(DenseHashMap<KEY,T,thash>&& to_move)
+: hash(to_move.hash), load_threshold(to_move.load_threshold) {
+  allocate_table(bins);        //Becomes to_move's (empty) table after swapping
+  std::swap(dense, to_move.dense);
+  std::swap(index, to_move.index);
+  std::swap(bins,  to_move.bins);
+  std::swap(filled,to_move.filled);
+  std::swap(used,  to_move.used);
+  ++to_move.mod_count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::DenseHashMap(const std::initializer_list<Entry>& il, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("DenseHashMap::initializer_list constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("DenseHashMap::initializer_list constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(il.size()));
+
+  for (const Entry& m_entry : il)
+    put(m_entry.first,m_entry.second);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class Iterable>
+DenseHashMap<KEY,T,thash>::DenseHashMap(const Iterable& i, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("DenseHashMap::Iterable constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("DenseHashMap::Iterable constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(size_hint(i)));
+
+  for (const Entry& m_entry : i)
+    put(m_entry.first,m_entry.second);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::empty() const {
+  return used == 0;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type DenseHashMap<KEY,T,thash>::size() const {
+  return used;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::has_key (const KEY& key) const {
+  return find_key(key,hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::has_value (const T& value) const {
+  for (size_type d=0; d<filled; ++d)
+    if (!dense[d].erased && value == dense[d].value.second)
+      return true;
+
+  return false;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string DenseHashMap<KEY,T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "DenseHashMap[";
+  if (bins != 0) {
+    answer << std::endl;
+    for (size_type s=0; s<bins; ++s) {
+      answer << "  index[" << s << "] = ";
+      if (index[s] == EMPTY)
+        answer << "EMPTY" << std::endl;
+      else if (index[s] == DELETED)
+        answer << "DELETED" << std::endl;
+      else
+        answer << index[s] << std::endl;
+    }
+    for (size_type d=0; d<filled; ++d) {
+      answer << "  dense[" << d << "] = ";
+      if (dense[d].erased)
+        answer << "ERASED" << std::endl;
+      else
+        answer << dense[d].value.first << "->" << dense[d].value.second << " (hash=" << dense[d].hash_code << ")" << std::endl;
+    }
+  }
+  answer  << "](load_threshold=" << load_threshold << ",bins=" << bins << ",filled=" << filled << ",used=" <<used <<",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+bool DenseHashMap<KEY,T,thash>::has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  return find_key(key,lookup_hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+const T& DenseHashMap<KEY,T,thash>::get (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  size_type s = find_key(key,lookup_hash(key));
+  if (s != -1)
+    return dense[index[s]].value.second;
+
+  std::ostringstream answer;
+  answer << "DenseHashMap::get: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T DenseHashMap<KEY,T,thash>::put(const KEY& key, const T& value) {
+  T to_return;
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1) {
+    to_return = dense[index[s]].value.second;
+    dense[index[s]].value.second = value;
+  }else{
+    to_return = value;
+    ensure_capacity(filled+1);
+    append(Entry(key,value),code);
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T DenseHashMap<KEY,T,thash>::put(const KEY& key, T&& value) {
+  T to_return;
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1) {
+    to_return = std::move(dense[index[s]].value.second);
+    dense[index[s]].value.second = std::move(value);
+  }else{
+    to_return = value;
+    ensure_capacity(filled+1);
+    append(Entry(key,std::move(value)),code);
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T DenseHashMap<KEY,T,thash>::erase(const KEY& key) {
+  size_type s = find_key(key,hash(key));
+  if (s == -1) {
+    std::ostringstream answer;
+    answer << "DenseHashMap::erase: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  T to_return = std::move(dense[index[s]].value.second);
+  erase_slot(s);
+  ++mod_count;
+
+  //Squeezing out the holes costs O(filled), paid for by the > filled/2 erases that made them
+  if (filled-used > used)
+    resize_table(bins);
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::clear() {
+  //Keep the arrays; just empty them
+  for (size_type d=0; d<filled; ++d)
+    dense[d] = DN();
+  for (size_type s=0; s<bins; ++s)
+    index[s] = EMPTY;
+
+  filled = 0;
+  used   = 0;
+  ++mod_count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::reserve(size_type n) {
+  if (bins_for(n) > bins)
+    rehash(bins_for(n));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::rehash(size_type n) {
+  size_type new_bins = bins_for(used);
+  while (new_bins < n)
+    new_bins *= 2;
+  ++mod_count;
+  if (new_bins != bins || filled != used)
+    resize_table(new_bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::shrink_to_fit() {
+  rehash(0);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class Iterable>
+size_type DenseHashMap<KEY,T,thash>::put_all(const Iterable& i) {
+  reserve(used+size_hint(i));
+  size_type count = 0;
+  for (const Entry& m_entry : i) {
+    ++count;
+    put(m_entry.first, m_entry.second);
+  }
+
+  return count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class... Args>
+T& DenseHashMap<KEY,T,thash>::emplace(const KEY& key, Args&&... args) {
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1)
+    return dense[index[s]].value.second;
+
+  ensure_capacity(filled+1);
+  ++mod_count;
+  return dense[append(Entry(key,T(std::forward<Args>(args)...)),code)].value.second;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T& DenseHashMap<KEY,T,thash>::operator [] (const KEY& key) {
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1)
+    return dense[index[s]].value.second;
+
+  ensure_capacity(filled+1);
+  ++mod_count;
+  return dense[append(Entry(key,T()),code)].value.second;   //dense may have moved in ensure_capacity!
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const T& DenseHashMap<KEY,T,thash>::operator [] (const KEY& key) const {
+  size_type s = find_key(key,hash(key));
+  if (s != -1)
+    return dense[index[s]].value.second;
+
+  std::ostringstream answer;
+  answer << "DenseHashMap::operator []: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>& DenseHashMap<KEY,T,thash>::operator = (const DenseHashMap<KEY,T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  hash = rhs.hash;
+  delete_table();
+  allocate_table(bins_for(rhs.used));
+  for (size_type d=0; d<rhs.filled; ++d)
+    if (!rhs.dense[d].erased)
+      append(rhs.dense[d].value,rhs.dense[d].hash_code);
+  ++mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>& DenseHashMap<KEY,T,thash>::operator = (DenseHashMap<KEY,T,thash>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(hash,          rhs.hash);
+  std::swap(load_threshold,rhs.load_threshold);
+  std::swap(dense,         rhs.dense);
+  std::swap(index,         rhs.index);
+  std::swap(bins,          rhs.bins);
+  std::swap(filled,        rhs.filled);
+  std::swap(used,          rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::operator == (const DenseHashMap<KEY,T,thash>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.size())
+    return false;
+
+  for (size_type d=0; d<filled; ++d)
+    if (!dense[d].erased) {
+      // Uses ! and ==, so != on T need not be defined
+      const Entry& e = dense[d].value;
+      size_type rhs_s = rhs.find_key(e.first, hash == rhs.hash ? dense[d].hash_code : rhs.hash(e.first));
+      if (rhs_s == -1 || !(e.second == rhs.dense[rhs.index[rhs_s]].value.second))
+        return false;
+    }
+
+  return true;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::operator != (const DenseHashMap<KEY,T,thash>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::ostream& operator << (std::ostream& outs, const DenseHashMap<KEY,T,thash>& m) {
+  outs << "map[";
+
+  size_type printed = 0;
+  for (size_type d=0; d<m.filled; ++d)
+    if (!m.dense[d].erased)
+      outs << (printed++ == 0? "" : ",") << m.dense[d].value.first << "->" << m.dense[d].value.second;
+
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto DenseHashMap<KEY,T,thash>::begin () const -> DenseHashMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<DenseHashMap<KEY,T,thash>*>(this),true);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto DenseHashMap<KEY,T,thash>::end () const -> DenseHashMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<DenseHashMap<KEY,T,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type DenseHashMap<KEY,T,thash>::compress (int hash_code) const {
+  //Multiply-shift (as in HashMap): masking then picks a slot even if only high bits vary
+  std::uint64_t mixed = (std::uint64_t(std::uint32_t(hash_code)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  return size_type(mixed & std::uint64_t(bins - 1));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type DenseHashMap<KEY,T,thash>::capacity () const {
+  return size_type(bins*load_threshold);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type DenseHashMap<KEY,T,thash>::bins_for (size_type n) const {
+  size_type answer = 1;
+  while (size_type(answer*load_threshold) < n)
+    answer *= 2;
+  return answer;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+size_type DenseHashMap<KEY,T,thash>::find_key (const LOOKUP& key, int hash_code) const {
+  for (size_type s = compress(hash_code); index[s] != EMPTY; s = (s+1) & (bins-1))
+    if (index[s] != DELETED) {
+      const DN& n = dense[index[s]];
+      if (hash_code == n.hash_code && key == n.value.first)  //cheap int test first
+        return s;
+    }
+
+  return -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type DenseHashMap<KEY,T,thash>::append (Entry e, int hash_code) {
+  size_type s = compress(hash_code);
+  while (index[s] != EMPTY)
+    s = (s+1) & (bins-1);
+
+  size_type d = filled++;
+  dense[d].value     = std::move(e);
+  dense[d].hash_code = hash_code;
+  dense[d].erased    = false;
+  index[s] = d;
+  ++used;
+  return d;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::erase_slot (size_type slot) {
+  dense[index[slot]] = DN();    //release key/value resources held by the hole
+  dense[index[slot]].erased = true;
+  index[slot] = DELETED;
+  --used;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::allocate_table (size_type new_bins) {
+  bins   = new_bins;
+  filled = 0;
+  used   = 0;
+  dense  = new DN[std::max(size_type(1),capacity())];
+  index  = new size_type[bins];
+  for (size_type s=0; s<bins; ++s)
+    index[s] = EMPTY;
+}
+
+
+//Rebuilding for twice the entries (not counting holes) leaves room to put
+//  at least used+1 more before rebuilding again
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::ensure_capacity(size_type new_filled) {
+  if (new_filled <= capacity())
+    return;
+
+  resize_table(bins_for(2*(new_filled-(filled-used))));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::resize_table(size_type new_bins) {
+  DN*       old_dense  = dense;
+  size_type old_filled = filled;
+
+  delete[] index;
+  allocate_table(new_bins);
+  for (size_type d=0; d<old_filled; ++d)
+    if (!old_dense[d].erased)
+      append(std::move(old_dense[d].value),old_dense[d].hash_code);
+
+  delete [] old_dense;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::delete_table () {
+  delete[] dense;
+  delete[] index;
+  dense = nullptr;
+  index = nullptr;
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void DenseHashMap<KEY,T,thash>::Iterator::advance_cursors(){
+  for (size_type d = current+1; d < ref_map->filled; ++d)
+    if (!ref_map->dense[d].erased) {
+      current = d;
+      return;
+    }
+
+  current = -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::Iterator::Iterator(DenseHashMap<KEY,T,thash>* iterate_over, bool from_begin)
+: current(-1), ref_map(iterate_over), expected_mod_count(ref_map->mod_count) {
+  if (from_begin)
+    advance_cursors();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+DenseHashMap<KEY,T,thash>::Iterator::~Iterator()
+{}
+
+
+//Leaves a hole (as erase does) but never squeezes the holes out, so no entry moves
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto DenseHashMap<KEY,T,thash>::Iterator::erase() -> Entry {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("DenseHashMap::Iterator::erase Iterator cursor already erased");
+  if (current == -1)
+    throw CannotEraseError("DenseHashMap::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  DN&       n         = ref_map->dense[current];
+  Entry     to_return = std::move(n.value);
+  size_type s         = ref_map->compress(n.hash_code);
+  while (ref_map->index[s] != current)
+    s = (s+1) & (ref_map->bins-1);
+  ref_map->erase_slot(s);
+
+  ++ref_map->mod_count;
+  expected_mod_count = ref_map->mod_count;
+  advance_cursors();
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string DenseHashMap<KEY,T,thash>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_map->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  DenseHashMap<KEY,T,thash>::Iterator::operator ++ () -> DenseHashMap<KEY,T,thash>::Iterator& {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::operator ++");
+
+  if (current == -1)
+    return *this;
+
+  if (can_erase)
+    advance_cursors();
+
+  can_erase = true;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  DenseHashMap<KEY,T,thash>::Iterator::operator ++ (int) -> DenseHashMap<KEY,T,thash>::Iterator {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::operator ++(int)");
+
+  if (current == -1)
+    return *this;
+
+  Iterator to_return(*this);
+  if (can_erase)
+    advance_cursors();
+  can_erase = true;
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::Iterator::operator == (const DenseHashMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("DenseHashMap::Iterator::operator ==");
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::operator ==");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("DenseHashMap::Iterator::operator ==");
+
+  return this->current == rhsASI->current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool DenseHashMap<KEY,T,thash>::Iterator::operator != (const DenseHashMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("DenseHashMap::Iterator::operator !=");
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::operator !=");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("DenseHashMap::Iterator::operator !=");
+
+  return this->current != rhsASI->current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+pair<KEY,T>& DenseHashMap<KEY,T,thash>::Iterator::operator *() const {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::operator *");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("DenseHashMap::Iterator::operator * Iterator illegal");
+
+  return ref_map->dense[current].value;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+pair<KEY,T>* DenseHashMap<KEY,T,thash>::Iterator::operator ->() const {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("DenseHashMap::Iterator::operator ->");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("DenseHashMap::Iterator::operator -> Iterator illegal");
+
+  return &(ref_map->dense[current].value);
+}
+
+
+}
+
+#endif /* DENSE_HASH_MAP_HPP_ */
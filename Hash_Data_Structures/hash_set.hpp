@@ -4,9 +4,21 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <initializer_list>
+#include <utility>
+#include <vector>
+#include <thread>
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
+#include "node_pool.hpp"
+#include "size_hint.hpp"
+#include "bloom_filter.hpp"
+#include "hash_stats.hpp"
+#include "prefetch.hpp"
+#include "parallel.hpp"
 
 // Submitter jpascasc(Pascascio, Joshua)
 namespace ics {
@@ -33,6 +45,7 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
     HashSet (double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
     explicit HashSet (int initial_bins, double the_load_threshold = 1.0, int (*chash)(const T& k) = undefinedhash<T>);
     HashSet (const HashSet<T,thash>& to_copy, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
+    HashSet (HashSet<T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
     explicit HashSet (const std::initializer_list<T>& il, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -41,10 +54,21 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    bool contains   (const T& element) const;
+    bool      empty      () const;
+    size_type size       () const;
+    bool      contains   (const T& element) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
+    HashStats   stats () const; //Chain lengths, rehashes, and probes per search (see hash_stats.hpp): for big tables
+
+    //Heterogeneous lookup: element is a LOOKUP (e.g., StringView for std::string elements), so no T
+    //  is built; LOOKUP == T must be defined and lookup_hash(element) must equal hash(T(element))
+    template <class LOOKUP>
+    bool contains   (const LOOKUP& element, int (*lookup_hash)(const LOOKUP& e)) const;
+
+    //Batched membership test of elements[0..n-1]: each batch is hashed and its bins prefetched
+    //  before any is searched (see prefetch.hpp), so for many elements it beats contains in a loop.
+    //  found[i] is contains(elements[i]); returns the # of elements found
+    size_type contains_many (const T elements[], size_type n, bool found[]) const;
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
@@ -52,24 +76,64 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
 
 
     //Commands
-    int  insert (const T& element);
-    int  erase  (const T& element);
-    void clear  ();
+    int       insert (const T& element);
+    int       insert (T&& element);
+    int       erase  (const T& element);
+    void      clear  ();
+    void      reserve(size_type n);   //Grow now, so inserting up to n elements never rehashes (and erase never shrinks the table below that)
+    void      rehash (size_type n);   //Use >= n bins (fewer if possible, but enough for size() elements)
+    void      shrink_to_fit ();  //Fewest bins holding size() elements (erase/clear shrink only below load_threshold/4; undoes reserve)
+    void      clear_stats ();    //Restart counting the rehashes and probes reported by stats()
+
+    //A BloomFilter (off by default) rejects most absent elements before any bin is searched:
+    //  turn it on when most contains/insert calls are for absent elements
+    void use_bloom_filter (bool on = true);
+    const BloomFilter* bloom_filter () const;   //nullptr when off; has the false_positive_rate
+
+    //Insert T(args...)
+    template <class... Args>
+    int  emplace (Args&&... args);
 
     //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
 
     template <class Iterable>
-    int insert_all(const Iterable& i);
+    size_type insert_all(const Iterable& i);
+
+    //Inserts each element in [begin,end) like insert_all does, but on threads threads (0 means
+    //  hardware_concurrency; fewer for few elements): elements are hashed in parallel and grouped
+    //  by the range of bins each thread owns, then each thread links the nodes into its own bins,
+    //  with no locking. hash, T's ==, and T's copy constructor are called on several threads at once.
+    //  Returns the # of elements inserted
+    template <class Iter>
+    size_type build_parallel(Iter begin, Iter end, int threads = 0);
 
     template <class Iterable>
-    int erase_all(const Iterable& i);
+    size_type erase_all(const Iterable& i);
 
     template<class Iterable>
-    int retain_all(const Iterable& i);
+    size_type retain_all(const Iterable& i);
+    size_type retain_all(const HashSet<T,thash>& s);   //Looks up in s directly: builds no copy of it
+
+    //Set algebra: iterates the smaller operand when the result allows it (and both use the same
+    //  hash), sizes the result once, reuses the hash codes cached in the nodes, and copies no operand
+    HashSet<T,thash>  operator |  (const HashSet<T,thash>& rhs) const;   //union
+    HashSet<T,thash>  operator &  (const HashSet<T,thash>& rhs) const;   //intersection
+    HashSet<T,thash>  operator -  (const HashSet<T,thash>& rhs) const;   //difference
+    HashSet<T,thash>  operator ^  (const HashSet<T,thash>& rhs) const;   //symmetric difference
+    HashSet<T,thash>& operator |= (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator &= (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator -= (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator ^= (const HashSet<T,thash>& rhs);
+
+    //The same as & and -, but each of threads (0 means hardware_concurrency) threads fills a
+    //  disjoint range of the result's bins; fewer threads are used for small sets
+    HashSet<T,thash> parallel_intersection (const HashSet<T,thash>& rhs, int threads = 0) const;
+    HashSet<T,thash> parallel_difference   (const HashSet<T,thash>& rhs, int threads = 0) const;
 
 
     //Operators
     HashSet<T,thash>& operator = (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator = (HashSet<T,thash>&& rhs);   //Swaps contents (and hash) with rhs
     bool operator == (const HashSet<T,thash>& rhs) const;
     bool operator != (const HashSet<T,thash>& rhs) const;
     bool operator <= (const HashSet<T,thash>& rhs) const;
@@ -88,7 +152,7 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
   public:
     class Iterator {
       public:
-        typedef pair<int,LN*> Cursor;
+        typedef pair<size_type,LN*> Cursor;
 
         //Private constructor called in begin/end, which are friends of HashSet<T,thash>
         ~Iterator();
@@ -111,7 +175,7 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
         Cursor              current; //Bin Index + LN* pointer; stops if LN* == nullptr
         HashSet<T,thash>*   ref_set;
-        int                 expected_mod_count;
+        size_type           expected_mod_count;
         bool                can_erase = true;
 
         //Helper methods
@@ -127,13 +191,15 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
 
 
   private:
-    class LN {
+    class LN : public PoolAllocated {
       public:
-        LN ()                      {}
-        LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+        LN ()                             {}
+        LN (const LN& ln)                 : value(ln.value), hash_code(ln.hash_code), next(ln.next){}
+        LN (T v, int h, LN* n = nullptr)  : value(std::move(v)), hash_code(h), next(n){}
+        LN& operator = (LN&& ln) = default;
 
         T   value;
+        int hash_code = 0;        //hash(value), cached: compared before values and reused when rehashing
         LN* next   = nullptr;
     };
 
@@ -142,19 +208,42 @@ public:
 private:
   LN** set      = nullptr;   //Pointer to array of pointers: each bin stores a list with a trailer node
   double load_threshold;     //used/bins <= load_threshold
-  int bins      = 1;         //# bins in array (should start >= 1 so hash_compress doesn't divide by 0)
-  int used      = 0;         //Cache for number of key->value pairs in the hash table
-  int mod_count = 0;         //For sensing concurrent modification
+  size_type bins      = 1;   //# bins in array (should start >= 1 so compress doesn't divide by 0)
+  size_type used      = 0;   //Cache for number of key->value pairs in the hash table
+  size_type mod_count = 0;   //For sensing concurrent modification
+  size_type reserved_bins = 1;  //reserve()'s bins: erase never shrinks below them; shrink_to_fit/clear reset it
+  BloomFilter* bloom = nullptr;  //If not nullptr: has the hash_code of every element (and maybe erased ones)
+  size_type rehashes  = 0;   //For stats(): # times elements were moved to a table with a different # of bins
+  ProbeCounter probes;       //For stats(): searches and the elements they compared
 
+  static const size_type parallel_grain = 4096;   //Fewest elements worth starting another thread for
 
   //Helper methods
-  int   hash_compress        (const T& key)              const;  //hash function ranged to [0,bins-1]
-  LN*   find_element         (const T& element)          const;  //Returns reference to element's node or nullptr
-  LN*   copy_list            (LN*   l)                   const;  //Copy the elements in a bin (order irrelevant)
-  LN**  copy_hash_table      (LN** ht, int bins)         const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
-
-  void  ensure_load_threshold(int new_used);                     //Reallocate if load_threshold > load_threshold
-  void  delete_hash_table    (LN**& ht, int bins);               //Deallocate all LN in ht (and the ht itself; ht == nullptr)
+  int       call_hash            (const T& element)          const;  //thash(element) if given (a direct call: inlinable), else hash(element)
+  size_type compress             (int hash_code)             const;  //hash code (already computed) ranged to [0,bins-1]; bins is a power of 2
+  static size_type power_of_2_bins (size_type at_least);             //Smallest power of 2 >= at_least (at least 1)
+  size_type bins_for             (size_type n)               const;  //Fewest bins (a power of 2) holding n elements within load_threshold
+  template <class LOOKUP>
+  LN*       find_element         (const LOOKUP& element, int hash_code) const;  //Returns reference to element's node or nullptr
+  LN*       copy_list            (LN*   l)                   const;  //Copy the elements in a bin (order irrelevant)
+  LN**      copy_hash_table      (LN** ht, size_type bins)   const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
+  bool      contains_node        (const HashSet<T,thash>& from, const LN* n) const;  //n (a node of from) is in this set; no rehashing if same hash
+  bool      all_in               (const HashSet<T,thash>& s) const;  //Every element is in s
+  HashSet<T,thash> filter        (const HashSet<T,thash>& s, bool in_s, int threads) const;  //Elements whose s.contains is in_s (same bins)
+
+  int       insert_hashed        (const T& element, int hash_code);  //insert, with hash_code == hash(element)
+  int       erase_hashed         (const T& element, int hash_code);  //erase, with hash_code == hash(element)
+  size_type erase_where          (const HashSet<T,thash>& s, bool in_s);  //Erase elements whose s.contains is in_s
+
+  void  bloom_insert         (int hash_code);                    //Record a new element in bloom (if any)
+  void  bloom_erase          (size_type count);                  //Record erased elements; rebuild bloom if stale
+  void  rebuild_bloom        ();                                 //Reset bloom for 2*used elements and insert all
+
+  void  ensure_load_threshold(size_type new_used);               //Reallocate if load_threshold > load_threshold
+  void  ensure_load_threshold_low(size_type new_used);           //Reallocate if load_factor < load_threshold/4
+  void  grow_for             (size_type n);                      //Grow now to hold n elements: reserve without raising reserved_bins
+  void  resize_table         (size_type new_bins);               //Move all elements into a new table with new_bins bins
+  void  delete_hash_table    (LN**& ht, size_type bins);         //Deallocate all LN in ht (and the ht itself; ht == nullptr)
 };
 
 
@@ -170,6 +259,7 @@ private:
 template<class T, int (*thash)(const T& a)>
 HashSet<T,thash>::~HashSet() {
     delete_hash_table(set,bins);
+    delete bloom;
 }
 
 
@@ -197,8 +287,7 @@ HashSet<T,thash>::HashSet(int initial_bins, double the_load_threshold, int (*cha
         throw ics::TemplateFunctionError("HashSet::initial_bins constructor: both specified and different");
     if(load_threshold <= 0)
         load_threshold = 1.0;
-    if(bins < 1)
-        bins = 1;
+    bins = power_of_2_bins(bins);
     ensure_load_threshold(used);
 }
 
@@ -219,10 +308,26 @@ HashSet<T,thash>::HashSet(const HashSet<T,thash>& to_copy, double the_load_thres
         set = copy_hash_table(to_copy.set,bins);
     }
     else {
+        grow_for(to_copy.used);
         for (const T &elem : to_copy)
             insert(elem);
     }
+    if(to_copy.bloom != nullptr)
+        use_bloom_filter();
+}
+
 
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>::HashSet(HashSet<T,thash>&& to_move)
+:hash(to_move.hash),load_threshold(to_move.load_threshold)
+{
+    //to_move keeps no table: like after clear, it allocates one when it is next inserted into
+    std::swap(set,to_move.set);
+    std::swap(bins,to_move.bins);
+    std::swap(used,to_move.used);
+    std::swap(reserved_bins,to_move.reserved_bins);
+    std::swap(bloom,to_move.bloom);
+    ++to_move.mod_count;
 }
 
 
@@ -236,8 +341,7 @@ HashSet<T,thash>::HashSet(const std::initializer_list<T>& il, double the_load_th
         throw ics::TemplateFunctionError("HashSet::initializer_list constructor: both specified and different");
     if(load_threshold <= 0)
         load_threshold = 1.0;
-    for(const T& i : il)
-        insert(i);
+    insert_all(il);
 }
 
 
@@ -252,8 +356,7 @@ HashSet<T,thash>::HashSet(const Iterable& i, double the_load_threshold, int (*ch
         throw ics::TemplateFunctionError("HashSet::Iterable constructor: both specified and different");
     if(load_threshold <= 0)
         load_threshold = 1.0;
-    for(const T& elem : i)
-        insert(elem);
+    insert_all(i);
 }
 
 
@@ -268,14 +371,21 @@ bool HashSet<T,thash>::empty() const {
 
 
 template<class T, int (*thash)(const T& a)>
-int HashSet<T,thash>::size() const {
+size_type HashSet<T,thash>::size() const {
     return used;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 bool HashSet<T,thash>::contains (const T& element) const {
-    return find_element(element) != nullptr;
+    return find_element(element,call_hash(element)) != nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template <class LOOKUP>
+bool HashSet<T,thash>::contains (const LOOKUP& element, int (*lookup_hash)(const LOOKUP& e)) const {
+    return find_element(element,lookup_hash(element)) != nullptr;
 }
 
 
@@ -284,7 +394,7 @@ std::string HashSet<T,thash>::str() const {
     std::ostringstream answer;
     answer << "HashSet[";
     if(!(this->empty())){
-        for(int i = 0; i < bins; i++){
+        for(size_type i = 0; i < bins; i++){
             answer << "\nbins[" << i << "]:  ";
             for(HashSet::LN* temp = set[i]; temp->next != nullptr; temp = temp->next)
                 answer << temp->value << "->";
@@ -296,6 +406,51 @@ std::string HashSet<T,thash>::str() const {
 }
 
 
+template<class T, int (*thash)(const T& a)>
+HashStats HashSet<T,thash>::stats() const {
+    HashStats answer;
+    answer.bins = set == nullptr ? 0 : bins;
+    answer.used = used;
+    answer.load_factor = answer.bins == 0 ? 0.0 : double(used) / answer.bins;
+    for(size_type i = 0; i < answer.bins; i++){
+        size_type length = 0;
+        for(LN* temp = set[i]; temp->next != nullptr; temp = temp->next)
+            length++;
+        answer.add_chain(length);
+    }
+    answer.rehashes = rehashes;
+    probes.fill(answer);
+    return answer;
+}
+
+
+//Three passes over each batch: hash the elements and prefetch their bins' pointers;
+//  prefetch each bin's first node; then search, finding most of it in the cache
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::contains_many (const T elements[], size_type n, bool found[]) const {
+    size_type count = 0;
+    int codes[lookup_batch];
+    for(size_type i = 0; i < n; i += lookup_batch){
+        size_type in_batch = std::min<size_type>(lookup_batch, n - i);
+        for(size_type j = 0; j < in_batch; j++){
+            codes[j] = call_hash(elements[i+j]);
+            if(set != nullptr)
+                prefetch(&set[compress(codes[j])]);
+        }
+        if(set != nullptr){
+            for(size_type j = 0; j < in_batch; j++)
+                prefetch(set[compress(codes[j])]);
+        }
+        for(size_type j = 0; j < in_batch; j++){
+            found[i+j] = find_element(elements[i+j],codes[j]) != nullptr;
+            if(found[i+j])
+                count++;
+        }
+    }
+    return count;
+}
+
+
 template<class T, int (*thash)(const T& a)>
 template <class Iterable>
 bool HashSet<T,thash>::contains_all(const Iterable& i) const {
@@ -313,53 +468,170 @@ bool HashSet<T,thash>::contains_all(const Iterable& i) const {
 
 template<class T, int (*thash)(const T& a)>
 int HashSet<T,thash>::insert(const T& element) {
-    LN* temp = find_element(element);
+    return insert_hashed(element,call_hash(element));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::insert(T&& element) {
+    int code = call_hash(element);
+    LN* temp = find_element(element,code);
     if(temp != nullptr)
         return 0;
     ++mod_count;
     ensure_load_threshold(++used);
-    int index = hash_compress(element);
-    set[index] = new LN(element,set[index]);
+    size_type index = compress(code);
+    set[index] = new LN(std::move(element),code,set[index]);
+    bloom_insert(code);
     return 1;
 }
 
 
+template<class T, int (*thash)(const T& a)>
+template<class... Args>
+int HashSet<T,thash>::emplace(Args&&... args) {
+    return insert(T(std::forward<Args>(args)...));
+}
+
+
 template<class T, int (*thash)(const T& a)>
 int HashSet<T,thash>::erase(const T& element) {
-    LN* temp = find_element(element);
-    if(temp == nullptr)
-        return 0;
-    LN* to_delete = temp->next;
-    *temp = *(temp->next);
-    delete to_delete;
-    --used;
-    ++mod_count;
-    return 1;
+    int count = erase_hashed(element,call_hash(element));
+    ensure_load_threshold_low(used);
+    return count;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 void HashSet<T,thash>::clear() {
     delete_hash_table(set,bins);
+    reserved_bins = 1;
+    bins = 1;                   //the next insert allocates a 1-bin table
     used = 0;
     ++mod_count;
+    if(bloom != nullptr)
+        bloom->reset(0);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::reserve(size_type n) {
+    reserved_bins = std::max(reserved_bins,bins_for(n));
+    grow_for(n);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::rehash(size_type n) {
+    size_type new_bins = power_of_2_bins(std::max(n,bins_for(used)));
+    ++mod_count;
+    if(set == nullptr)          //no table yet: ensure_load_threshold allocates it this size
+        bins = new_bins;
+    else if(new_bins != bins)
+        resize_table(new_bins);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::shrink_to_fit() {
+    reserved_bins = 1;
+    rehash(0);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::clear_stats() {
+    rehashes = 0;
+    probes.clear();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::use_bloom_filter(bool on) {
+    if(!on){
+        delete bloom;
+        bloom = nullptr;
+        return;
+    }
+    if(bloom == nullptr)
+        bloom = new BloomFilter();
+    rebuild_bloom();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+const BloomFilter* HashSet<T,thash>::bloom_filter() const {
+    return bloom;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
-int HashSet<T,thash>::insert_all(const Iterable& i) {
-    int count = 0;
+size_type HashSet<T,thash>::insert_all(const Iterable& i) {
+    grow_for(used + size_hint(i));
+    size_type count = 0;
     for(const T& elem : i)
         count += insert(elem);
     return count;
 }
 
 
+//Each thread writes only its own bins (and allocates their nodes from its own
+//  NodePool free lists). Probes are not counted: when counting is on (see
+//  ICS_HASH_PROBE_STATS), a ProbeCounter is not thread-safe.
+template<class T, int (*thash)(const T& a)>
+template<class Iter>
+size_type HashSet<T,thash>::build_parallel(Iter begin, Iter end, int threads) {
+    std::vector<decltype(&*begin)> elements;
+    for(Iter i = begin; i != end; ++i)
+        elements.push_back(&*i);
+    size_type n = elements.size();
+    grow_for(used + n);
+    ensure_load_threshold(used);    //allocates set, if there is none yet
+    ++mod_count;
+    threads = int(std::min<size_type>(threads_for(threads,n,parallel_grain),bins));
+
+    std::vector<int> codes(n);
+    on_threads(threads, [&] (int t) {
+        for(size_type i = chunk_begin(n,t,threads); i < chunk_begin(n,t + 1,threads); i++)
+            codes[i] = call_hash(*elements[i]);
+    });
+
+    size_type bins_per_thread = (bins + threads - 1) / threads;
+    std::vector<size_type> order, start;
+    partition_parallel(n, threads, [&] (size_type i) {return int(compress(codes[i]) / bins_per_thread);},
+                       threads, order, start);
+
+    std::vector<size_type> added(threads,0);
+    on_threads(threads, [&] (int t) {
+        size_type count = 0;
+        for(size_type k = start[t]; k < start[t + 1]; k++){
+            size_type i = order[k];
+            LN*& bin = set[compress(codes[i])];
+            LN* temp = bin;
+            while(temp->next != nullptr && !(codes[i] == temp->hash_code && *elements[i] == temp->value))
+                temp = temp->next;
+            if(temp->next == nullptr){
+                bin = new LN(*elements[i],codes[i],bin);
+                ++count;
+            }
+        }
+        added[t] = count;
+    });
+    size_type count = 0;
+    for(size_type a : added)
+        count += a;
+    used += count;
+    if(bloom != nullptr)
+        rebuild_bloom();
+    return count;
+}
+
+
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
-int HashSet<T,thash>::erase_all(const Iterable& i) {
-    int count = 0;
+size_type HashSet<T,thash>::erase_all(const Iterable& i) {
+    size_type count = 0;
     for(const T& elem : i)
         count += erase(elem);
     return count;
@@ -368,19 +640,189 @@ int HashSet<T,thash>::erase_all(const Iterable& i) {
 
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
-int HashSet<T,thash>::retain_all(const Iterable& i) {
-    HashSet hset(i);
-    int count = 0;
-    for(HashSet::Iterator i = this->begin(); i != this->end(); ++i){
-        if(!hset.contains(*i)){
-            i.erase();
+size_type HashSet<T,thash>::retain_all(const Iterable& i) {
+    if(set == nullptr)
+        return 0;
+
+    //Swap each element of i that is here into the kept[b]-node prefix of its bin b (no copy
+    //  of i is built), then cut every bin after its prefix
+    std::vector<size_type> kept(bins,0);
+    bool moved = false;
+    for(const T& v : i){
+        int hash_code = call_hash(v);
+        if(bloom != nullptr && !bloom->may_contain(hash_code))
+            continue;
+        size_type b = compress(hash_code);
+        LN* front = set[b];
+        size_type position = 0;
+        for(LN* temp = set[b]; temp->next != nullptr; temp = temp->next, ++position){
+            if(position == kept[b])
+                front = temp;
+            if(temp->hash_code == hash_code && temp->value == v){
+                if(position >= kept[b]){        //Not yet kept (i may repeat an element)
+                    if(temp != front){
+                        std::swap(temp->value,front->value);
+                        std::swap(temp->hash_code,front->hash_code);
+                        moved = true;
+                    }
+                    ++kept[b];
+                }
+                break;
+            }
+        }
+    }
+
+    size_type count = 0;
+    for(size_type b = 0; b < bins; ++b){
+        LN** link = &set[b];
+        for(size_type j = 0; j < kept[b]; ++j)
+            link = &(*link)->next;
+        while((*link)->next != nullptr){   //Not the trailer
+            LN* to_delete = *link;
+            *link = to_delete->next;
+            delete to_delete;
             ++count;
         }
     }
+
+    if(count > 0 || moved)
+        ++mod_count;
+    if(count > 0){
+        used -= count;
+        bloom_erase(count);
+        ensure_load_threshold_low(used);
+    }
     return count;
 }
 
 
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::retain_all(const HashSet<T,thash>& s) {
+    if(this == &s)
+        return 0;
+    return erase_where(s,false);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator | (const HashSet<T,thash>& rhs) const {
+    HashSet<T,thash> answer(load_threshold,hash);
+    answer.grow_for(used + rhs.used);
+    answer |= *this;
+    answer |= rhs;
+    return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator & (const HashSet<T,thash>& rhs) const {
+    if(hash == rhs.hash && rhs.used < used)
+        return rhs.filter(*this,true,1);
+    return filter(rhs,true,1);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator - (const HashSet<T,thash>& rhs) const {
+    return filter(rhs,false,1);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator ^ (const HashSet<T,thash>& rhs) const {
+    HashSet<T,thash> answer(load_threshold,hash);
+    answer.grow_for(used + rhs.used);
+    for(size_type i = 0; set != nullptr && i < bins; i++)
+        for(LN* temp = set[i]; temp->next != nullptr; temp = temp->next)
+            if(!rhs.contains_node(*this,temp))
+                answer.insert_hashed(temp->value,temp->hash_code);
+    for(size_type i = 0; rhs.set != nullptr && i < rhs.bins; i++)
+        for(LN* temp = rhs.set[i]; temp->next != nullptr; temp = temp->next)
+            if(!contains_node(rhs,temp))
+                answer.insert_hashed(temp->value,hash == rhs.hash ? temp->hash_code : call_hash(temp->value));
+    answer.ensure_load_threshold_low(answer.used);
+    return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator |= (const HashSet<T,thash>& rhs) {
+    if(this == &rhs)
+        return *this;
+    grow_for(used + rhs.used);
+    for(size_type i = 0; rhs.set != nullptr && i < rhs.bins; i++)
+        for(LN* temp = rhs.set[i]; temp->next != nullptr; temp = temp->next)
+            insert_hashed(temp->value,hash == rhs.hash ? temp->hash_code : call_hash(temp->value));
+    return *this;
+}
+
+
+//Keeping the few elements of a smaller rhs builds a table sized for them,
+//  instead of erasing nearly all of this set's elements one at a time
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator &= (const HashSet<T,thash>& rhs) {
+    if(this == &rhs)
+        return *this;
+    if(hash == rhs.hash && load_threshold == rhs.load_threshold && rhs.used < used / 2){
+        bool had_bloom = bloom != nullptr;
+        *this = rhs.filter(*this,true,1);
+        use_bloom_filter(had_bloom);
+    }else
+        erase_where(rhs,false);
+    return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator -= (const HashSet<T,thash>& rhs) {
+    if(this == &rhs){
+        clear();
+        return *this;
+    }
+    if(rhs.used >= used){
+        erase_where(rhs,true);
+        return *this;
+    }
+    for(size_type i = 0; rhs.set != nullptr && i < rhs.bins; i++)
+        for(LN* temp = rhs.set[i]; temp->next != nullptr; temp = temp->next)
+            erase_hashed(temp->value,hash == rhs.hash ? temp->hash_code : call_hash(temp->value));
+    ensure_load_threshold_low(used);
+    return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator ^= (const HashSet<T,thash>& rhs) {
+    if(this == &rhs){
+        clear();
+        return *this;
+    }
+    grow_for(used + rhs.used);
+    for(size_type i = 0; rhs.set != nullptr && i < rhs.bins; i++)
+        for(LN* temp = rhs.set[i]; temp->next != nullptr; temp = temp->next){
+            int code = hash == rhs.hash ? temp->hash_code : call_hash(temp->value);
+            if(erase_hashed(temp->value,code) == 0)
+                insert_hashed(temp->value,code);
+        }
+    ensure_load_threshold_low(used);
+    return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::parallel_intersection(const HashSet<T,thash>& rhs, int threads) const {
+    if(hash == rhs.hash && rhs.used < used)
+        return rhs.filter(*this,true,threads);
+    return filter(rhs,true,threads);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::parallel_difference(const HashSet<T,thash>& rhs, int threads) const {
+    return filter(rhs,false,threads);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
@@ -399,24 +841,37 @@ HashSet<T,thash>& HashSet<T,thash>::operator = (const HashSet<T,thash>& rhs) {
         hash = rhs.hash;
         insert_all(rhs);
     }
+    if(bloom != nullptr)
+        rebuild_bloom();
     ++mod_count;
     return *this;
 }
 
 
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator = (HashSet<T,thash>&& rhs) {
+    if(this == &rhs)
+        return *this;
+    std::swap(hash,rhs.hash);
+    std::swap(load_threshold,rhs.load_threshold);
+    std::swap(set,rhs.set);
+    std::swap(bins,rhs.bins);
+    std::swap(used,rhs.used);
+    std::swap(reserved_bins,rhs.reserved_bins);
+    std::swap(bloom,rhs.bloom);
+    ++mod_count;
+    ++rhs.mod_count;
+    return *this;
+}
+
+
 template<class T, int (*thash)(const T& a)>
 bool HashSet<T,thash>::operator == (const HashSet<T,thash>& rhs) const {
     if(this == &rhs)
         return true;
     if(used != rhs.used)
         return false;
-    HashSet::LN* temp;
-    for(HashSet::Iterator i = rhs.begin(); i != rhs.end(); ++i){
-        temp = find_element(*i);
-        if(temp == nullptr)
-            return false;
-    }
-    return true;
+    return rhs.all_in(*this);
 }
 
 
@@ -432,11 +887,7 @@ bool HashSet<T,thash>::operator <= (const HashSet<T,thash>& rhs) const {
         return true;
     if(used > rhs.used)
         return false;
-    for(HashSet::Iterator i = this->begin(); i != this->end(); ++i){
-        if(rhs.find_element(*i) == nullptr)
-            return false;
-    }
-    return true;
+    return all_in(rhs);
 }
 
 template<class T, int (*thash)(const T& a)>
@@ -445,11 +896,7 @@ bool HashSet<T,thash>::operator < (const HashSet<T,thash>& rhs) const {
         return false;
     if(used >= rhs.used)
         return false;
-    for(HashSet::Iterator i = this->begin(); i != this->end(); ++i){
-        if(rhs.find_element(*i) == nullptr)
-            return false;
-    }
-    return true;
+    return all_in(rhs);
 }
 
 
@@ -501,22 +948,55 @@ auto HashSet<T,thash>::end () const -> HashSet<T,thash>::Iterator {
 //Private helper methods
 
 template<class T, int (*thash)(const T& a)>
-int HashSet<T,thash>::hash_compress (const T& element) const {
-    int result = hash(element) % bins;
-    if(result < 0)
-        result = result * -1;
+int HashSet<T,thash>::call_hash (const T& element) const {
+    return thash != (hashfunc)undefinedhash<T> ? thash(element) : hash(element);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::compress (int hash_code) const {
+    //Multiply-shift: the high half of hash_code*2^64/phi mixes all of hash_code's bits,
+    //so masking (not %, which needs a slow divide) picks a bin even if only high bits vary
+    //hash_code has only 32 bits, so mixed does too: at most 2^32 bins are ever used
+    //  (see hash_fold in ics_hash.hpp for what that means past 2^32 keys)
+    std::uint64_t mixed = (std::uint64_t(std::uint32_t(hash_code)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+    return size_type(mixed & std::uint64_t(bins - 1));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::power_of_2_bins (size_type at_least) {
+    size_type result = 1;
+    while(result < at_least)
+        result = result * 2;
     return result;
 }
 
 
 template<class T, int (*thash)(const T& a)>
-typename HashSet<T,thash>::LN* HashSet<T,thash>::find_element (const T& element) const {
-    if(set == nullptr)
+size_type HashSet<T,thash>::bins_for (size_type n) const {
+    return power_of_2_bins(size_type(std::ceil(n / load_threshold)));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template <class LOOKUP>
+typename HashSet<T,thash>::LN* HashSet<T,thash>::find_element (const LOOKUP& element, int hash_code) const {
+    if(set == nullptr || (bloom != nullptr && !bloom->may_contain(hash_code))){
+        probes.miss(0);
         return nullptr;
-    for(LN* temp = set[hash_compress(element)]; temp->next != nullptr; temp = temp->next){
-        if(temp->value == element)
+    }
+    int probed = 0;
+    for(LN* temp = set[compress(hash_code)]; temp->next != nullptr; temp = temp->next){
+        probed++;
+        if(temp->hash_code == hash_code && temp->value == element){
+            probes.hit(probed);
             return temp;
+        }
     }
+    probes.miss(probed);
+    if(bloom != nullptr)
+        bloom->note_false_positive();
     return nullptr;
 }
 
@@ -524,54 +1004,224 @@ template<class T, int (*thash)(const T& a)>
 typename HashSet<T,thash>::LN* HashSet<T,thash>::copy_list (LN* l) const {
     if(l->next == nullptr)
         return new LN();
-    return new LN(l->value,copy_list(l->next));
+    return new LN(l->value,l->hash_code,copy_list(l->next));
 }
 
 
 template<class T, int (*thash)(const T& a)>
-typename HashSet<T,thash>::LN** HashSet<T,thash>::copy_hash_table (LN** ht, int bins) const {
+typename HashSet<T,thash>::LN** HashSet<T,thash>::copy_hash_table (LN** ht, size_type bins) const {
     if(ht == nullptr)
         return nullptr;
     LN** newSet = new LN*[bins];
-    for(int i = 0; i < bins; i++)
+    for(size_type i = 0; i < bins; i++)
         newSet[i] = copy_list(ht[i]);
     return newSet;
 }
 
 
 template<class T, int (*thash)(const T& a)>
-void HashSet<T,thash>::ensure_load_threshold(int new_used) {
+bool HashSet<T,thash>::contains_node (const HashSet<T,thash>& from, const LN* n) const {
+    return find_element(n->value,hash == from.hash ? n->hash_code : call_hash(n->value)) != nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool HashSet<T,thash>::all_in (const HashSet<T,thash>& s) const {
+    for(size_type i = 0; set != nullptr && i < bins; i++)
+        for(LN* temp = set[i]; temp->next != nullptr; temp = temp->next)
+            if(!s.contains_node(*this,temp))
+                return false;
+    return true;
+}
+
+
+//The answer has as many bins as this set (and its hash), so the elements kept
+//  from set[i] all go into answer.set[i]: threads filling disjoint ranges of
+//  bins need no locking. The answer is shrunk afterward if it kept few elements.
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::filter (const HashSet<T,thash>& s, bool in_s, int threads) const {
+    HashSet<T,thash> answer(load_threshold,hash);
+    answer.rehash(bins);
+    if(set == nullptr)
+        return answer;
+    if(threads <= 0)
+        threads = std::max(1,int(std::thread::hardware_concurrency()));
+    threads = int(std::max<size_type>(1,std::min<size_type>(threads,used / parallel_grain)));
+
+    std::vector<size_type> kept(threads,0);
+    auto fill = [&] (int t) {
+        size_type count = 0;
+        size_type last  = bins * (t + 1) / threads;
+        for(size_type i = bins * t / threads; i < last; i++)
+            for(LN* temp = set[i]; temp->next != nullptr; temp = temp->next)
+                if(s.contains_node(*this,temp) == in_s){
+                    answer.set[i] = new LN(temp->value,temp->hash_code,answer.set[i]);
+                    ++count;
+                }
+        kept[t] = count;
+    };
+
+    std::vector<std::thread> workers;
+    for(int t = 1; t < threads; t++)
+        workers.push_back(std::thread(fill,t));
+    fill(0);
+    for(std::thread& w : workers)
+        w.join();
+
+    for(size_type count : kept)
+        answer.used += count;
+    answer.ensure_load_threshold_low(answer.used);
+    return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::insert_hashed(const T& element, int hash_code) {
+    LN* temp = find_element(element,hash_code);
+    if(temp != nullptr)
+        return 0;
+    ++mod_count;
+    ensure_load_threshold(++used);
+    size_type index = compress(hash_code);
+    set[index] = new LN(element,hash_code,set[index]);
+    bloom_insert(hash_code);
+    return 1;
+}
+
+
+//Never shrinks the table: callers erasing many elements shrink once, at the end
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::erase_hashed(const T& element, int hash_code) {
+    LN* temp = find_element(element,hash_code);
+    if(temp == nullptr)
+        return 0;
+    LN* to_delete = temp->next;
+    *temp = std::move(*(temp->next));
+    delete to_delete;
+    --used;
+    ++mod_count;
+    bloom_erase(1);
+    return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::erase_where(const HashSet<T,thash>& s, bool in_s) {
+    size_type count = 0;
+    for(size_type i = 0; set != nullptr && i < bins; i++)
+        for(LN* temp = set[i]; temp->next != nullptr; /*See body*/){
+            if(s.contains_node(*this,temp) != in_s)
+                temp = temp->next;
+            else{
+                LN* to_delete = temp->next;
+                *temp = std::move(*(temp->next));
+                delete to_delete;
+                ++count;
+            }
+        }
+    if(count > 0){
+        used -= count;
+        ++mod_count;
+        bloom_erase(count);
+        ensure_load_threshold_low(used);
+    }
+    return count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::ensure_load_threshold(size_type new_used) {
     if(set == nullptr){
         set = new HashSet::LN*[bins];
-        for(int i = 0; i < bins; i++)
+        for(size_type i = 0; i < bins; i++)
             set[i] = new HashSet::LN();
     }
     if(((double) new_used / bins) <= load_threshold)
         return;
-    int tempBins = bins;
-    bins = bins * 2;
+    resize_table(bins * 2);
+}
+
+
+//Bulk operations (insert_all, build_parallel, copies, set operators) size the table with this, not with
+//  reserve, so the bins they need do not stop later erases from shrinking it
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::grow_for(size_type n) {
+    if(bins_for(n) > bins)
+        rehash(bins_for(n));
+}
+
+
+//Shrinking to half of load_threshold (not to load_threshold/4) leaves room to
+//  grow back by 2x before growing again, so alternating insert/erase near a
+//  boundary never rehashes on each call; never shrinks below reserved_bins
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::ensure_load_threshold_low(size_type new_used) {
+    if(bins <= reserved_bins || ((double) new_used / bins) >= load_threshold / 4)
+        return;
+    rehash(std::max(bins_for(2 * new_used),reserved_bins));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::resize_table(size_type new_bins) {
+    ++rehashes;
+    size_type tempBins = bins;
+    bins = new_bins;
     HashSet::LN** newSet = new HashSet::LN*[bins];
-    for(int j = 0; j < bins; j++)
+    for(size_type j = 0; j < bins; j++)
         newSet[j] = new HashSet::LN();
-    for(int k = 0; k < tempBins; k++){
+    for(size_type k = 0; k < tempBins; k++){
         while(set[k]->next != nullptr){
             LN* temp2 = set[k];
             set[k] = set[k]->next;
-            LN*& newBin = newSet[hash_compress(temp2->value)];
+            LN*& newBin = newSet[compress(temp2->hash_code)];
             temp2->next = newBin;
             newBin = temp2;
         }
     }
     delete_hash_table(set,tempBins);
     set = newSet;
+    if(bloom != nullptr)
+        rebuild_bloom();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::bloom_insert(int hash_code) {
+    if(bloom == nullptr)
+        return;
+    if(bloom->full())
+        rebuild_bloom();            //the new element's node is already linked
+    else
+        bloom->insert(hash_code);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::bloom_erase(size_type count) {
+    if(bloom == nullptr)
+        return;
+    bloom->note_erase(count);
+    if(bloom->stale())
+        rebuild_bloom();
+}
+
+
+//Moves no nodes, so it is safe while an Iterator is erasing
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::rebuild_bloom() {
+    bloom->reset(2 * used);
+    for(size_type i = 0; set != nullptr && i < bins; i++)
+        for(LN* temp = set[i]; temp->next != nullptr; temp = temp->next)
+            bloom->insert(temp->hash_code);
 }
 
 
 template<class T, int (*thash)(const T& a)>
-void HashSet<T,thash>::delete_hash_table (LN**& ht, int bins) {
+void HashSet<T,thash>::delete_hash_table (LN**& ht, size_type bins) {
     if(ht == nullptr)
         return;
-    for(int i = 0; i < bins; i++){
+    for(size_type i = 0; i < bins; i++){
         while(ht[i] != nullptr){
             LN* temp = ht[i];
             ht[i] = ht[i]->next;
@@ -631,12 +1281,13 @@ T HashSet<T,thash>::Iterator::erase() {
     if(current.first == -1)
         throw ics::CannotEraseError("HashSet::Iterator::erase: Iterator cursor already beyond data structure");
     can_erase = false;
-    T returnVal = current.second->value;
+    T returnVal = std::move(current.second->value);
     HashSet::LN* to_del = current.second->next;
-    *(current.second) = *(current.second->next);
+    *(current.second) = std::move(*(current.second->next));
     delete to_del;
     ref_set->used--;
     ref_set->mod_count++;
+    ref_set->bloom_erase(1);
     expected_mod_count = ref_set->mod_count;
     advance_cursors();
     return returnVal;
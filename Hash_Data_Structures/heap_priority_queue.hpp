@@ -8,6 +8,7 @@
 #include "ics_exceptions.hpp"
 #include <utility>              //For std::swap function
 #include "array_stack.hpp"      //See operator <<
+#include "size_hint.hpp"
 
 
 namespace ics {
@@ -34,6 +35,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
     HeapPriorityQueue(bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     explicit HeapPriorityQueue(int initial_length, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     HeapPriorityQueue(const HeapPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    HeapPriorityQueue(HeapPriorityQueue<T,tgt>&& to_move);  //Uses to_move's gt; to_move is left empty
     explicit HeapPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -42,24 +44,31 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     int  enqueue (const T& element);
+    int  enqueue (T&& element);
     T    dequeue ();
     void clear   ();
+    void reserve (size_type n);   //Room for n values: no reallocation while size() <= n
+
+    //Enqueue T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int enqueue_all (const Iterable& i);
+    size_type enqueue_all (const Iterable& i);
 
 
     //Operators
     HeapPriorityQueue<T,tgt>& operator = (const HeapPriorityQueue<T,tgt>& rhs);
+    HeapPriorityQueue<T,tgt>& operator = (HeapPriorityQueue<T,tgt>&& rhs);  //Swaps contents (and gt) with rhs
     bool operator == (const HeapPriorityQueue<T,tgt>& rhs) const;
     bool operator != (const HeapPriorityQueue<T,tgt>& rhs) const;
 
@@ -92,7 +101,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
         //If can_erase is false, the value has been removed from "it" (++ does nothing)
         HeapPriorityQueue<T,tgt>  it;                 //copy of HPQ (from begin), to use as iterator via dequeue
         HeapPriorityQueue<T,tgt>* ref_pq;
-        int                       expected_mod_count;
+        size_type                 expected_mod_count;
         bool                      can_erase = true;
 
         //Called in friends begin/end
@@ -109,21 +118,22 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
   private:
     bool (*gt) (const T& a, const T& b); // The gt used by enqueue (from template or constructor)
     T*  pq;                              // Array represents a heap, so it uses heap ordering property
-    int length    = 0;                   //Physical length of array: must be >= .size()
-    int used      = 0;                   //Amount of array used:  invariant: 0 <= used <= length
-    int mod_count = 0;                   //For sensing concurrent modification
+    size_type length    = 0;             //Physical length of array: must be >= .size()
+    size_type used      = 0;             //Amount of array used:  invariant: 0 <= used <= length
+    size_type mod_count = 0;             //For sensing concurrent modification
 
 
     //Helper methods
-    void ensure_length  (int new_length);
-    int  left_child     (int i) const;         //Useful abstractions for heaps as arrays
-    int  right_child    (int i) const;
-    int  parent         (int i) const;
-    bool is_root        (int i) const;
-    bool in_heap        (int i) const;
-    void percolate_up   (int i);
-    void percolate_down (int i);
-    void heapify        ();                   // Percolate down all value is array (from indexes used-1 to 0): O(N)
+    bool      call_gt        (const T& a, const T& b) const;  //tgt(a,b) if given (a direct call: inlinable), else gt(a,b)
+    void      ensure_length  (size_type new_length);
+    size_type left_child     (size_type i) const;         //Useful abstractions for heaps as arrays
+    size_type right_child    (size_type i) const;
+    size_type parent         (size_type i) const;
+    bool      is_root        (size_type i) const;
+    bool      in_heap        (size_type i) const;
+    void      percolate_up   (size_type i);
+    void      percolate_down (size_type i);
+    void      heapify        ();                   // Percolate down all value is array (from indexes used-1 to 0): O(N)
   };
 
 
@@ -177,7 +187,7 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const HeapPriorityQueue<T,tgt>& to_c
     throw TemplateFunctionError("HeapPriorityQueue::copy constructor: both specified and different");
 
   pq = new T[length];
-  for (int i=0; i<to_copy.used; ++i)
+  for (size_type i=0; i<to_copy.used; ++i)
     pq[i] = to_copy.pq[i];
 
   if (gt != to_copy.gt)
@@ -185,6 +195,17 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const HeapPriorityQueue<T,tgt>& to_c
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+HeapPriorityQueue<T,tgt>::HeapPriorityQueue(HeapPriorityQueue<T,tgt>&& to_move)
+: gt(to_move.gt) {
+  pq = new T[length];
+  std::swap(pq,    to_move.pq);
+  std::swap(length,to_move.length);
+  std::swap(used,  to_move.used);
+  ++to_move.mod_count;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
 : gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt), length(il.size()) {
@@ -194,7 +215,7 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const std::initializer_list<T>& il,
     throw TemplateFunctionError("HeapPriorityQueue::initializer_list constructor: both specified and different");
 
   pq = new T[length];
-  int i = 0;
+  size_type i = 0;
   for (const T& pq_elem : il) {
     pq[i++] = pq_elem;
   }
@@ -213,7 +234,7 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const Iterable& i, bool (*cgt)(const
     throw TemplateFunctionError("HeapPriorityQueue::Iterable constructor: both specified and different");
 
   pq = new T[length];
-  int j = 0;
+  size_type j = 0;
   for (const T& pq_elem : i) {
     pq[j++] = pq_elem;
   }
@@ -233,7 +254,7 @@ bool HeapPriorityQueue<T,tgt>::empty() const {
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::size() const {
+size_type HeapPriorityQueue<T,tgt>::size() const {
   return used;
 }
 
@@ -254,7 +275,7 @@ std::string HeapPriorityQueue<T,tgt>::str() const {
 
   if (length != 0) {
     answer << "0:" << pq[0];
-    for (int i = 1; i < length; ++i)
+    for (size_type i = 1; i < length; ++i)
       answer << "," << i << ":" << pq[i];
   }
 
@@ -278,13 +299,31 @@ int HeapPriorityQueue<T,tgt>::enqueue(const T& element) {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int HeapPriorityQueue<T,tgt>::enqueue(T&& element) {
+  this->ensure_length(used+1);
+  pq[used++] = std::move(element);
+
+  this->percolate_up(used-1);
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class... Args>
+int HeapPriorityQueue<T,tgt>::emplace(Args&&... args) {
+  return enqueue(T(std::forward<Args>(args)...));
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T HeapPriorityQueue<T,tgt>::dequeue() {
   if (this->empty())
     throw EmptyError("HeapPriorityQueue::dequeue");
 
-  T to_return = pq[0];
-  pq[0] = pq[--used];
+  T to_return = std::move(pq[0]);
+  pq[0] = std::move(pq[--used]);
 
   percolate_down(0);
 
@@ -300,13 +339,34 @@ void HeapPriorityQueue<T,tgt>::clear() {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::reserve(size_type n) {
+  this->ensure_length(n);
+  ++mod_count;
+}
+
+
+//Append all the values; then, if there are at least as many new values as old,
+//  heapify everything in O(N) rather than percolating each new value up
 template<class T, bool (*tgt)(const T& a, const T& b)>
 template <class Iterable>
-int HeapPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
-  int count = 0;
-  for (const T& v : i)
-     count += enqueue(v);
+size_type HeapPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
+  this->ensure_length(used+size_hint(i));
+  size_type old_used = used;
+  for (const T& v : i) {
+    this->ensure_length(used+1);
+    pq[used++] = v;
+  }
+
+  size_type count = used-old_used;
+  if (count >= old_used)
+    heapify();
+  else
+    for (size_type j=old_used; j<used; ++j)
+      percolate_up(j);
 
+  if (count != 0)
+    ++mod_count;
   return count;
 }
 
@@ -323,7 +383,7 @@ HeapPriorityQueue<T,tgt>& HeapPriorityQueue<T,tgt>::operator = (const HeapPriori
   gt = rhs.gt;   // if tgt != nullptr, gts are already equal (or compiler error)
   this->ensure_length(rhs.used);
   used = rhs.used;
-  for (int i=0; i<rhs.used; ++i)
+  for (size_type i=0; i<rhs.used; ++i)
     pq[i] = rhs.pq[i];
 
   ++mod_count;
@@ -331,6 +391,21 @@ HeapPriorityQueue<T,tgt>& HeapPriorityQueue<T,tgt>::operator = (const HeapPriori
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+HeapPriorityQueue<T,tgt>& HeapPriorityQueue<T,tgt>::operator = (HeapPriorityQueue<T,tgt>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(gt,    rhs.gt);
+  std::swap(pq,    rhs.pq);
+  std::swap(length,rhs.length);
+  std::swap(used,  rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 bool HeapPriorityQueue<T,tgt>::operator == (const HeapPriorityQueue<T,tgt>& rhs) const {
   if (this == &rhs)
@@ -340,7 +415,7 @@ bool HeapPriorityQueue<T,tgt>::operator == (const HeapPriorityQueue<T,tgt>& rhs)
   if (used != rhs.size())
     return false;
   HeapPriorityQueue<T,tgt>::Iterator l = this->begin(), r = rhs.begin();
-  for (int i=0; i<used; ++i, ++l, ++r)
+  for (size_type i=0; i<used; ++i, ++l, ++r)
     if (*l != *r)
       return false;
 
@@ -361,7 +436,7 @@ std::ostream& operator << (std::ostream& outs, const HeapPriorityQueue<T,tgt>& p
   if (!p.empty()) {
     ArrayStack<T> temp(p);
     outs << temp.pop();
-    for (int i = 1; i < p.used; ++i)
+    for (size_type i = 1; i < p.used; ++i)
       outs << "," << temp.pop();
   }
 
@@ -391,53 +466,59 @@ auto HeapPriorityQueue<T,tgt>::end () const -> HeapPriorityQueue<T,tgt>::Iterato
 //Private helper methods
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void HeapPriorityQueue<T,tgt>::ensure_length(int new_length) {
+bool HeapPriorityQueue<T,tgt>::call_gt (const T& a, const T& b) const {
+  return tgt != (gtfunc)undefinedgt<T> ? tgt(a,b) : gt(a,b);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::ensure_length(size_type new_length) {
   if (length >= new_length)
     return;
   T*  old_pq  = pq;
   length = std::max(new_length,2*length);
   pq = new T[length];
-  for (int i=0; i<used; ++i)
-    pq[i] = old_pq[i];
+  for (size_type i=0; i<used; ++i)
+    pq[i] = std::move(old_pq[i]);
 
   delete [] old_pq;
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::left_child(int i) const
+size_type HeapPriorityQueue<T,tgt>::left_child(size_type i) const
 {return 2*i+1;}
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::right_child(int i) const
+size_type HeapPriorityQueue<T,tgt>::right_child(size_type i) const
 {return 2*i+2;}
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::parent(int i) const
+size_type HeapPriorityQueue<T,tgt>::parent(size_type i) const
 {return (i-1)/2;}
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-bool HeapPriorityQueue<T,tgt>::is_root(int i) const
+bool HeapPriorityQueue<T,tgt>::is_root(size_type i) const
 {return i == 0;}
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-bool HeapPriorityQueue<T,tgt>::in_heap(int i) const
+bool HeapPriorityQueue<T,tgt>::in_heap(size_type i) const
 {return i < used;}
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void HeapPriorityQueue<T,tgt>::percolate_up(int i) {
-  for (/*parameter*/; !is_root(i) && gt(pq[i],pq[parent(i)]); i = parent(i))
+void HeapPriorityQueue<T,tgt>::percolate_up(size_type i) {
+  for (/*parameter*/; !is_root(i) && call_gt(pq[i],pq[parent(i)]); i = parent(i))
     std::swap(pq[parent(i)],pq[i]);
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void HeapPriorityQueue<T,tgt>::percolate_down(int i) {
-  for (int l = left_child(i); in_heap(l); l = left_child(i)) {
-    int r = right_child(i);
-    int max_child = (!in_heap(r) || gt(pq[l],pq[r]) ? l : r);
-    if ( gt(pq[i],pq[max_child]) )
+void HeapPriorityQueue<T,tgt>::percolate_down(size_type i) {
+  for (size_type l = left_child(i); in_heap(l); l = left_child(i)) {
+    size_type r = right_child(i);
+    size_type max_child = (!in_heap(r) || call_gt(pq[l],pq[r]) ? l : r);
+    if ( call_gt(pq[i],pq[max_child]) )
        break;
     std::swap(pq[i],pq[max_child]);
     i = max_child;
@@ -448,7 +529,7 @@ void HeapPriorityQueue<T,tgt>::percolate_down(int i) {
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 void HeapPriorityQueue<T,tgt>::heapify() {
-for (int i = used-1; i >= 0; --i)
+for (size_type i = used-1; i >= 0; --i)
   percolate_down(i);
 }
 
@@ -490,11 +571,13 @@ T HeapPriorityQueue<T,tgt>::Iterator::erase() {
   T to_return = it.dequeue();
 
   //Find value from it (heap iterating over) in main heap; percolate it
-  for (int i=0; i<ref_pq->used; ++i)
+  for (size_type i=0; i<ref_pq->used; ++i)
     if (ref_pq->pq[i] == to_return) {
-      ref_pq->pq[i] = ref_pq->pq[--ref_pq->used];
-      ref_pq->percolate_up(i);
-      ref_pq->percolate_down(i);
+      if (i != --ref_pq->used) {    //Last value fills the hole (unless it was the last)
+        ref_pq->pq[i] = std::move(ref_pq->pq[ref_pq->used]);
+        ref_pq->percolate_up(i);
+        ref_pq->percolate_down(i);
+      }
       break;
     }
 
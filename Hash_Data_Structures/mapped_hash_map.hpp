@@ -0,0 +1,261 @@
+#ifndef MAPPED_HASH_MAP_HPP_
+#define MAPPED_HASH_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <utility>              //For std::swap function
+#include <cstdint>
+#include <fcntl.h>              //POSIX open/fstat/mmap/munmap/close
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ics_exceptions.hpp"
+#include "snapshot.hpp"
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+//A read-only map answering has_key/[] straight from a snapshot file written by
+//  save_map_snapshot (snapshot.hpp): the file is mapped into memory (mmap), so
+//  opening it reads only its header, and each lookup probes the snapshot's index
+//  and compares one stored key (usually), touching just the pages it needs.
+//Nothing is copied: [] returns a const T& into the mapping (a StringView for a
+//  std::string value), valid as long as this MappedHashMap.
+//Opening checks the header and the hash codes of a few keys (a snapshot saved
+//  with a different hash function raises TemplateFunctionError), but trusts the
+//  rest of the file: do not open a file that is being rewritten.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> class MappedHashMap {
+  public:
+    typedef int (*hashfunc) (const KEY& a);
+    typedef typename snapshot_detail::Codec<T>::View View;   //const T&, or StringView for std::string
+
+    //Destructor/Constructors
+    ~MappedHashMap ();
+
+    explicit MappedHashMap (const std::string& file_name, int (*chash)(const KEY& k) = undefinedhash<KEY>);
+    MappedHashMap          (MappedHashMap<KEY,T,thash>&& to_move);  //to_move is left empty (and unmapped)
+    MappedHashMap          (const MappedHashMap<KEY,T,thash>& to_copy) = delete;
+    MappedHashMap<KEY,T,thash>& operator = (const MappedHashMap<KEY,T,thash>& rhs) = delete;
+
+
+    //Queries
+    bool      empty      () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    View      operator [] (const KEY& key) const;   //KeyError if absent
+    std::string str () const; //supplies useful debugging information (not the entries: there may be billions)
+
+    //Heterogeneous lookup: key is a LOOKUP (e.g., StringView for std::string keys), so no KEY
+    //  is built; LOOKUP == KEY must be defined and lookup_hash(key) must equal hash(KEY(key))
+    template <class LOOKUP>
+    bool has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;
+    template <class LOOKUP>
+    View get     (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;  //KeyError if absent, like []
+
+    static const int verify_keys = 8;   //# stored keys whose hash codes are checked when opening
+
+
+  private:
+    typedef snapshot_detail::Header Header;
+    typedef snapshot_detail::Slot   Slot;
+
+    int (*hash)(const KEY& k);       //Hashing function used (from template or constructor)
+    std::string file_name;
+    const char* base  = nullptr;     //The mapped snapshot (nullptr if moved from)
+    std::size_t bytes = 0;           //# bytes mapped
+    const Header* header = nullptr;
+    const Slot*   index  = nullptr;
+
+    //Helper methods
+    template <class LOOKUP>
+    const char* find_key    (const LOOKUP& key, int hash_code) const;  //Returns key's entry or nullptr
+    void        verify_hash () const;                                  //TemplateFunctionError if codes differ
+    void        unmap       ();
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//MappedHashMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+MappedHashMap<KEY,T,thash>::~MappedHashMap() {
+  unmap();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+MappedHashMap<KEY,T,thash>::MappedHashMap(const std::string& file_name, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), file_name(file_name) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("MappedHashMap::constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("MappedHashMap::constructor: both specified and different");
+
+  int fd = ::open(file_name.c_str(),O_RDONLY);
+  if (fd == -1)
+    throw IcsError("MappedHashMap::constructor: cannot open "+file_name);
+  struct stat info;
+  if (::fstat(fd,&info) == -1 || info.st_size < off_t(sizeof(Header))) {
+    ::close(fd);
+    throw IcsError("MappedHashMap::constructor: not a snapshot: "+file_name);
+  }
+  bytes = std::size_t(info.st_size);
+  void* mapped = ::mmap(nullptr,bytes,PROT_READ,MAP_SHARED,fd,0);
+  ::close(fd);                       //The mapping stays valid
+  if (mapped == MAP_FAILED)
+    throw IcsError("MappedHashMap::constructor: cannot map "+file_name);
+  base   = static_cast<const char*>(mapped);
+  header = reinterpret_cast<const Header*>(base);
+
+  try {
+    snapshot_detail::check_header(*header,snapshot_detail::map_kind,snapshot_detail::Codec<KEY>::size,
+                                  snapshot_detail::Codec<T>::size,bytes,"MappedHashMap::constructor("+file_name+")");
+    index = reinterpret_cast<const Slot*>(base+header->index_offset);
+    verify_hash();
+  } catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+MappedHashMap<KEY,T,thash>::MappedHashMap(MappedHashMap<KEY,T,thash>&& to_move)
+: hash(to_move.hash), file_name(to_move.file_name) {
+  std::swap(base,  to_move.base);
+  std::swap(bytes, to_move.bytes);
+  std::swap(header,to_move.header);
+  std::swap(index, to_move.index);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool MappedHashMap<KEY,T,thash>::empty() const {
+  return size() == 0;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type MappedHashMap<KEY,T,thash>::size() const {
+  return header == nullptr ? 0 : size_type(header->count);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool MappedHashMap<KEY,T,thash>::has_key (const KEY& key) const {
+  return find_key(key,hash(key)) != nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto MappedHashMap<KEY,T,thash>::operator [] (const KEY& key) const -> View {
+  const char* entry = find_key(key,hash(key));
+  if (entry == nullptr) {
+    std::ostringstream answer;
+    answer << "MappedHashMap::operator []: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  return snapshot_detail::Codec<T>::view(entry + snapshot_detail::Codec<KEY>::bytes_at(entry,base+header->bytes));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+bool MappedHashMap<KEY,T,thash>::has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  return find_key(key,lookup_hash(key)) != nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+auto MappedHashMap<KEY,T,thash>::get (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const -> View {
+  const char* entry = find_key(key,lookup_hash(key));
+  if (entry == nullptr) {
+    std::ostringstream answer;
+    answer << "MappedHashMap::get: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  return snapshot_detail::Codec<T>::view(entry + snapshot_detail::Codec<KEY>::bytes_at(entry,base+header->bytes));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string MappedHashMap<KEY,T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "MappedHashMap[" << file_name << "](size=" << size() << ",slots=" << (header == nullptr ? 0 : header->slots)
+         << ",bytes=" << bytes << ")";
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Probe from the home slot until an empty slot (the index is at most half full);
+//  only keys with the same hash code are compared
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+const char* MappedHashMap<KEY,T,thash>::find_key (const LOOKUP& key, int hash_code) const {
+  if (header == nullptr)
+    return nullptr;
+  std::uint64_t mask = header->slots-1;
+  for (std::uint64_t s = snapshot_detail::home_slot(hash_code,header->slots); index[s].entry != 0; s = (s+1) & mask)
+    if (index[s].hash_code == hash_code && snapshot_detail::Codec<KEY>::equals(base+index[s].entry,key))
+      return base+index[s].entry;
+  return nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void MappedHashMap<KEY,T,thash>::verify_hash () const {
+  int checked = 0;
+  for (std::uint64_t s=0; s<header->slots && checked<verify_keys; ++s)
+    if (index[s].entry != 0) {
+      if (index[s].entry < header->entries_offset || index[s].entry >= header->bytes)
+        throw IcsError("MappedHashMap::constructor: corrupt snapshot index in "+file_name);
+      snapshot_detail::skip<KEY>(base+index[s].entry,base+header->bytes,"MappedHashMap::constructor("+file_name+")");
+      if (hash(snapshot_detail::Codec<KEY>::read(base+index[s].entry)) != index[s].hash_code)
+        throw TemplateFunctionError("MappedHashMap::constructor: snapshot was saved with a different hash function");
+      ++checked;
+    }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void MappedHashMap<KEY,T,thash>::unmap () {
+  if (base != nullptr)
+    ::munmap(const_cast<char*>(base),bytes);
+  base   = nullptr;
+  bytes  = 0;
+  header = nullptr;
+  index  = nullptr;
+}
+
+}
+
+#endif /* MAPPED_HASH_MAP_HPP_ */
@@ -0,0 +1,886 @@
+#ifndef ROBIN_HOOD_MAP_HPP_
+#define ROBIN_HOOD_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <utility>              //For std::swap function
+#include <initializer_list>
+#include <algorithm>
+#include <cstdint>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+//An open-addressing map with the same interface as HashMap: all entries live in
+//  one flat array (no LN per entry) and collisions are resolved by linear probing
+//  using the Robin Hood rule (an entry closer to its home bin gives up its slot to
+//  one further from its home bin). erase uses backward-shift deletion, so there
+//  are no tombstones and every probe sequence stays as short as possible.
+//Because at least one slot must stay empty, load_threshold is limited to
+//  max_load_threshold (values <= 0 or above it use that limit).
+//The number of slots is always a power of 2 (see compress), and each slot caches
+//  its entry's hash code, so growing re-places entries without re-hashing keys
+//  and find_key compares a key only when the codes match.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> class RobinHoodMap {
+  public:
+    typedef ics::pair<KEY,T>   Entry;
+    typedef int (*hashfunc) (const KEY& a);
+
+    //Destructor/Constructors
+    ~RobinHoodMap ();
+
+    RobinHoodMap          (double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    explicit RobinHoodMap (int initial_bins, double the_load_threshold = 0.75, int (*chash)(const KEY& k) = undefinedhash<KEY>);
+    RobinHoodMap          (const RobinHoodMap<KEY,T,thash>& to_copy, double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    RobinHoodMap          (RobinHoodMap<KEY,T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
+    explicit RobinHoodMap (const std::initializer_list<Entry>& il, double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit RobinHoodMap (const Iterable& i, double the_load_threshold = 0.75, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+
+    //Queries
+    bool      empty      () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    bool      has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    put   (const KEY& key, T&& value);
+    T    erase (const KEY& key);
+    void clear ();
+    void reserve (size_type n);   //Grow now, so putting up to n keys never rehashes
+    void rehash  (size_type n);   //Use >= n slots (rounded up to a power of 2, and enough for size() keys)
+
+    //If key is not in the map, put key with the value T(args...); if it is, leave
+    //  its value unchanged (and construct no T). Either way, return key's value.
+    template <class... Args>
+    T&   emplace (const KEY& key, Args&&... args);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    size_type put_all(const Iterable& i);
+
+
+    //Operators
+
+    T&       operator [] (const KEY&);
+    const T& operator [] (const KEY&) const;
+    RobinHoodMap<KEY,T,thash>& operator = (const RobinHoodMap<KEY,T,thash>& rhs);
+    RobinHoodMap<KEY,T,thash>& operator = (RobinHoodMap<KEY,T,thash>&& rhs);   //Swaps contents (and hash) with rhs
+    bool operator == (const RobinHoodMap<KEY,T,thash>& rhs) const;
+    bool operator != (const RobinHoodMap<KEY,T,thash>& rhs) const;
+
+    template<class KEY2,class T2, int (*hash2)(const KEY2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const RobinHoodMap<KEY2,T2,hash2>& m);
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of RobinHoodMap<KEY,T,thash>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        RobinHoodMap<KEY,T,thash>::Iterator& operator ++ ();
+        RobinHoodMap<KEY,T,thash>::Iterator  operator ++ (int);
+        bool operator == (const RobinHoodMap<KEY,T,thash>::Iterator& rhs) const;
+        bool operator != (const RobinHoodMap<KEY,T,thash>::Iterator& rhs) const;
+        Entry& operator *  () const;
+        Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const RobinHoodMap<KEY,T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator RobinHoodMap<KEY,T,thash>::begin () const;
+        friend Iterator RobinHoodMap<KEY,T,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it):
+        //  backward-shift deletion moves the following entry into the erased slot
+        //Iteration starts just after an empty slot (start) and wraps around the array
+        //  back to it; because start stays empty, no shift ever moves an entry from the
+        //  front of the iteration order to its back (so no entry is seen twice)
+        size_type                  start;    //An empty slot (-1 for an empty map)
+        size_type                  current;  //Slot index; stop: -1
+        RobinHoodMap<KEY,T,thash>* ref_map;
+        size_type                  expected_mod_count;
+        bool                       can_erase = true;
+
+        //Helper methods
+        void advance_cursors();
+
+        //Called in friends begin/end
+        Iterator(RobinHoodMap<KEY,T,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    static constexpr double max_load_threshold = 0.9;  //Must be < 1: probing stops only at an empty slot
+
+
+  private:
+    int (*hash)(const KEY& k);  //Hashing function used (from template or constructor)
+    Entry* map    = nullptr;    //Pointer to array of slots (entries stored in place)
+    int*   dist   = nullptr;    //Parallel array: probe distance of slot's entry from its home bin; -1 = empty
+    int*   codes  = nullptr;    //Parallel array: hash code of slot's entry (meaningless if dist is -1)
+    double load_threshold;      //used/bins <= load_threshold
+    size_type bins      = 1;    //# slots in array: a power of 2 (so compress can mask)
+    size_type used      = 0;    //Cache for number of key->value pairs in the hash table
+    size_type mod_count = 0;    //For sensing concurrent modification
+
+
+    //Helper methods
+    size_type compress         (int hash_code)           const;  //hash_code ranged to [0,bins-1]
+    size_type find_key         (const KEY& key, int hash_code) const;  //Returns index of key's slot or -1
+    size_type place            (Entry e, int hash_code);         //Robin Hood insert (key not present); returns e's slot
+    void  remove_slot          (size_type slot);                 //Backward-shift delete of the entry at slot
+    void  copy_table           (const RobinHoodMap<KEY,T,thash>& from); //Copy slots/dists/codes (same hash and bins)
+    size_type bins_for         (size_type n)             const;  //Fewest slots holding n keys within load_threshold
+    static size_type power_of_2_bins (size_type at_least);       //Smallest power of 2 >= at_least (and >= 1)
+
+    void  allocate_table       (size_type new_bins);             //Allocate empty map/dist/codes of new_bins slots
+    void  ensure_load_threshold(size_type new_used);             //Reallocate if load_factor > load_threshold
+    void  resize_table         (size_type new_bins);             //Re-place all entries (by their cached codes) in new_bins slots
+    void  delete_table         ();                               //Deallocate map/dist/codes (all == nullptr)
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//RobinHoodMap class and related definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+constexpr double RobinHoodMap<KEY,T,thash>::max_load_threshold;
+
+
+//Destructor/Constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::~RobinHoodMap() {
+  delete_table();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::RobinHoodMap(double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("RobinHoodMap::default constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("RobinHoodMap::default constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::RobinHoodMap(int initial_bins, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold), bins(initial_bins) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("RobinHoodMap::length constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("RobinHoodMap::length constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(power_of_2_bins(bins));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::RobinHoodMap(const RobinHoodMap<KEY,T,thash>& to_copy, double the_load_threshold, int (*chash)(const KEY& a))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    hash = to_copy.hash;
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("RobinHoodMap::copy constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  if (hash == to_copy.hash && (double)to_copy.used/to_copy.bins <= load_threshold)
+    copy_table(to_copy);
+  else {
+    allocate_table(bins_for(to_copy.used));
+    for (size_type s=0; s<to_copy.bins; ++s)
+      if (to_copy.dist[s] != -1)
+        put(to_copy.map[s].first,to_copy.map[s].second);
+  }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::RobinHoodMap(RobinHoodMap<KEY,T,thash>&& to_move)
+: hash(to_move.hash), load_threshold(to_move.load_threshold) {
+  allocate_table(bins);        //Becomes to_move's (empty) table after swapping
+  std::swap(map, to_move.map);
+  std::swap(dist,to_move.dist);
+  std::swap(codes,to_move.codes);
+  std::swap(bins,to_move.bins);
+  std::swap(used,to_move.used);
+  ++to_move.mod_count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::RobinHoodMap(const std::initializer_list<Entry>& il, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("RobinHoodMap::initializer_list constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("RobinHoodMap::initializer_list constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(il.size()));
+
+  for (const Entry& m_entry : il)
+    put(m_entry.first,m_entry.second);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class Iterable>
+RobinHoodMap<KEY,T,thash>::RobinHoodMap(const Iterable& i, double the_load_threshold, int (*chash)(const KEY& k))
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<KEY>)
+    throw TemplateFunctionError("RobinHoodMap::Iterable constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
+    throw TemplateFunctionError("RobinHoodMap::Iterable constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(bins_for(i.size()));
+
+  for (const Entry& m_entry : i)
+    put(m_entry.first,m_entry.second);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::empty() const {
+  return used == 0;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type RobinHoodMap<KEY,T,thash>::size() const {
+  return used;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::has_key (const KEY& key) const {
+  return find_key(key,hash(key)) != -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::has_value (const T& value) const {
+  for (size_type s=0; s<bins; ++s)
+    if (dist[s] != -1 && value == map[s].second)
+      return true;
+
+  return false;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string RobinHoodMap<KEY,T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "RobinHoodMap[";
+  if (bins != 0) {
+    answer << std::endl;
+    for (size_type s=0; s<bins; ++s) {
+      answer << "  slot[" << s << "] = ";
+      if (dist[s] == -1)
+        answer << "EMPTY" << std::endl;
+      else
+        answer << map[s].first << "->" << map[s].second << " (dist=" << dist[s] << ")" << std::endl;
+    }
+  }
+  answer  << "](load_threshold=" << load_threshold << ",bins=" << bins << ",used=" <<used <<",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T RobinHoodMap<KEY,T,thash>::put(const KEY& key, const T& value) {
+  T to_return;
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1) {
+    to_return = map[s].second;
+    map[s].second = value;
+  }else{
+    to_return = value;
+    ensure_load_threshold(used+1);
+    ++used;
+    place(Entry(key,value),code);
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T RobinHoodMap<KEY,T,thash>::put(const KEY& key, T&& value) {
+  T to_return;
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1) {
+    to_return = std::move(map[s].second);
+    map[s].second = std::move(value);
+  }else{
+    to_return = value;
+    ensure_load_threshold(used+1);
+    ++used;
+    place(Entry(key,std::move(value)),code);
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T RobinHoodMap<KEY,T,thash>::erase(const KEY& key) {
+  size_type s = find_key(key,hash(key));
+  if (s == -1) {
+    std::ostringstream answer;
+    answer << "RobinHoodMap::erase: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+  }
+  T to_return = std::move(map[s].second);
+  remove_slot(s);
+
+  --used;
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::clear() {
+  //Keep the slot array; just empty every slot
+  for (size_type s=0; s<bins; ++s)
+    if (dist[s] != -1) {
+      map[s]  = Entry();
+      dist[s] = -1;
+    }
+
+  used = 0;
+  ++mod_count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::reserve(size_type n) {
+  if (bins_for(n) > bins)
+    rehash(bins_for(n));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::rehash(size_type n) {
+  size_type new_bins = power_of_2_bins(std::max(n,bins_for(used)));
+  ++mod_count;
+  if (new_bins != bins)
+    resize_table(new_bins);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class Iterable>
+size_type RobinHoodMap<KEY,T,thash>::put_all(const Iterable& i) {
+  reserve(used+size_hint(i));
+  size_type count = 0;
+  for (const Entry& m_entry : i) {
+    ++count;
+    put(m_entry.first, m_entry.second);
+  }
+
+  return count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class... Args>
+T& RobinHoodMap<KEY,T,thash>::emplace(const KEY& key, Args&&... args) {
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1)
+    return map[s].second;
+
+  ensure_load_threshold(used+1);
+  ++used;
+  ++mod_count;
+  s = place(Entry(key,T(std::forward<Args>(args)...)),code);
+  return map[s].second;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T& RobinHoodMap<KEY,T,thash>::operator [] (const KEY& key) {
+  int code = hash(key);
+  size_type s = find_key(key,code);
+  if (s != -1)
+    return map[s].second;
+
+  ensure_load_threshold(used+1);
+  ++used;
+  ++mod_count;
+  s = place(Entry(key,T()),code);   //bins may have changed in ensure_load_threshold!
+  return map[s].second;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const T& RobinHoodMap<KEY,T,thash>::operator [] (const KEY& key) const {
+  size_type s = find_key(key,hash(key));
+  if (s != -1)
+    return map[s].second;
+
+  std::ostringstream answer;
+  answer << "RobinHoodMap::operator []: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>& RobinHoodMap<KEY,T,thash>::operator = (const RobinHoodMap<KEY,T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  if (hash == rhs.hash && (double)rhs.used/rhs.bins <= load_threshold) {
+    delete_table();
+    copy_table(rhs);
+  }else{
+    clear();
+    for (size_type s=0; s<rhs.bins; ++s)
+      if (rhs.dist[s] != -1)
+        put(rhs.map[s].first,rhs.map[s].second);
+  }
+  ++mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>& RobinHoodMap<KEY,T,thash>::operator = (RobinHoodMap<KEY,T,thash>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(hash,          rhs.hash);
+  std::swap(load_threshold,rhs.load_threshold);
+  std::swap(map,           rhs.map);
+  std::swap(dist,          rhs.dist);
+  std::swap(codes,         rhs.codes);
+  std::swap(bins,          rhs.bins);
+  std::swap(used,          rhs.used);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::operator == (const RobinHoodMap<KEY,T,thash>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.size())
+    return false;
+
+  for (size_type s=0; s<bins; ++s)
+    if (dist[s] != -1) {
+      // Uses ! and ==, so != on T need not be defined
+      size_type rhs_s = rhs.find_key(map[s].first, rhs.hash == hash ? codes[s] : rhs.hash(map[s].first));
+      if (rhs_s == -1 || !(map[s].second == rhs.map[rhs_s].second))
+        return false;
+    }
+
+  return true;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::operator != (const RobinHoodMap<KEY,T,thash>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::ostream& operator << (std::ostream& outs, const RobinHoodMap<KEY,T,thash>& m) {
+  outs << "map[";
+
+  size_type printed = 0;
+  for (size_type s=0; s<m.bins; ++s)
+    if (m.dist[s] != -1)
+      outs << (printed++ == 0? "" : ",") << m.map[s].first << "->" << m.map[s].second;
+
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto RobinHoodMap<KEY,T,thash>::begin () const -> RobinHoodMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<RobinHoodMap<KEY,T,thash>*>(this),true);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto RobinHoodMap<KEY,T,thash>::end () const -> RobinHoodMap<KEY,T,thash>::Iterator {
+  return Iterator(const_cast<RobinHoodMap<KEY,T,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Multiply-shift, as in HashMap: the high 32 bits of hash_code * 2^64/phi depend
+//  on all of hash_code's bits, so a mask (no divide, and no abs of INT_MIN)
+//  spreads even similar codes over the power-of-2 slots
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type RobinHoodMap<KEY,T,thash>::compress (int hash_code) const {
+  std::uint64_t mixed = (std::uint64_t(std::uint32_t(hash_code)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  return size_type(mixed & std::uint64_t(bins-1));
+}
+
+
+//Entries with key in them can only be at distance d from home when dist == d,
+//  and the Robin Hood invariant lets the search stop at the first slot whose
+//  entry is closer to its home than the probe is to key's home
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type RobinHoodMap<KEY,T,thash>::find_key (const KEY& key, int hash_code) const {
+  size_type s = compress(hash_code);
+  for (int d=0; dist[s] >= d; ++d, s = (s+1 == bins ? 0 : s+1))
+    if (dist[s] == d && codes[s] == hash_code && key == map[s].first)
+      return s;
+
+  return -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type RobinHoodMap<KEY,T,thash>::place (Entry e, int hash_code) {
+  Entry     to_place(std::move(e));
+  int       d      = 0;
+  size_type answer = -1;
+  for (size_type s = compress(hash_code); /*See body*/; s = (s+1 == bins ? 0 : s+1), ++d) {
+    if (dist[s] == -1) {
+      map[s]   = std::move(to_place);
+      dist[s]  = d;
+      codes[s] = hash_code;
+      return answer == -1 ? s : answer;
+    }
+    if (dist[s] < d) {        //Rob the richer entry: it continues probing instead
+      std::swap(map[s],to_place);
+      std::swap(dist[s],d);
+      std::swap(codes[s],hash_code);
+      if (answer == -1)
+        answer = s;
+    }
+  }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::remove_slot (size_type slot) {
+  size_type next = (slot+1 == bins ? 0 : slot+1);
+  for (; dist[next] > 0; slot = next, next = (next+1 == bins ? 0 : next+1)) {
+    map[slot]   = std::move(map[next]);
+    dist[slot]  = dist[next]-1;
+    codes[slot] = codes[next];
+  }
+  map[slot]  = Entry();       //release key/value resources held by the vacated slot
+  dist[slot] = -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::copy_table (const RobinHoodMap<KEY,T,thash>& from) {
+  bins  = from.bins;
+  used  = from.used;
+  map   = new Entry[bins];
+  dist  = new int[bins];
+  codes = new int[bins];
+  for (size_type s=0; s<bins; ++s) {
+    dist[s] = from.dist[s];
+    if (dist[s] != -1) {
+      map[s]   = from.map[s];
+      codes[s] = from.codes[s];
+    }
+  }
+}
+
+
+//+1: at least one slot stays empty (load_threshold < 1 makes n/load_threshold > n)
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type RobinHoodMap<KEY,T,thash>::bins_for (size_type n) const {
+  return power_of_2_bins(size_type(n/load_threshold)+1);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type RobinHoodMap<KEY,T,thash>::power_of_2_bins (size_type at_least) {
+  size_type result = 1;
+  while (result < at_least)
+    result = result * 2;
+  return result;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::allocate_table (size_type new_bins) {
+  bins  = new_bins;
+  map   = new Entry[bins];
+  dist  = new int[bins];
+  codes = new int[bins];
+  for (size_type s=0; s<bins; ++s)
+    dist[s] = -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::ensure_load_threshold(size_type new_used) {
+  if (double(new_used)/double(bins) <= load_threshold)
+    return;
+
+  resize_table(2*bins);
+}
+
+
+//Each entry goes to the home slot of its cached code: no key is hashed again
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::resize_table(size_type new_bins) {
+  Entry*    old_map   = map;
+  int*      old_dist  = dist;
+  int*      old_codes = codes;
+  size_type old_bins  = bins;
+
+  allocate_table(new_bins);
+  for (size_type s=0; s<old_bins; ++s)
+    if (old_dist[s] != -1)
+      place(std::move(old_map[s]),old_codes[s]);
+
+  delete [] old_map;
+  delete [] old_dist;
+  delete [] old_codes;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::delete_table () {
+  delete[] map;
+  delete[] dist;
+  delete[] codes;
+  map   = nullptr;
+  dist  = nullptr;
+  codes = nullptr;
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void RobinHoodMap<KEY,T,thash>::Iterator::advance_cursors(){
+  for (size_type s = (current+1 == ref_map->bins ? 0 : current+1); s != start; s = (s+1 == ref_map->bins ? 0 : s+1))
+    if (ref_map->dist[s] != -1) {
+      current = s;
+      return;
+    }
+
+  //Not found: wrapped back around to start
+  current = -1;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::Iterator::Iterator(RobinHoodMap<KEY,T,thash>* iterate_over, bool from_begin)
+: start(-1), current(-1), ref_map(iterate_over), expected_mod_count(ref_map->mod_count) {
+  if (!from_begin || ref_map->empty())
+    return;
+
+  //A non-empty map always has an empty slot (load_threshold < 1)
+  for (start=0; ref_map->dist[start] != -1; ++start)
+    ;
+  current = start;
+  advance_cursors();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+RobinHoodMap<KEY,T,thash>::Iterator::~Iterator()
+{}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto RobinHoodMap<KEY,T,thash>::Iterator::erase() -> Entry {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("RobinHoodMap::Iterator::erase Iterator cursor already erased");
+  if (current == -1)
+    throw CannotEraseError("RobinHoodMap::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  Entry to_return = std::move(ref_map->map[current]);
+  ref_map->remove_slot(current);
+
+  --ref_map->used;
+  ++ref_map->mod_count;
+  expected_mod_count = ref_map->mod_count;
+
+  //The next entry may have shifted into current; if not, move on to it now
+  if (ref_map->dist[current] == -1)
+    advance_cursors();
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+std::string RobinHoodMap<KEY,T,thash>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_map->str() << "(start=" << start << ",current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  RobinHoodMap<KEY,T,thash>::Iterator::operator ++ () -> RobinHoodMap<KEY,T,thash>::Iterator& {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::operator ++");
+
+  if (current == -1)
+    return *this;
+
+  if (can_erase)
+    advance_cursors();
+
+  can_erase = true;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto  RobinHoodMap<KEY,T,thash>::Iterator::operator ++ (int) -> RobinHoodMap<KEY,T,thash>::Iterator {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::operator ++(int)");
+
+  if (current == -1)
+    return *this;
+
+  Iterator to_return(*this);
+  if (can_erase)
+    advance_cursors();
+  can_erase = true;
+
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::Iterator::operator == (const RobinHoodMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("RobinHoodMap::Iterator::operator ==");
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::operator ==");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("RobinHoodMap::Iterator::operator ==");
+
+  return this->current == rhsASI->current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool RobinHoodMap<KEY,T,thash>::Iterator::operator != (const RobinHoodMap<KEY,T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("RobinHoodMap::Iterator::operator !=");
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::operator !=");
+  if (ref_map != rhsASI->ref_map)
+    throw ComparingDifferentIteratorsError("RobinHoodMap::Iterator::operator !=");
+
+  return this->current != rhsASI->current;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+pair<KEY,T>& RobinHoodMap<KEY,T,thash>::Iterator::operator *() const {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::operator *");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("RobinHoodMap::Iterator::operator * Iterator illegal");
+
+  return ref_map->map[current];
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+pair<KEY,T>* RobinHoodMap<KEY,T,thash>::Iterator::operator ->() const {
+  if (expected_mod_count != ref_map->mod_count)
+    throw ConcurrentModificationError("RobinHoodMap::Iterator::operator ->");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("RobinHoodMap::Iterator::operator -> Iterator illegal");
+
+  return &(ref_map->map[current]);
+}
+
+
+}
+
+#endif /* ROBIN_HOOD_MAP_HPP_ */
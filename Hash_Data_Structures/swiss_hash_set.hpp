@@ -0,0 +1,942 @@
+#ifndef SWISS_HASH_SET_HPP_
+#define SWISS_HASH_SET_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>          //SSE2: _mm_cmpeq_epi8/_mm_movemask_epi8 test a group at once
+#define ICS_SWISS_SSE2 1
+#endif
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+//A set with the same interface as HashSet, stored as a flat open-addressing
+//  table probed a group of 16 slots at a time (the "Swiss table" layout).
+//Each slot has a one-byte control code: EMPTY, DELETED, or (for a full slot)
+//  7 bits of its element's hash. A lookup compares all 16 control bytes of a
+//  group in one SSE2 instruction and only calls == on elements whose 7 bits
+//  match, so most absent elements are rejected without touching any element.
+//Without SSE2 the same group test is done one byte at a time.
+//load_threshold counts full and DELETED slots, and is limited to max_load_threshold.
+//
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+template<class T, int (*thash)(const T& a) = undefinedhash<T>> class SwissHashSet {
+  public:
+    typedef int (*hashfunc) (const T& a);
+
+    //Destructor/Constructors
+    ~SwissHashSet ();
+
+    SwissHashSet (double the_load_threshold = 0.875, int (*chash)(const T& a) = undefinedhash<T>);
+    explicit SwissHashSet (int initial_bins, double the_load_threshold = 0.875, int (*chash)(const T& k) = undefinedhash<T>);
+    SwissHashSet (const SwissHashSet<T,thash>& to_copy, double the_load_threshold = 0.875, int (*chash)(const T& a) = undefinedhash<T>);
+    SwissHashSet (SwissHashSet<T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
+    explicit SwissHashSet (const std::initializer_list<T>& il, double the_load_threshold = 0.875, int (*chash)(const T& a) = undefinedhash<T>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit SwissHashSet (const Iterable& i, double the_load_threshold = 0.875, int (*chash)(const T& a) = undefinedhash<T>);
+
+
+    //Queries
+    bool      empty      () const;
+    size_type size       () const;
+    bool      contains   (const T& element) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    bool contains_all (const Iterable& i) const;
+
+
+    //Commands
+    int  insert (const T& element);
+    int  insert (T&& element);
+    int  erase  (const T& element);
+    void clear  ();
+    void reserve(size_type n);   //Grow now, so inserting up to n elements never rehashes
+    void rehash (size_type n);   //Use >= n slots (fewer if possible, but enough for size() elements); drops DELETEDs
+
+    //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
+
+    template <class Iterable>
+    size_type insert_all(const Iterable& i);
+
+    template <class Iterable>
+    size_type erase_all(const Iterable& i);
+
+    template<class Iterable>
+    size_type retain_all(const Iterable& i);
+
+    template<class... Args>
+    int emplace(Args&&... args);
+
+
+    //Operators
+    SwissHashSet<T,thash>& operator = (const SwissHashSet<T,thash>& rhs);
+    SwissHashSet<T,thash>& operator = (SwissHashSet<T,thash>&& rhs);  //Swaps contents (and hash) with rhs
+    bool operator == (const SwissHashSet<T,thash>& rhs) const;
+    bool operator != (const SwissHashSet<T,thash>& rhs) const;
+    bool operator <= (const SwissHashSet<T,thash>& rhs) const;
+    bool operator <  (const SwissHashSet<T,thash>& rhs) const;
+    bool operator >= (const SwissHashSet<T,thash>& rhs) const;
+    bool operator >  (const SwissHashSet<T,thash>& rhs) const;
+
+    template<class T2, int (*hash2)(const T2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const SwissHashSet<T2,hash2>& s);
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of SwissHashSet<T,thash>
+        ~Iterator();
+        T           erase();
+        std::string str  () const;
+        SwissHashSet<T,thash>::Iterator& operator ++ ();
+        SwissHashSet<T,thash>::Iterator  operator ++ (int);
+        bool operator == (const SwissHashSet<T,thash>::Iterator& rhs) const;
+        bool operator != (const SwissHashSet<T,thash>::Iterator& rhs) const;
+        T& operator *  () const;
+        T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SwissHashSet<T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator SwissHashSet<T,thash>::begin () const;
+        friend Iterator SwissHashSet<T,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current's slot was erased (elements never move, so ++ goes on from there)
+        size_type               current;  //Slot index; stop: -1
+        SwissHashSet<T,thash>*  ref_set;
+        size_type               expected_mod_count;
+        bool                    can_erase = true;
+
+        //Helper methods
+        void advance_cursors();
+
+        //Called in friends begin/end
+        Iterator(SwissHashSet<T,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    static constexpr int    group_width        = 16;
+    static constexpr double max_load_threshold = 0.875;  //Must be < 1: a lookup stops only at a group with an EMPTY slot
+
+
+  private:
+    static constexpr signed char EMPTY   = -128;  //0b10000000
+    static constexpr signed char DELETED = -2;    //0b11111110; full slots are 0b0hhhhhhh
+
+    int (*hash)(const T& k);        //Hashing function used (from template or constructor)
+    T*           set     = nullptr; //Pointer to array of slots (elements stored in place)
+    signed char* ctrl    = nullptr; //Parallel array of control bytes (EMPTY, DELETED, or 7 hash bits)
+    double load_threshold;          //(used+deleted)/bins <= load_threshold
+    size_type bins      = group_width;  //# slots in array: always (a power of 2) * group_width
+    size_type used      = 0;            //Cache for number of values in the hash table
+    size_type deleted   = 0;            //# DELETED slots (count against load_threshold until a rehash)
+    size_type mod_count = 0;            //For sensing concurrent modification
+
+
+    //Helper methods
+    std::uint64_t hash_mix          (const T& element)          const;  //Spread all bits of hash(element) over 64 bits
+    size_type find_element          (const T& element)          const;  //Returns index of element's slot or -1
+    size_type find_insert_slot      (std::uint64_t h)           const;  //Returns first EMPTY/DELETED slot on h's probe
+    void  insert_new                (T element, std::uint64_t h);       //Store element (known not present)
+    void  erase_slot                (size_type s);                      //Mark s EMPTY (or DELETED, if probes pass it)
+
+    size_type bins_for              (size_type n)               const;  //Fewest slots (group_width * a power of 2) holding n within load_threshold
+    void  allocate_table            (size_type new_bins);               //Allocate all-EMPTY set/ctrl of new_bins slots
+    void  ensure_load_threshold     (size_type new_used);               //Rehash (bigger, or same size to drop DELETEDs)
+    void  resize_table              (size_type new_bins);               //Move all elements into a new table of new_bins slots
+    void  delete_table              ();                                 //Deallocate set/ctrl (both == nullptr)
+
+    static unsigned match_byte      (const signed char* group, signed char c);  //Bit i set iff group[i] == c
+    static unsigned match_available (const signed char* group);                 //Bit i set iff group[i] EMPTY/DELETED
+    static int      lowest_bit      (unsigned mask);                            //Index of lowest 1 bit (mask != 0)
+};
+
+
+
+
+
+//SwissHashSet class and related definitions
+
+template<class T, int (*thash)(const T& a)>
+constexpr int SwissHashSet<T,thash>::group_width;
+
+template<class T, int (*thash)(const T& a)>
+constexpr double SwissHashSet<T,thash>::max_load_threshold;
+
+template<class T, int (*thash)(const T& a)>
+constexpr signed char SwissHashSet<T,thash>::EMPTY;
+
+template<class T, int (*thash)(const T& a)>
+constexpr signed char SwissHashSet<T,thash>::DELETED;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Destructor/Constructors
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::~SwissHashSet() {
+  delete_table();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::SwissHashSet(double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<T>)
+    throw TemplateFunctionError("SwissHashSet::default constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+    throw TemplateFunctionError("SwissHashSet::default constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(group_width);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::SwissHashSet(int initial_bins, double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<T>)
+    throw TemplateFunctionError("SwissHashSet::length constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+    throw TemplateFunctionError("SwissHashSet::length constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  size_type new_bins = group_width;
+  while (new_bins < initial_bins)
+    new_bins *= 2;
+  allocate_table(new_bins);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::SwissHashSet(const SwissHashSet<T,thash>& to_copy, double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<T>)
+    hash = to_copy.hash;
+  if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+    throw TemplateFunctionError("SwissHashSet::copy constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(group_width);
+  ensure_load_threshold(to_copy.used);
+  for (size_type s=0; s<to_copy.bins; ++s)
+    if (to_copy.ctrl[s] >= 0)
+      insert_new(to_copy.set[s],hash_mix(to_copy.set[s]));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::SwissHashSet(SwissHashSet<T,thash>&& to_move)
+: hash(to_move.hash), load_threshold(to_move.load_threshold) {
+  allocate_table(group_width);
+  std::swap(set,    to_move.set);
+  std::swap(ctrl,   to_move.ctrl);
+  std::swap(bins,   to_move.bins);
+  std::swap(used,   to_move.used);
+  std::swap(deleted,to_move.deleted);
+  ++to_move.mod_count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::SwissHashSet(const std::initializer_list<T>& il, double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<T>)
+    throw TemplateFunctionError("SwissHashSet::initializer_list constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+    throw TemplateFunctionError("SwissHashSet::initializer_list constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(group_width);
+  ensure_load_threshold(il.size());
+
+  for (const T& v : il)
+    insert(v);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+SwissHashSet<T,thash>::SwissHashSet(const Iterable& i, double the_load_threshold, int (*chash)(const T& a))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+  if (hash == (hashfunc)undefinedhash<T>)
+    throw TemplateFunctionError("SwissHashSet::Iterable constructor: neither specified");
+  if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+    throw TemplateFunctionError("SwissHashSet::Iterable constructor: both specified and different");
+
+  if (load_threshold <= 0 || load_threshold > max_load_threshold)
+    load_threshold = max_load_threshold;
+  allocate_table(group_width);
+  ensure_load_threshold(i.size());
+
+  for (const T& v : i)
+    insert(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::empty() const {
+  return used == 0;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type SwissHashSet<T,thash>::size() const {
+  return used;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::contains (const T& element) const {
+  return find_element(element) != -1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+std::string SwissHashSet<T,thash>::str() const {
+  std::ostringstream answer;
+  answer << "SwissHashSet[";
+  if (bins != 0) {
+    answer << std::endl;
+    for (size_type g=0; g<bins; g+=group_width) {
+      answer << "group[" << g/group_width << "] = ";
+      for (size_type s=g; s<g+group_width; ++s)
+        if (ctrl[s] == EMPTY)
+          answer << "EMPTY ";
+        else if (ctrl[s] == DELETED)
+          answer << "DELETED ";
+        else
+          answer << set[s] << "(" << int(ctrl[s]) << ") ";
+      answer << std::endl;
+    }
+  }
+
+  answer  << "(load_threshold=" << load_threshold << ",bins=" << bins << ",used=" << used << ",deleted=" << deleted << ",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template <class Iterable>
+bool SwissHashSet<T,thash>::contains_all(const Iterable& i) const {
+  for (const T& v : i)
+    if (!contains(v))
+      return false;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, int (*thash)(const T& a)>
+int SwissHashSet<T,thash>::insert(const T& element) {
+  if (find_element(element) != -1)
+    return 0;
+
+  ensure_load_threshold(used+1);
+  insert_new(element,hash_mix(element));
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int SwissHashSet<T,thash>::insert(T&& element) {
+  if (find_element(element) != -1)
+    return 0;
+
+  ensure_load_threshold(used+1);
+  std::uint64_t h = hash_mix(element);
+  insert_new(std::move(element),h);
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int SwissHashSet<T,thash>::erase(const T& element) {
+  size_type s = find_element(element);
+  if (s == -1)
+    return 0;
+
+  erase_slot(s);
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::clear() {
+  for (size_type s=0; s<bins; ++s)
+    if (ctrl[s] != EMPTY) {
+      if (ctrl[s] >= 0)
+        set[s] = T();     //release resources held by the element
+      ctrl[s] = EMPTY;
+    }
+
+  used    = 0;
+  deleted = 0;
+  ++mod_count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::reserve(size_type n) {
+  if (bins_for(n) > bins)
+    rehash(bins_for(n));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::rehash(size_type n) {
+  size_type new_bins = bins_for(used);
+  while (new_bins < n)
+    new_bins *= 2;
+  ++mod_count;
+  if (new_bins != bins || deleted != 0)
+    resize_table(new_bins);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+size_type SwissHashSet<T,thash>::insert_all(const Iterable& i) {
+  reserve(used+size_hint(i));
+  size_type count = 0;
+  for (const T& v : i)
+    count += insert(v);
+
+  return count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+size_type SwissHashSet<T,thash>::erase_all(const Iterable& i) {
+  size_type count = 0;
+  for (const T& v : i)
+    count += erase(v);
+  return count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+size_type SwissHashSet<T,thash>::retain_all(const Iterable& i) {
+  SwissHashSet<T,thash> s(i,load_threshold,hash);
+
+  size_type count = 0;
+  for (size_type b=0; b<bins; ++b)
+    if (ctrl[b] >= 0 && !s.contains(set[b])) {
+      erase_slot(b);
+      ++count;
+    }
+
+  if (count != 0)
+    ++mod_count;
+  return count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class... Args>
+int SwissHashSet<T,thash>::emplace(Args&&... args) {
+  return insert(T(std::forward<Args>(args)...));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>& SwissHashSet<T,thash>::operator = (const SwissHashSet<T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  hash = rhs.hash;
+  clear();
+  ensure_load_threshold(rhs.used);
+  for (size_type s=0; s<rhs.bins; ++s)
+    if (rhs.ctrl[s] >= 0)
+      insert_new(rhs.set[s],hash_mix(rhs.set[s]));
+
+  ++mod_count;
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>& SwissHashSet<T,thash>::operator = (SwissHashSet<T,thash>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(hash,          rhs.hash);
+  std::swap(load_threshold,rhs.load_threshold);
+  std::swap(set,           rhs.set);
+  std::swap(ctrl,          rhs.ctrl);
+  std::swap(bins,          rhs.bins);
+  std::swap(used,          rhs.used);
+  std::swap(deleted,       rhs.deleted);
+  ++mod_count;
+  ++rhs.mod_count;
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::operator == (const SwissHashSet<T,thash>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.size())
+    return false;
+
+  for (size_type s=0; s<bins; ++s)
+    if (ctrl[s] >= 0 && !rhs.contains(set[s]))
+      return false;
+
+  return true;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::operator != (const SwissHashSet<T,thash>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::operator <= (const SwissHashSet<T,thash>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used > rhs.size())
+    return false;
+
+  for (size_type s=0; s<bins; ++s)
+    if (ctrl[s] >= 0 && !rhs.contains(set[s]))
+      return false;
+
+  return true;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::operator < (const SwissHashSet<T,thash>& rhs) const {
+  if (this == &rhs)
+    return false;
+  if (used >= rhs.size())
+    return false;
+
+  for (size_type s=0; s<bins; ++s)
+    if (ctrl[s] >= 0 && !rhs.contains(set[s]))
+      return false;
+
+  return true;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::operator >= (const SwissHashSet<T,thash>& rhs) const {
+  return rhs <= *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::operator > (const SwissHashSet<T,thash>& rhs) const {
+  return rhs < *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+std::ostream& operator << (std::ostream& outs, const SwissHashSet<T,thash>& s) {
+  outs  << "set[";
+
+  size_type printed = 0;
+  for (size_type b=0; b<s.bins; ++b)
+    if (s.ctrl[b] >= 0)
+      outs << (printed++ == 0? "" : ",") << s.set[b];
+
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, int (*thash)(const T& a)>
+auto SwissHashSet<T,thash>::begin () const -> SwissHashSet<T,thash>::Iterator {
+  return Iterator(const_cast<SwissHashSet<T,thash>*>(this),true);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+auto SwissHashSet<T,thash>::end () const -> SwissHashSet<T,thash>::Iterator {
+  return Iterator(const_cast<SwissHashSet<T,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Multiplicative mixing: the user's hash is often poor in its low bits, which
+//  would otherwise pick both the group (high bits) and the 7 control bits
+template<class T, int (*thash)(const T& a)>
+std::uint64_t SwissHashSet<T,thash>::hash_mix (const T& element) const {
+  std::uint64_t h = std::uint32_t(hash(element)) * UINT64_C(0x9E3779B97F4A7C15);
+  return h ^ (h >> 29);
+}
+
+
+//Probe groups in triangular order (g, g+1, g+3, g+6, ...) which visits every
+//  group because the # of groups is a power of 2; an element can only be
+//  beyond a group that had no EMPTY slot when it was inserted
+template<class T, int (*thash)(const T& a)>
+size_type SwissHashSet<T,thash>::find_element (const T& element) const {
+  std::uint64_t h      = hash_mix(element);
+  signed char   h2     = static_cast<signed char>(h & 0x7F);
+  size_type     groups = bins/group_width;
+  size_type     g      = size_type((h >> 7) & std::uint64_t(groups-1));
+  for (size_type probe=1; probe<=groups; ++probe) {
+    const signed char* group = ctrl + g*group_width;
+    for (unsigned m = match_byte(group,h2); m != 0; m &= m-1) {
+      size_type s = g*group_width + lowest_bit(m);
+      if (element == set[s])
+        return s;
+    }
+    if (match_byte(group,EMPTY) != 0)
+      return -1;
+    g = (g + probe) & (groups-1);
+  }
+
+  return -1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type SwissHashSet<T,thash>::find_insert_slot (std::uint64_t h) const {
+  size_type groups = bins/group_width;
+  size_type g      = size_type((h >> 7) & std::uint64_t(groups-1));
+  for (size_type probe=1; /*See body*/; ++probe) {
+    unsigned m = match_available(ctrl + g*group_width);
+    if (m != 0)
+      return g*group_width + lowest_bit(m);
+    g = (g + probe) & (groups-1);
+  }
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::insert_new (T element, std::uint64_t h) {
+  size_type s = find_insert_slot(h);
+  if (ctrl[s] == DELETED)
+    --deleted;
+  ctrl[s] = static_cast<signed char>(h & 0x7F);
+  set[s]  = std::move(element);
+  ++used;
+}
+
+
+//If s's group still has an EMPTY slot, no probe ever continued past it, so
+//  s can become EMPTY too; otherwise a DELETED marker keeps those probes going
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::erase_slot (size_type s) {
+  const signed char* group = ctrl + (s - s%group_width);
+  if (match_byte(group,EMPTY) != 0)
+    ctrl[s] = EMPTY;
+  else {
+    ctrl[s] = DELETED;
+    ++deleted;
+  }
+  set[s] = T();         //release resources held by the element
+  --used;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type SwissHashSet<T,thash>::bins_for (size_type n) const {
+  size_type answer = group_width;
+  while (double(n)/double(answer) > load_threshold)
+    answer *= 2;
+  return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::allocate_table (size_type new_bins) {
+  bins = new_bins;
+  set  = new T[bins];
+  ctrl = new signed char[bins];
+  for (size_type s=0; s<bins; ++s)
+    ctrl[s] = EMPTY;
+  deleted = 0;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::ensure_load_threshold(size_type new_used) {
+  if (double(new_used+deleted)/double(bins) <= load_threshold)
+    return;
+
+  //Only grow if the live elements need it; otherwise rehashing at the same size removes DELETEDs
+  size_type new_bins = bins;
+  while (double(new_used)/double(new_bins) > load_threshold/2)
+    new_bins *= 2;
+
+  resize_table(new_bins);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::resize_table (size_type new_bins) {
+  T*           old_set  = set;
+  signed char* old_ctrl = ctrl;
+  size_type    old_bins = bins;
+
+  allocate_table(new_bins);
+  used = 0;
+  for (size_type s=0; s<old_bins; ++s)
+    if (old_ctrl[s] >= 0) {
+      std::uint64_t h = hash_mix(old_set[s]);
+      insert_new(std::move(old_set[s]),h);
+    }
+
+  delete [] old_set;
+  delete [] old_ctrl;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::delete_table () {
+  delete[] set;
+  delete[] ctrl;
+  set  = nullptr;
+  ctrl = nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+unsigned SwissHashSet<T,thash>::match_byte (const signed char* group, signed char c) {
+#ifdef ICS_SWISS_SSE2
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes,_mm_set1_epi8(c))));
+#else
+  unsigned answer = 0;
+  for (int i=0; i<group_width; ++i)
+    if (group[i] == c)
+      answer |= 1u << i;
+  return answer;
+#endif
+}
+
+
+//EMPTY and DELETED are the only control bytes < -1 (full slots are >= 0)
+template<class T, int (*thash)(const T& a)>
+unsigned SwissHashSet<T,thash>::match_available (const signed char* group) {
+#ifdef ICS_SWISS_SSE2
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return unsigned(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1),bytes)));
+#else
+  unsigned answer = 0;
+  for (int i=0; i<group_width; ++i)
+    if (group[i] < -1)
+      answer |= 1u << i;
+  return answer;
+#endif
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int SwissHashSet<T,thash>::lowest_bit (unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  int answer = 0;
+  for (; (mask & 1u) == 0; mask >>= 1)
+    ++answer;
+  return answer;
+#endif
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, int (*thash)(const T& a)>
+void SwissHashSet<T,thash>::Iterator::advance_cursors() {
+  for (size_type s=current+1; s<ref_set->bins; ++s)
+    if (ref_set->ctrl[s] >= 0) {
+      current = s;
+      return;
+    }
+
+  //Not found
+  current = -1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::Iterator::Iterator(SwissHashSet<T,thash>* iterate_over, bool from_begin)
+: current(-1), ref_set(iterate_over), expected_mod_count(ref_set->mod_count) {
+  if (from_begin)
+     advance_cursors();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+SwissHashSet<T,thash>::Iterator::~Iterator()
+{}
+
+
+template<class T, int (*thash)(const T& a)>
+T SwissHashSet<T,thash>::Iterator::erase() {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("SwissHashSet::Iterator::erase Iterator cursor already erased");
+  if (current == -1)
+    throw CannotEraseError("SwissHashSet::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  T to_return = std::move(ref_set->set[current]);
+  ref_set->erase_slot(current);
+  ++ref_set->mod_count;
+  expected_mod_count = ref_set->mod_count;
+
+  return to_return;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+std::string SwissHashSet<T,thash>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_set->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+auto  SwissHashSet<T,thash>::Iterator::operator ++ () -> SwissHashSet<T,thash>::Iterator& {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::operator ++");
+
+  if (current == -1)
+    return *this;
+
+  advance_cursors();
+  can_erase = true;
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+auto  SwissHashSet<T,thash>::Iterator::operator ++ (int) -> SwissHashSet<T,thash>::Iterator {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::operator ++(int)");
+
+  if (current == -1)
+    return *this;
+
+  Iterator to_return = Iterator(*this);
+  advance_cursors();
+  can_erase = true;
+  return to_return;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::Iterator::operator == (const SwissHashSet<T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("SwissHashSet::Iterator::operator ==");
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::operator ==");
+  if (ref_set != rhsASI->ref_set)
+    throw ComparingDifferentIteratorsError("SwissHashSet::Iterator::operator ==");
+
+  return this->current == rhsASI->current;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool SwissHashSet<T,thash>::Iterator::operator != (const SwissHashSet<T,thash>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("SwissHashSet::Iterator::operator !=");
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::operator !=");
+  if (ref_set != rhsASI->ref_set)
+    throw ComparingDifferentIteratorsError("SwissHashSet::Iterator::operator !=");
+
+  return this->current != rhsASI->current;
+}
+
+template<class T, int (*thash)(const T& a)>
+T& SwissHashSet<T,thash>::Iterator::operator *() const {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::operator *");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("SwissHashSet::Iterator::operator * Iterator illegal");
+
+  return ref_set->set[current];
+}
+
+template<class T, int (*thash)(const T& a)>
+T* SwissHashSet<T,thash>::Iterator::operator ->() const {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SwissHashSet::Iterator::operator ->");
+  if (!can_erase || current == -1)
+    throw IteratorPositionIllegal("SwissHashSet::Iterator::operator -> Iterator illegal");
+
+  return &(ref_set->set[current]);
+}
+
+}
+
+#endif /* SWISS_HASH_SET_HPP_ */
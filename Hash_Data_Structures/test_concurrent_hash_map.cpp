@@ -0,0 +1,352 @@
+//#include <iostream>
+//#include <sstream>
+//#include <algorithm>                 // std::random_shuffle
+//#include <thread>
+//#include <vector>
+//#include "ics46goody.hpp"
+//#include "gtest/gtest.h"
+//#include "array_priority_queue.hpp"  // must leave in for use in iterator_simple
+//#include "array_queue.hpp"           // must leave in for use in iterator_erase
+//#include "concurrent_hash_map.hpp"
+//
+//int hash_string  (const std::string& s) {std::hash<std::string> str_hash; return str_hash(s);}
+//int hash_int     (const int& s)         {std::hash<int> str_hash; return str_hash(s);}
+//int hash_string2 (const std::string& s) {std::hash<std::string> str_hash; return 1+str_hash(s);}
+//
+//typedef ics::pair<std::string,int>                          EntryType;
+//typedef ics::ConcurrentHashMap<std::string,int,hash_string> MapTypeStr;
+//typedef ics::ConcurrentHashMap<int,int,hash_int>            MapTypeInt;
+//typedef ics::ConcurrentHashMap<std::string,int>             MapTypeNone;
+//
+//int test_size  = ics::prompt_int ("Enter large scale test size");
+//int trace      = ics::prompt_bool("Trace large scale test",false);
+//int speed_size = ics::prompt_int ("Enter large scale speed test size");
+//
+//bool gt_Entry (const EntryType& a, const EntryType& b)
+//{return a.first < b.first;}
+//
+//class MapTest : public ::testing::Test {
+//protected:
+//    virtual void SetUp()    {}
+//    virtual void TearDown() {}
+//};
+//
+//
+//template<class T>
+//void load(T& m, std::string keys, int values[]) {
+//  for (unsigned i=0; i<keys.size(); ++i)
+//    m.put(std::string(1,keys[i]),values[i]);
+//  delete[] values;
+//}
+//
+//
+//template<class T>
+//::testing::AssertionResult mapsto(const T& m, std::string keys, int values[]) {
+//  for (unsigned i=0; i<keys.size(); ++i)
+//    if (m.get(std::string(1,keys[i])) != values[i]) {
+//      delete[] values;
+//      return ::testing::AssertionFailure();
+//    }
+//  delete[] values;
+//  return ::testing::AssertionSuccess();
+//}
+//
+//
+//
+//TEST_F(MapTest, empty) {
+//  MapTypeStr m;
+//  ASSERT_TRUE(m.empty());
+//  ASSERT_EQ(0,m.size());
+//  ASSERT_FALSE(m.has_key("a"));
+//  ASSERT_FALSE(m.has_value(1));
+//}
+//
+//
+//TEST_F(MapTest, put_get) {
+//  MapTypeStr m;
+//  ASSERT_THROW(m.get("d"),ics::KeyError);
+//
+//  ASSERT_EQ(4,m.put("d",4));
+//  ASSERT_FALSE(m.empty());
+//  ASSERT_EQ(1, m.size());
+//  ASSERT_TRUE(mapsto(m,"d",new int[1]{4}));
+//  ASSERT_FALSE(m.has_key("x"));
+//  ASSERT_FALSE(m.has_value(100));
+//
+//  ASSERT_EQ(1,m.put("a",1));
+//  ASSERT_EQ(3,m.put("c",3));
+//  ASSERT_EQ(3, m.size());
+//  ASSERT_TRUE(mapsto(m,"dac",new int[3]{4,1,3}));
+//
+//  ASSERT_EQ(4,m.put("d",40));
+//  ASSERT_EQ(3, m.size());
+//  ASSERT_TRUE(mapsto(m,"dac",new int[3]{40,1,3}));
+//  ASSERT_TRUE(m.has_value(40));
+//  ASSERT_FALSE(m.has_value(4));
+//}
+//
+//
+//TEST_F(MapTest, erase) {
+//  MapTypeStr m;
+//  load(m,"fcijbdegah", new int[10]{6,3,9,10,2,4,5,7,1,8});
+//  ASSERT_EQ(1,m.erase("a"));
+//  ASSERT_THROW(m.erase("x"),ics::KeyError);
+//  ASSERT_THROW(m.erase("a"),ics::KeyError);
+//  ASSERT_TRUE(mapsto(m,"fcijbdegh",new int[9]{6,3,9,10,2,4,5,7,8}));
+//  ASSERT_FALSE(m.has_key("a"));
+//  ASSERT_EQ(9,m.size());
+//
+//  for (char c : std::string("fcijbdegh"))
+//    m.erase(std::string(1,c));
+//  ASSERT_TRUE(m.empty());
+//}
+//
+//
+//TEST_F(MapTest, clear) {
+//  MapTypeStr m;
+//  m.clear();
+//  ASSERT_TRUE(m.empty());
+//
+//  load(m,"bcead",new int[5]{1,2,3,4,5});
+//  m.clear();
+//  ASSERT_TRUE(m.empty());
+//  ASSERT_EQ(0, m.size());
+//  ASSERT_FALSE(m.has_key("a"));
+//  ASSERT_FALSE(m.has_value(1));
+//}
+//
+//
+//TEST_F(MapTest, compute) {
+//  MapTypeStr m;
+//  ASSERT_EQ(1,m.compute("a",[](int& v){++v;}));
+//  ASSERT_EQ(2,m.compute("a",[](int& v){++v;}));
+//  ASSERT_EQ(20,m.compute("a",[](int& v){v *= 10;}));
+//  ASSERT_EQ(0,m.compute("b",[](int&){}));
+//  ASSERT_EQ(2,m.size());
+//  ASSERT_TRUE(mapsto(m,"ab",new int[2]{20,0}));
+//}
+//
+//
+//TEST_F(MapTest, put_all) {
+//  MapTypeStr m({EntryType("a",1),EntryType("b",2),EntryType("c",3)});
+//  MapTypeStr m2;
+//  ASSERT_EQ(3,m2.put_all(m));
+//  ASSERT_EQ(3,m2.size());
+//  ASSERT_TRUE(mapsto(m2,"abc",new int[3]{1,2,3}));
+//
+//  std::ostringstream out;
+//  MapTypeStr m3({EntryType("a",1)});
+//  out << m3;
+//  ASSERT_EQ("map[a->1]",out.str());
+//}
+//
+//
+//TEST_F(MapTest, iterator_simple) {
+//  std::string qkeys  [] ={"a","b","c","d","e","f","g","h","i","j"};
+//  int         qvalues[] ={1,2,3,4,5,6,7,8,9,10};
+//  ics::ArrayPriorityQueue<EntryType> q(gt_Entry);
+//
+//  MapTypeStr m(4);
+//  load(m,"fcijbdegah", new int[10]{6,3,9,10,2,4,5,7,1,8});
+//
+//  //for-each iterator (using .begin/.end)
+//  for (EntryType x : m)
+//    q.enqueue(x);
+//  int i = 0;
+//  for (EntryType x : q) {
+//    ASSERT_EQ(qkeys[i],    x.first);
+//    ASSERT_EQ(qvalues[i++],x.second);
+//  }
+//
+//  //explicit iterator (using .begin/.end and it++)
+//  q.clear();
+//  for (MapTypeStr::Iterator it(m.begin()); it != m.end(); it++)
+//    q.enqueue(*it);
+//  ASSERT_EQ(10,q.size());
+//  ASSERT_EQ(10,m.size());
+//  ASSERT_TRUE(m.begin() != m.end());
+//
+//  MapTypeStr empty;
+//  ASSERT_TRUE(empty.begin() == empty.end());
+//  ASSERT_THROW(*empty.begin(),ics::IteratorPositionIllegal);
+//}
+//
+//
+//TEST_F(MapTest, iterator_weakly_consistent) {
+//  MapTypeInt m;
+//  for (int i=0; i<100; ++i)
+//    m.put(i,i);
+//
+//  //changing the map while iterating is allowed: every entry present for
+//  //  the whole iteration (the even keys) is seen exactly once
+//  int seen_even = 0;
+//  for (MapTypeInt::Iterator it(m.begin()); it != m.end(); ++it) {
+//    if (it->first >= 100)
+//      continue;
+//    if (it->first % 2 == 0) {
+//      ++seen_even;
+//      if (m.has_key(it->first+1))
+//        m.erase(it->first+1);
+//    }
+//    m.put(1000+it->first,0);
+//  }
+//  ASSERT_EQ(50,seen_even);
+//  for (int i=0; i<100; ++i)
+//    ASSERT_EQ(i%2 == 0, m.has_key(i));
+//  ASSERT_TRUE(m.has_key(1000));
+//}
+//
+//
+//TEST_F(MapTest, iterator_erase) {
+//  MapTypeStr m;
+//  load(m,"fcijbdegah", new int[10]{6,3,9,10,2,4,5,7,1,8});
+//  MapTypeStr::Iterator it(m.begin());
+//
+//  EntryType e = it.erase();
+//  ASSERT_FALSE(m.has_key(e.first));
+//  ASSERT_THROW(it.erase(),ics::CannotEraseError);
+//  ASSERT_THROW(*it,ics::IteratorPositionIllegal);
+//  ++it;
+//  ASSERT_TRUE(m.has_key(it->first));
+//
+//  //erase all in the map
+//  for (MapTypeStr::Iterator it(m.begin()); it != m.end(); ++it) {
+//    std::string k  = (*it).first;
+//    int         v  = (*it).second;
+//    ASSERT_EQ(m.get(k), v);
+//    EntryType kv = it.erase();
+//    ASSERT_EQ(k,kv.first);
+//    ASSERT_EQ(v,kv.second);
+//    ASSERT_FALSE(m.has_key(k));
+//  }
+//  ASSERT_TRUE(m.empty());
+//  ASSERT_THROW(m.end().erase(),ics::CannotEraseError);
+//}
+//
+//
+//TEST_F(MapTest, constructors) {
+//  MapTypeStr m(1);
+//  load(m,"abc",new int[3]{1,2,3});
+//  ASSERT_TRUE(mapsto(m,"abc",new int[3]{1,2,3}));
+//
+//  MapTypeNone m2(ics::ConcurrentHashMap<std::string,int>::default_shard_count,1.0,hash_string);
+//  ASSERT_EQ(1,m2.put("a",1));
+//  ASSERT_THROW(MapTypeNone m3,ics::TemplateFunctionError);
+//  ASSERT_THROW(MapTypeStr m4(1.0,hash_string2),ics::TemplateFunctionError);
+//
+//  MapTypeStr m5(1.0,hash_string);
+//  ASSERT_EQ(1,m5.put("a",1));
+//}
+//
+//
+//TEST_F(MapTest, threads) {
+//  MapTypeInt m;
+//  const int threads = 4, keys = 1000, rounds = 100;
+//
+//  //every thread counts up every key: no increment may be lost
+//  std::vector<std::thread> workers;
+//  for (int t=0; t<threads; ++t)
+//    workers.push_back(std::thread([&m,keys,rounds](){
+//      for (int r=0; r<rounds; ++r)
+//        for (int k=0; k<keys; ++k)
+//          m.compute(k,[](int& v){++v;});
+//    }));
+//  for (std::thread& w : workers)
+//    w.join();
+//  ASSERT_EQ(keys,m.size());
+//  for (int k=0; k<keys; ++k)
+//    ASSERT_EQ(threads*rounds,m.get(k));
+//
+//  //each thread puts and erases its own keys, while another iterates
+//  workers.clear();
+//  for (int t=0; t<threads; ++t)
+//    workers.push_back(std::thread([&m,t,keys](){
+//      for (int k=keys*(t+1); k<keys*(t+2); ++k)
+//        m.put(k,t);
+//      for (int k=keys*(t+1); k<keys*(t+2); k+=2)
+//        m.erase(k);
+//    }));
+//  workers.push_back(std::thread([&m,keys](){
+//    int count = 0;
+//    for (const ics::pair<int,int>& kv : m)
+//      if (kv.first < keys)
+//        ++count;
+//    ASSERT_EQ(keys,count);
+//  }));
+//  for (std::thread& w : workers)
+//    w.join();
+//  ASSERT_EQ(keys+threads*keys/2,m.size());
+//}
+//
+//
+//TEST_F(MapTest, large_scale) {
+//  MapTypeInt lm;
+//
+//  std::vector<int> values;
+//  for (int i=0; i<test_size; ++i)
+//    values.push_back(i);
+//  std::random_shuffle(values.begin(),values.end());
+//
+//
+//  for (int test=1; test<=5; ++test) {
+//    int inserted = 0;
+//    int erased   = 0;
+//    while (erased != test_size) {
+//      int to_insert = ics::rand_range(0,test_size-inserted);
+//      if (trace)
+//        std::cout << "Inserted " << to_insert << std::endl;
+//      for (int i=0; i <to_insert; ++i) {
+//        ASSERT_EQ(inserted,lm.put(values[inserted],inserted));
+//        ASSERT_TRUE(lm.has_key(values[inserted]));
+//        ASSERT_EQ(inserted,lm.get(values[inserted]));
+//        ++inserted;
+//      };
+//
+//      int to_erase = ics::rand_range(0,inserted-erased);
+//      if (trace)
+//        std::cout << "Erased " << to_erase << std::endl;
+//      for (int i=0; i <to_erase; ++i) {
+//        ASSERT_EQ(erased,lm.erase(values[erased]));
+//        ASSERT_FALSE(lm.has_key(values[erased]));
+//        ++erased;
+//      }
+//    }
+//  }
+//  ASSERT_TRUE(lm.empty());
+//  ASSERT_EQ(0,lm.size());
+//
+//}
+//
+//
+//TEST_F(MapTest, large_scale_speed) {
+//  MapTypeInt lm;
+//
+//  std::vector<int> values;
+//  for (int i=0; i<speed_size; ++i)
+//    values.push_back(i);
+//  std::random_shuffle(values.begin(),values.end());
+//
+//  for (int test=1; test<=5; ++test) {
+//    int inserted = 0;
+//    int erased   = 0;
+//    while (erased != speed_size) {
+//      int to_insert = ics::rand_range(0,speed_size-inserted);
+//      for (int i=0; i <to_insert; ++i) {
+//        lm.put(values[inserted],inserted);
+//        ++inserted;
+//      }
+//
+//      int to_erase = ics::rand_range(0,inserted-erased);
+//      for (int i=0; i <to_erase; ++i) {
+//        lm.erase(values[erased]);
+//        ++erased;
+//      }
+//    }
+//  }
+//}
+//
+//
+//int main(int argc, char **argv) {
+//  ::testing::InitGoogleTest(&argc, argv);
+//  return RUN_ALL_TESTS();
+//}
@@ -0,0 +1,161 @@
+//#include <iostream>
+//#include <sstream>
+//#include <string>
+//#include <vector>
+//#include <algorithm>
+//#include "gtest/gtest.h"
+//#include "cuckoo_hash_map.hpp"
+//
+//int hash_int     (const int& s)         {std::hash<int> str_hash; return str_hash(s);}
+//int hash_collide (const int& i)         {return i%4;}   //Few hash codes: overflows their buckets into the stash
+//int hash_tens    (const int& i)         {return i/10;}  //10 keys per hash code: 2 more than its buckets hold
+//
+//typedef ics::CuckooHashMap<int,int,hash_int>     MapTypeInt;
+//typedef ics::CuckooHashMap<int,int,hash_collide> MapTypeCollide;
+//typedef ics::CuckooHashMap<int,int,hash_tens>    MapTypeTens;
+//
+//
+//class MapTest : public ::testing::Test {
+//protected:
+//    virtual void SetUp()    {}
+//    virtual void TearDown() {}
+//};
+//
+//
+//template<class Map>
+//long long bins_of(const Map& m) {
+//  std::string s = m.str();
+//  return std::stoll(s.substr(s.rfind(",bins=")+6));
+//}
+//
+//
+////Entries no table can place: those beyond the 2*slots that a hash code's two buckets hold
+//template<class Map>
+//int stuck(const Map& m, int (*h)(const int&)) {
+//  std::vector<int> codes;
+//  for (const ics::pair<int,int>& e : m)
+//    codes.push_back(h(e.first));
+//  std::sort(codes.begin(),codes.end());
+//  int answer = 0;
+//  for (unsigned i=0, j=0; i<codes.size(); i=j) {
+//    while (j<codes.size() && codes[j] == codes[i])
+//      ++j;
+//    answer += std::max(0,int(j-i)-2*Map::slots);
+//  }
+//  return answer;
+//}
+//
+//
+//TEST_F(MapTest, kicks) {
+//  MapTypeInt m(1,0.95);                //high load: most puts kick entries to their other bucket
+//  for (int i=0; i<15000; ++i) {
+//    m[i] = i;
+//    ASSERT_TRUE(m.stash_size() <= MapTypeInt::max_stash);
+//  }
+//  ASSERT_EQ(4096,bins_of(m));          //15000 keys fill 92% of 4096 buckets: grown only for the load
+//  for (int i=0; i<15000; ++i)
+//    ASSERT_EQ(i,m[i]);
+//  ASSERT_FALSE(m.has_key(15000));
+//
+//  for (int i=0; i<15000; i+=2)         //erasing and putting again at high load kicks again
+//    ASSERT_EQ(i,m.erase(i));
+//  for (int i=15000; i<22000; i+=2)
+//    m[i] = i;
+//  ASSERT_EQ(4096,bins_of(m));
+//  for (int i=0; i<22000; ++i)
+//    ASSERT_EQ(i < 15000 ? i%2 == 1 : i%2 == 0, m.has_key(i));
+//}
+//
+//
+//TEST_F(MapTest, stash) {
+//  MapTypeCollide c(64);                //under half full: keys with equal hash codes share both buckets
+//  for (int i=0; i<40; ++i)
+//    c[i] = i;
+//  ASSERT_EQ(40-4*2*MapTypeCollide::slots,c.stash_size());
+//  ASSERT_EQ(c.stash_size(),stuck(c,hash_collide));
+//  ASSERT_EQ(64,bins_of(c));            //growing cannot place them: the table did not grow
+//  for (int i=0; i<40; ++i)
+//    ASSERT_EQ(i,c[i]);
+//
+//  MapTypeCollide copy(c);
+//  ASSERT_EQ(c,copy);
+//  MapTypeCollide assigned;
+//  assigned = c;
+//  ASSERT_EQ(c,assigned);
+//
+//  //erase every third key: moves within buckets/stash must keep all others reachable
+//  for (int i=0; i<40; i+=3)
+//    ASSERT_EQ(i,c.erase(i));
+//  for (int i=0; i<40; ++i)
+//    ASSERT_EQ(i%3 != 0, c.has_key(i));
+//
+//  //erase the rest while iterating: each entry (in a bucket or the stash) is seen once
+//  int seen = 0;
+//  for (MapTypeCollide::Iterator it(c.begin()); it != c.end(); ++it) {
+//    ics::pair<int,int> kv = it.erase();
+//    ASSERT_EQ(kv.first,kv.second);
+//    ASSERT_FALSE(c.has_key(kv.first));
+//    ++seen;
+//  }
+//  ASSERT_EQ(26,seen);
+//  ASSERT_TRUE(c.empty());
+//  ASSERT_EQ(0,c.stash_size());
+//}
+//
+//
+//TEST_F(MapTest, stash_is_bounded) {
+//  //However full the table, the stash holds at most max_stash entries that some table could place
+//  MapTypeTens small;
+//  MapTypeTens roomy(1024);
+//  for (int i=0; i<2000; ++i) {
+//    small[i] = i;
+//    roomy[i] = i;
+//    ASSERT_LE(small.stash_size(),MapTypeTens::max_stash+stuck(small,hash_tens));
+//    ASSERT_LE(roomy.stash_size(),MapTypeTens::max_stash+stuck(roomy,hash_tens));
+//  }
+//  ASSERT_LE(2*200,small.stash_size());    //each hash code has 2 keys more than its buckets hold
+//  for (int i=0; i<2000; ++i) {
+//    ASSERT_EQ(i,small[i]);
+//    ASSERT_EQ(i,roomy[i]);
+//  }
+//  ASSERT_EQ(small,roomy);
+//}
+//
+//
+//TEST_F(MapTest, grow) {
+//  MapTypeInt m;
+//  long long bins = bins_of(m);
+//  for (int i=0; i<5000; ++i) {
+//    m.put(i,i);
+//    if (bins_of(m) != bins) {          //each growth re-places every entry (the stash's too)
+//      ASSERT_EQ(2*bins,bins_of(m));
+//      bins = bins_of(m);
+//      for (int j=0; j<=i; ++j)
+//        ASSERT_EQ(j,m[j]);
+//    }
+//  }
+//  ASSERT_TRUE(m.stash_size() <= MapTypeInt::max_stash);
+//  ASSERT_LE(5000,0.9*bins*MapTypeInt::slots);
+//
+//  MapTypeCollide c;                    //growing with stuck entries re-places them (they stay stuck)
+//  for (int i=0; i<40; ++i)
+//    c[i] = i;
+//  c.rehash(4096);
+//  ASSERT_EQ(4096,bins_of(c));
+//  ASSERT_EQ(stuck(c,hash_collide),c.stash_size());
+//  for (int i=0; i<40; ++i)
+//    ASSERT_EQ(i,c[i]);
+//
+//  int seen = 0;                        //each entry is seen once after growing
+//  for (const ics::pair<int,int>& e : m) {
+//    ASSERT_EQ(e.first,e.second);
+//    ++seen;
+//  }
+//  ASSERT_EQ(5000,seen);
+//}
+//
+//
+//int main(int argc, char **argv) {
+//  ::testing::InitGoogleTest(&argc, argv);
+//  return RUN_ALL_TESTS();
+//}
@@ -0,0 +1,217 @@
+//#include <iostream>
+//#include <sstream>
+//#include <string>
+//#include <vector>
+//#include "gtest/gtest.h"
+//#include "dense_hash_map.hpp"
+//
+//int hash_string  (const std::string& s) {std::hash<std::string> str_hash; return str_hash(s);}
+//int hash_int     (const int& s)         {std::hash<int> str_hash; return str_hash(s);}
+//int hash_collide (const int& i)         {return i%4;}  //Long probe runs: exercises DELETED index slots
+//
+//typedef ics::pair<std::string,int>                     EntryType;
+//typedef ics::DenseHashMap<std::string,int,hash_string> MapTypeStr;
+//typedef ics::DenseHashMap<int,int,hash_int>            MapTypeInt;
+//typedef ics::DenseHashMap<int,int,hash_collide>        MapTypeCollide;
+//
+//
+//class MapTest : public ::testing::Test {
+//protected:
+//    virtual void SetUp()    {}
+//    virtual void TearDown() {}
+//};
+//
+//
+////Puts keys[i]->i+1, in order
+//void load(MapTypeStr& m, std::string keys) {
+//  for (unsigned i=0; i<keys.size(); ++i)
+//    m.put(std::string(1,keys[i]),i+1);
+//}
+//
+//
+////The keys, in iteration order
+//std::string order(const MapTypeStr& m) {
+//  std::string answer;
+//  for (const EntryType& e : m)
+//    answer += e.first;
+//  return answer;
+//}
+//
+//
+//template<class Map>
+//std::vector<int> order_int(const Map& m) {
+//  std::vector<int> answer;
+//  for (const ics::pair<int,int>& e : m)
+//    answer.push_back(e.first);
+//  return answer;
+//}
+//
+//
+////# dense slots in use (entries and holes), from str()
+//template<class Map>
+//long long filled_of(const Map& m) {
+//  std::string s = m.str();
+//  return std::stoll(s.substr(s.rfind(",filled=")+8));
+//}
+//
+//
+//TEST_F(MapTest, insertion_order) {
+//  MapTypeStr m;
+//  load(m,"fcijbdegah");
+//  ASSERT_EQ("fcijbdegah",order(m));
+//
+//  //putting an old key keeps its place (and emplacing one changes nothing)
+//  ASSERT_EQ(2,m.put("c",13));
+//  ASSERT_EQ(13,m.emplace("c",99));
+//  m["k"] = 11;
+//  ASSERT_EQ("fcijbdegahk",order(m));
+//  ASSERT_EQ(13,m["c"]);
+//
+//  //order does not matter to ==
+//  MapTypeStr m2;
+//  load(m2,"abcdefghij");
+//  ASSERT_NE(m,m2);
+//  m2.put("k",11);
+//  for (const EntryType& e : m)
+//    m2.put(e.first,e.second);
+//  ASSERT_EQ(m,m2);
+//  ASSERT_EQ("abcdefghijk",order(m2));
+//}
+//
+//
+//TEST_F(MapTest, erase_keeps_order) {
+//  MapTypeStr m;
+//  load(m,"fcijbdegah");
+//  m.erase("f");                        //first, middle, and last: each leaves a hole
+//  m.erase("b");
+//  m.erase("h");
+//  ASSERT_EQ("cijdega",order(m));
+//  ASSERT_EQ(10,filled_of(m));
+//
+//  //erasing and putting a key again moves it last
+//  m.erase("i");
+//  m.put("i",19);
+//  m.put("f",16);
+//  ASSERT_EQ("cjdegaif",order(m));
+//  ASSERT_EQ(19,m["i"]);
+//  ASSERT_EQ(12,filled_of(m));
+//}
+//
+//
+//TEST_F(MapTest, compaction_keeps_order) {
+//  MapTypeInt m;
+//  for (int i=0; i<1000; ++i)
+//    m[i] = i;
+//
+//  //erase from the back, so the survivors' dense slots shift when holes are squeezed out
+//  bool compacted = false;
+//  for (int i=999; i>=0; --i)
+//    if (i%10 != 0) {
+//      ASSERT_EQ(i,m.erase(i));
+//      compacted = compacted || filled_of(m) == m.size();
+//    }
+//  ASSERT_TRUE(compacted);              //erase squeezed out the holes at least once
+//  ASSERT_EQ(100,m.size());
+//  std::vector<int> keys = order_int(m);
+//  ASSERT_EQ(100u,keys.size());
+//  for (int i=0; i<100; ++i)
+//    ASSERT_EQ(10*i,keys[i]);
+//  for (int i=0; i<1000; ++i) {
+//    ASSERT_EQ(i%10 == 0, m.has_key(i));
+//  }
+//}
+//
+//
+//TEST_F(MapTest, growth_keeps_order) {
+//  MapTypeInt m;
+//  for (int i=0; i<100; ++i)
+//    m[i] = i;
+//  for (int i=1; i<100; i+=2)           //holes, but not enough for erase to squeeze them out
+//    m.erase(i);
+//  ASSERT_EQ(100,filled_of(m));
+//
+//  for (int i=100; i<1000; ++i)         //growing rebuilds dense without the holes
+//    m[i] = i;
+//  ASSERT_EQ(m.size(),filled_of(m));
+//  std::vector<int> keys = order_int(m);
+//  ASSERT_EQ(950u,keys.size());
+//  for (int i=0; i<50; ++i)
+//    ASSERT_EQ(2*i,keys[i]);
+//  for (int i=50; i<950; ++i)
+//    ASSERT_EQ(i+50,keys[i]);
+//}
+//
+//
+//TEST_F(MapTest, iterator_erase_keeps_order) {
+//  MapTypeStr m;
+//  load(m,"abcdefghij");
+//
+//  //Iterator::erase leaves holes and never compacts, so iteration sees each entry once, in order
+//  std::string seen;
+//  bool erase = true;
+//  for (MapTypeStr::Iterator it = m.begin(); it != m.end(); ++it, erase = !erase) {
+//    seen += it->first;
+//    if (erase) {
+//      ASSERT_EQ(EntryType(std::string(1,seen.back()),int(seen.size())),it.erase());
+//    }
+//  }
+//  ASSERT_EQ("abcdefghij",seen);
+//  ASSERT_EQ("bdfhj",order(m));
+//  ASSERT_EQ(10,filled_of(m));
+//
+//  m.erase("d");                        //more holes than entries: erase compacts
+//  ASSERT_EQ(4,filled_of(m));
+//  m.put("a",1);
+//  ASSERT_EQ("bfhja",order(m));
+//}
+//
+//
+//TEST_F(MapTest, collisions_keep_order) {
+//  MapTypeCollide m(8);
+//  for (int i=0; i<100; ++i)
+//    m.put(i,i);
+//  for (int i=0; i<100; i+=3)           //DELETED index slots must keep all others reachable
+//    ASSERT_EQ(i,m.erase(i));
+//  for (int i=0; i<100; ++i)
+//    ASSERT_EQ(i%3 != 0, m.has_key(i));
+//
+//  m.put(0,0);                          //reuses no hole: goes last
+//  std::vector<int> keys = order_int(m);
+//  ASSERT_EQ(67u,keys.size());
+//  for (int i=0, k=1; i<66; ++i, k += (k%3 == 1 ? 1 : 2))
+//    ASSERT_EQ(k,keys[i]);
+//  ASSERT_EQ(0,keys.back());
+//}
+//
+//
+//TEST_F(MapTest, rebuilds_keep_order) {
+//  MapTypeStr m;
+//  load(m,"fcijbdegah");
+//  m.erase("j");
+//  m.erase("e");
+//
+//  MapTypeStr copy(m);                  //copies, moves, and rehashes squeeze out holes in order
+//  ASSERT_EQ("fcibdgah",order(copy));
+//  copy.rehash(1000);
+//  ASSERT_EQ("fcibdgah",order(copy));
+//  ASSERT_EQ(8,filled_of(copy));
+//  copy.shrink_to_fit();
+//  ASSERT_EQ("fcibdgah",order(copy));
+//
+//  MapTypeStr moved(std::move(copy));
+//  ASSERT_EQ("fcibdgah",order(moved));
+//  MapTypeStr assigned;
+//  assigned = moved;
+//  ASSERT_EQ("fcibdgah",order(assigned));
+//
+//  m.reserve(100);                      //rebuilding for reserve keeps the order too
+//  ASSERT_EQ("fcibdgah",order(m));
+//  m.put("j",20);
+//  ASSERT_EQ("fcibdgahj",order(m));
+//}
+//
+//
+//int main(int argc, char **argv) {
+//  ::testing::InitGoogleTest(&argc, argv);
+//  return RUN_ALL_TESTS();
+//}
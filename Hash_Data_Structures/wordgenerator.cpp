@@ -6,6 +6,7 @@
 #include <vector>
 #include <limits>                           //I used std::numeric_limits<int>::max()
 #include "ics46goody.hpp"
+#include "ics_hash.hpp"
 #include "stopwatch.hpp"
 #include "array_queue.hpp"
 #include "array_priority_queue.hpp"
@@ -16,15 +17,11 @@
 #include "hash_map.hpp"
 // Submitter jpascasc(Pascascio,Joshua)
 
-int hash_string (const std::string& s) {std::hash<std::string> str_hash; return str_hash(s);}
+int hash_string (const std::string& s) {return ics::hash_of(s);}
 int hash_int (const int& i) {std::hash<int> int_hash; return int_hash(i);}
 int hash_string2 (const std::string& s) {std::hash<std::string> str_hash; return 1 + str_hash(s);}
 int hash_queue(const ics::ArrayQueue<std::string> &q){
-    std::hash<std::string> str_hash;
-    int count = 0;
-    for(const std::string& s : q)
-        count = (31* count) + str_hash(s);
-    return count;
+    return ics::hash_fold(ics::hash_sequence(q));
 }
 
 typedef ics::ArrayQueue<std::string>         WordQueue;
@@ -128,7 +125,7 @@ WordQueue produce_text(const Corpus& corpus, const WordQueue& start, int count)
     std::string r = random_in_set(corpus[keys]);
     result.enqueue(r);
     keys.dequeue();
-    keys.enqueue(r);
+    keys.enqueue(std::move(r));
   }
 
   return result;
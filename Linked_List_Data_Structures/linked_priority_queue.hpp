@@ -6,7 +6,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "node_pool.hpp"
 #include "array_stack.hpp"      //See operator <<
 
 
@@ -32,6 +34,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
 
     LinkedPriorityQueue          (bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     LinkedPriorityQueue          (const LinkedPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    LinkedPriorityQueue          (LinkedPriorityQueue<T,tgt>&& to_move);  //Uses to_move's gt; to_move is left empty
     explicit LinkedPriorityQueue (const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -40,24 +43,30 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     int  enqueue (const T& element);
+    int  enqueue (T&& element);
     T    dequeue ();
     void clear   ();
 
+    //Enqueue T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
+
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int enqueue_all (const Iterable& i);
+    size_type enqueue_all (const Iterable& i);
 
 
     //Operators
     LinkedPriorityQueue<T,tgt>& operator = (const LinkedPriorityQueue<T,tgt>& rhs);
+    LinkedPriorityQueue<T,tgt>& operator = (LinkedPriorityQueue<T,tgt>&& rhs);  //Swaps contents (and gt) with rhs
     bool operator == (const LinkedPriorityQueue<T,tgt>& rhs) const;
     bool operator != (const LinkedPriorityQueue<T,tgt>& rhs) const;
 
@@ -94,7 +103,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
         LN*             prev;            //initialize prev to the header
         LN*             current;         //current == prev->next
         LinkedPriorityQueue<T,tgt>* ref_pq;
-        int             expected_mod_count;
+        size_type       expected_mod_count;
         bool            can_erase = true;
 
         //Called in friends begin/end
@@ -107,11 +116,11 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
 
 
   private:
-    class LN {
+    class LN : public PoolAllocated {
       public:
         LN ()                      {}
         LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+        LN (T v,  LN* n = nullptr) : value(std::move(v)), next(n){}
 
         T   value;
         LN* next = nullptr;
@@ -120,10 +129,11 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
 
     bool (*gt) (const T& a, const T& b); // The gt used by enqueue (from template or constructor)
     LN* front     =  new LN();
-    int used      =  0;                  //Cache count of nodes in linked list
-    int mod_count =  0;                  //Allows sensing concurrent modification
+    size_type used      =  0;            //Cache count of nodes in linked list
+    size_type mod_count =  0;            //Allows sensing concurrent modification
 
     //Helper methods
+    bool call_gt(const T& a, const T& b) const;  //tgt(a,b) if given (a direct call: inlinable), else gt(a,b)
     void delete_list(LN*& front);        //Deallocate all LNs, and set front's argument to nullptr;
 };
 
@@ -178,6 +188,16 @@ LinkedPriorityQueue<T,tgt>::LinkedPriorityQueue(const LinkedPriorityQueue<T,tgt>
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+LinkedPriorityQueue<T,tgt>::LinkedPriorityQueue(LinkedPriorityQueue<T,tgt>&& to_move)
+:gt(to_move.gt)
+{
+    std::swap(front,to_move.front);
+    std::swap(used,to_move.used);
+    ++to_move.mod_count;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 LinkedPriorityQueue<T,tgt>::LinkedPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
 :gt(tgt != undefinedgt<T> ? tgt : cgt)
@@ -216,7 +236,7 @@ bool LinkedPriorityQueue<T,tgt>::empty() const {
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int LinkedPriorityQueue<T,tgt>::size() const {
+size_type LinkedPriorityQueue<T,tgt>::size() const {
     return used;
 }
 
@@ -252,7 +272,24 @@ int LinkedPriorityQueue<T,tgt>::enqueue(const T& element) {
     LinkedPriorityQueue<T,tgt>::LN* node = new LinkedPriorityQueue<T,tgt>::LN(element);
     LinkedPriorityQueue<T,tgt>::LN *temp = front;
     for( ; temp->next!=nullptr; temp = temp->next){
-        if(gt(element,temp->next->value)) {
+        if(call_gt(element,temp->next->value)) {
+            node->next = temp->next;
+            break;
+        }
+    }
+    temp->next = node;
+    return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int LinkedPriorityQueue<T,tgt>::enqueue(T&& element) {
+    ++used;
+    ++mod_count;
+    LinkedPriorityQueue<T,tgt>::LN* node = new LinkedPriorityQueue<T,tgt>::LN(std::move(element));
+    LinkedPriorityQueue<T,tgt>::LN *temp = front;
+    for( ; temp->next!=nullptr; temp = temp->next){
+        if(call_gt(node->value,temp->next->value)) {
             node->next = temp->next;
             break;
         }
@@ -262,11 +299,18 @@ int LinkedPriorityQueue<T,tgt>::enqueue(const T& element) {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class... Args>
+int LinkedPriorityQueue<T,tgt>::emplace(Args&&... args) {
+    return enqueue(T(std::forward<Args>(args)...));
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T LinkedPriorityQueue<T,tgt>::dequeue() {
     if(this->empty())
         throw ics::EmptyError("LinkedPriorityQueue::dequeue");
-    T returnVal = front->next->value;
+    T returnVal = std::move(front->next->value);
     LinkedPriorityQueue<T,tgt>::LN* node = front->next;
     front->next = front->next->next;
     delete node;
@@ -284,8 +328,8 @@ void LinkedPriorityQueue<T,tgt>::clear() {
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 template <class Iterable>
-int LinkedPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
-    int count = 0;
+size_type LinkedPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
+    size_type count = 0;
     for(auto const &m : i){
         count += enqueue(m);
     }
@@ -310,8 +354,8 @@ LinkedPriorityQueue<T,tgt>& LinkedPriorityQueue<T,tgt>::operator = (const Linked
     else {
         LinkedPriorityQueue<T, tgt>::LN *ref = rhs.front;
         mod_count += rhs.used;
-        int difference = used - rhs.used;
-        for (int i = 0; i < difference; i++)
+        size_type difference = used - rhs.used;
+        for (size_type i = 0; i < difference; i++)
             dequeue();
         for (LinkedPriorityQueue<T, tgt>::LN **t = &front; (*t) != nullptr; t = &((*t)->next)) {
             if (ref != nullptr) {
@@ -327,6 +371,19 @@ LinkedPriorityQueue<T,tgt>& LinkedPriorityQueue<T,tgt>::operator = (const Linked
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+LinkedPriorityQueue<T,tgt>& LinkedPriorityQueue<T,tgt>::operator = (LinkedPriorityQueue<T,tgt>&& rhs) {
+    if(this == &rhs)
+        return *this;
+    std::swap(gt,rhs.gt);
+    std::swap(front,rhs.front);
+    std::swap(used,rhs.used);
+    ++mod_count;
+    ++rhs.mod_count;
+    return *this;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 bool LinkedPriorityQueue<T,tgt>::operator == (const LinkedPriorityQueue<T,tgt>& rhs) const {
     if(this == &rhs)
@@ -354,8 +411,8 @@ bool LinkedPriorityQueue<T,tgt>::operator != (const LinkedPriorityQueue<T,tgt>&
 template<class T, bool (*tgt)(const T& a, const T& b)>
 std::ostream& operator << (std::ostream& outs, const LinkedPriorityQueue<T,tgt>& pq) {
     outs << "priority_queue[";
-    int count = 0;
-    int max = pq.size() - 1;
+    size_type count = 0;
+    size_type max = pq.size() - 1;
     if(!(pq.empty())){
         std::stringstream sstream;
         for(const T& item : pq){
@@ -365,7 +422,7 @@ std::ostream& operator << (std::ostream& outs, const LinkedPriorityQueue<T,tgt>&
             count++;
         }
         std::string ordered = sstream.str();
-        for(int i = ordered.length() - 1; i >= 0; i--)
+        for(size_type i = ordered.length() - 1; i >= 0; i--)
             outs << ordered[i];
     }
     outs << "]:highest";
@@ -394,6 +451,12 @@ auto LinkedPriorityQueue<T,tgt>::end () const -> LinkedPriorityQueue<T,tgt>::Ite
 //
 //Private helper methods
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool LinkedPriorityQueue<T,tgt>::call_gt (const T& a, const T& b) const {
+    return tgt != (gtfunc)undefinedgt<T> ? tgt(a,b) : gt(a,b);
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 void LinkedPriorityQueue<T,tgt>::delete_list(LN*& front) {
     while(front->next != nullptr){
@@ -438,7 +501,7 @@ T LinkedPriorityQueue<T,tgt>::Iterator::erase() {
         throw ics::CannotEraseError("LinkedPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
     can_erase = false;
     LinkedPriorityQueue<T,tgt>::LN* node = current;
-    T to_return = current->value;
+    T to_return = std::move(current->value);
     if(prev == ref_pq->front){
         current = current->next;
         prev->next = current;
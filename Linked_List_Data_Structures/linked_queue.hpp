@@ -7,7 +7,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "node_pool.hpp"
 
 
 namespace ics {
@@ -20,6 +22,7 @@ template<class T> class LinkedQueue {
 
     LinkedQueue          ();
     LinkedQueue          (const LinkedQueue<T>& to_copy);
+    LinkedQueue          (LinkedQueue<T>&& to_move);  //to_move is left empty
     explicit LinkedQueue (const std::initializer_list<T>& il);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -28,24 +31,30 @@ template<class T> class LinkedQueue {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     int  enqueue (const T& element);
+    int  enqueue (T&& element);
     T    dequeue ();
     void clear   ();
 
+    //Enqueue T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
+
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int enqueue_all (const Iterable& i);
+    size_type enqueue_all (const Iterable& i);
 
 
     //Operators
     LinkedQueue<T>& operator = (const LinkedQueue<T>& rhs);
+    LinkedQueue<T>& operator = (LinkedQueue<T>&& rhs);   //Swaps contents with rhs
     bool operator == (const LinkedQueue<T>& rhs) const;
     bool operator != (const LinkedQueue<T>& rhs) const;
 
@@ -82,7 +91,7 @@ template<class T> class LinkedQueue {
         LN*             prev = nullptr;  //if nullptr, current at front of list
         LN*             current;         //current == prev->next (if prev != nullptr)
         LinkedQueue<T>* ref_queue;
-        int             expected_mod_count;
+        size_type       expected_mod_count;
         bool            can_erase = true;
 
         //Called in friends begin/end
@@ -95,11 +104,11 @@ template<class T> class LinkedQueue {
 
 
   private:
-    class LN {
+    class LN : public PoolAllocated {
       public:
         LN ()                      {}
         LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+        LN (T v,  LN* n = nullptr) : value(std::move(v)), next(n){}
 
         T   value;
         LN* next = nullptr;
@@ -108,8 +117,8 @@ template<class T> class LinkedQueue {
 
     LN* front     =  nullptr;
     LN* rear      =  nullptr;
-    int used      =  0;            //Cache count of nodes in linked list
-    int mod_count =  0;            //Alllows sensing concurrent modification
+    size_type used      =  0;      //Cache count of nodes in linked list
+    size_type mod_count =  0;      //Alllows sensing concurrent modification
 
     //Helper methods
     void delete_list(LN*& front);  //Deallocate all LNs, and set front's argument to nullptr;
@@ -146,6 +155,15 @@ LinkedQueue<T>::LinkedQueue(const LinkedQueue<T>& to_copy) {
 }
 
 
+template<class T>
+LinkedQueue<T>::LinkedQueue(LinkedQueue<T>&& to_move) {
+    std::swap(front,to_move.front);
+    std::swap(rear,to_move.rear);
+    std::swap(used,to_move.used);
+    ++to_move.mod_count;
+}
+
+
 template<class T>
 LinkedQueue<T>::LinkedQueue(const std::initializer_list<T>& il) {
     for(const T& elem : il)
@@ -173,7 +191,7 @@ bool LinkedQueue<T>::empty() const {
 
 
 template<class T>
-int LinkedQueue<T>::size() const {
+size_type LinkedQueue<T>::size() const {
     return used;
 }
 
@@ -229,12 +247,34 @@ int LinkedQueue<T>::enqueue(const T& element) {
 }
 
 
+template<class T>
+int LinkedQueue<T>::enqueue(T&& element) {
+    LinkedQueue<T>::LN *node = new LinkedQueue<T>::LN(std::move(element));
+    if(front == nullptr)
+       front = rear = node;
+    else{
+        rear->next = node;
+        rear = node;
+    }
+    ++mod_count;
+    ++used;
+    return 1;
+}
+
+
+template<class T>
+template<class... Args>
+int LinkedQueue<T>::emplace(Args&&... args) {
+    return enqueue(T(std::forward<Args>(args)...));
+}
+
+
 template<class T>
 T LinkedQueue<T>::dequeue() {
     if(empty()){
         throw ics::EmptyError("LinkedQueue::dequeue");
     }
-    T var = front->value;
+    T var = std::move(front->value);
     LinkedQueue<T>::LN *temp = front;
     front = front->next;
     if(front == nullptr)
@@ -254,8 +294,8 @@ void LinkedQueue<T>::clear() {
 
 template<class T>
 template<class Iterable>
-int LinkedQueue<T>::enqueue_all(const Iterable& i) {
-    int count = 0;
+size_type LinkedQueue<T>::enqueue_all(const Iterable& i) {
+    size_type count = 0;
     for(const T &v : i)
         count += enqueue(v);
     return count;
@@ -272,8 +312,8 @@ LinkedQueue<T>& LinkedQueue<T>::operator = (const LinkedQueue<T>& rhs) { // Esse
         return *this;
     LinkedQueue<T>::LN* test = rhs.front;
     mod_count += rhs.used;
-    int difference = used - rhs.used;
-    for(int i = 0; i < difference; i++)
+    size_type difference = used - rhs.used;
+    for(size_type i = 0; i < difference; i++)
         dequeue();
     for( LinkedQueue<T>::LN** t = &front; (*t) != nullptr; t = &((*t)->next)){
         if(test != nullptr){
@@ -285,6 +325,21 @@ LinkedQueue<T>& LinkedQueue<T>::operator = (const LinkedQueue<T>& rhs) { // Esse
         enqueue(test->value);
     return *this;
 }
+
+
+template<class T>
+LinkedQueue<T>& LinkedQueue<T>::operator = (LinkedQueue<T>&& rhs) {
+    if(this == &rhs)
+        return *this;
+    std::swap(front,rhs.front);
+    std::swap(rear,rhs.rear);
+    std::swap(used,rhs.used);
+    ++mod_count;
+    ++rhs.mod_count;
+    return *this;
+}
+
+
 template<class T>
 bool LinkedQueue<T>::operator == (const LinkedQueue<T>& rhs) const {
     if(this == &rhs)
@@ -310,8 +365,8 @@ bool LinkedQueue<T>::operator != (const LinkedQueue<T>& rhs) const {
 template<class T>
 std::ostream& operator << (std::ostream& outs, const LinkedQueue<T>& q) {
     outs << "queue[";
-    int len = q.size() - 1;
-    int index = 0;
+    size_type len = q.size() - 1;
+    size_type index = 0;
     for(auto &node : q){
         outs << node;
         if(index < len)
@@ -387,7 +442,7 @@ T LinkedQueue<T>::Iterator::erase() {
     if(!can_erase)
         throw ics::CannotEraseError("LinkedQueue::Iterator::erase Iterator cursor already erased");
     LinkedQueue<T>::LN* node = current;
-    T returnVal = current->value;
+    T returnVal = std::move(current->value);
     can_erase = false;
     if(prev != nullptr){
         prev->next = current->next;
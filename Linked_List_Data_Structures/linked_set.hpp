@@ -7,7 +7,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
+#include "node_pool.hpp"
 
 namespace ics {
 template<class T> class LinkedSet {
@@ -17,6 +19,7 @@ template<class T> class LinkedSet {
     LinkedSet          ();
     explicit LinkedSet (int initialLength);
     LinkedSet          (const LinkedSet<T>& to_copy);
+    LinkedSet          (LinkedSet<T>&& to_move);  //to_move is left empty
     explicit LinkedSet (const std::initializer_list<T>& il);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -25,9 +28,9 @@ template<class T> class LinkedSet {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    bool contains   (const T& element) const;
+    bool      empty      () const;
+    size_type size       () const;
+    bool      contains   (const T& element) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -36,24 +39,30 @@ template<class T> class LinkedSet {
 
 
     //Commands
-    int  insert (const T& element);
-    int  erase  (const T& element);
-    void clear  ();
+    int       insert (const T& element);
+    int       insert (T&& element);
+    int       erase  (const T& element);
+    void      clear  ();
+
+    //Insert T(args...)
+    template <class... Args>
+    int  emplace (Args&&... args);
 
     //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
 
     template <class Iterable>
-    int insert_all(const Iterable& i);
+    size_type insert_all(const Iterable& i);
 
     template <class Iterable>
-    int erase_all(const Iterable& i);
+    size_type erase_all(const Iterable& i);
 
     template<class Iterable>
-    int retain_all(const Iterable& i);
+    size_type retain_all(const Iterable& i);
 
 
     //Operators
     LinkedSet<T>& operator = (const LinkedSet<T>& rhs);
+    LinkedSet<T>& operator = (LinkedSet<T>&& rhs);   //Swaps contents with rhs
     bool operator == (const LinkedSet<T>& rhs) const;
     bool operator != (const LinkedSet<T>& rhs) const;
     bool operator <= (const LinkedSet<T>& rhs) const;
@@ -93,7 +102,7 @@ template<class T> class LinkedSet {
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
         LN*           current;  //if can_erase is false, this value is unusable
         LinkedSet<T>* ref_set;
-        int           expected_mod_count;
+        size_type     expected_mod_count;
         bool          can_erase = true;
 
         //Called in friends begin/end
@@ -106,11 +115,12 @@ template<class T> class LinkedSet {
 
 
   private:
-    class LN {
+    class LN : public PoolAllocated {
       public:
         LN ()                      {}
         LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+        LN (T v,  LN* n = nullptr) : value(std::move(v)), next(n){}
+        LN& operator = (LN&& ln) = default;
 
         T   value;
         LN* next   = nullptr;
@@ -119,8 +129,8 @@ template<class T> class LinkedSet {
 
     LN* front     = new LN();
     LN* trailer   = front;         //Always point to the special trailer LN
-    int used      =  0;            //Cache the number of values in linked list
-    int mod_count = 0;             //For sensing concurrent modification
+    size_type used      =  0;      //Cache the number of values in linked list
+    size_type mod_count = 0;       //For sensing concurrent modification
 
     //Helper methods
     int  erase_at   (LN* p);
@@ -160,6 +170,15 @@ LinkedSet<T>::LinkedSet(const LinkedSet<T>& to_copy) : used(to_copy.used) {
 }
 
 
+template<class T>
+LinkedSet<T>::LinkedSet(LinkedSet<T>&& to_move) {
+    std::swap(front,to_move.front);
+    std::swap(trailer,to_move.trailer);
+    std::swap(used,to_move.used);
+    ++to_move.mod_count;
+}
+
+
 template<class T>
 LinkedSet<T>::LinkedSet(const std::initializer_list<T>& il) {
     for(const T& i : il)
@@ -186,7 +205,7 @@ bool LinkedSet<T>::empty() const {
 
 
 template<class T>
-int LinkedSet<T>::size() const {
+size_type LinkedSet<T>::size() const {
     return used;
 }
 
@@ -248,6 +267,26 @@ int LinkedSet<T>::insert(const T& element) {
 }
 
 
+template<class T>
+int LinkedSet<T>::insert(T&& element) {
+    for(LinkedSet<T>::LN* temp = front; temp != trailer; temp = temp->next){
+        if(temp->value == element)
+            return 0;
+    }
+    front = new LinkedSet<T>::LN(std::move(element),front);
+    ++used;
+    ++mod_count;
+    return 1;
+}
+
+
+template<class T>
+template<class... Args>
+int LinkedSet<T>::emplace(Args&&... args) {
+    return insert(T(std::forward<Args>(args)...));
+}
+
+
 template<class T>
 int LinkedSet<T>::erase(const T& element) {
     for(LinkedSet<T>::LN* temp = front; temp != trailer; temp = temp->next){
@@ -270,8 +309,8 @@ void LinkedSet<T>::clear() {
 
 template<class T>
 template<class Iterable>
-int LinkedSet<T>::insert_all(const Iterable& i) {
-    int count = 0;
+size_type LinkedSet<T>::insert_all(const Iterable& i) {
+    size_type count = 0;
     for(const T& e: i)
         count += insert(e);
     return count;
@@ -280,8 +319,8 @@ int LinkedSet<T>::insert_all(const Iterable& i) {
 
 template<class T>
 template<class Iterable>
-int LinkedSet<T>::erase_all(const Iterable& i) {
-    int count = 0;
+size_type LinkedSet<T>::erase_all(const Iterable& i) {
+    size_type count = 0;
     for(const T& e : i)
         count += erase(e);
     return count;
@@ -290,8 +329,8 @@ int LinkedSet<T>::erase_all(const Iterable& i) {
 
 template<class T>
 template<class Iterable>
-int LinkedSet<T>::retain_all(const Iterable& i) {
-    int count = 0;
+size_type LinkedSet<T>::retain_all(const Iterable& i) {
+    size_type count = 0;
     LinkedSet<T> a;
     a.insert_all(i);
     LinkedSet<T>::LN* node = front;
@@ -315,10 +354,10 @@ template<class T>
 LinkedSet<T>& LinkedSet<T>::operator = (const LinkedSet<T>& rhs) {
     if(this == &rhs)
         return *this;
-    int difference = used - rhs.used;
+    size_type difference = used - rhs.used;
     used = rhs.used;
     mod_count += rhs.used;
-    for(int i = 0 ; i < difference; i++){
+    for(size_type i = 0 ; i < difference; i++){
         LinkedSet<T>::LN* temp = front;
         front = front->next;
         delete temp;
@@ -339,6 +378,19 @@ LinkedSet<T>& LinkedSet<T>::operator = (const LinkedSet<T>& rhs) {
 }
 
 
+template<class T>
+LinkedSet<T>& LinkedSet<T>::operator = (LinkedSet<T>&& rhs) {
+    if(this == &rhs)
+        return *this;
+    std::swap(front,rhs.front);
+    std::swap(trailer,rhs.trailer);
+    std::swap(used,rhs.used);
+    ++mod_count;
+    ++rhs.mod_count;
+    return *this;
+}
+
+
 template<class T>
 bool LinkedSet<T>::operator == (const LinkedSet<T>& rhs) const {
     if(this == &rhs)
@@ -402,7 +454,7 @@ bool LinkedSet<T>::operator > (const LinkedSet<T>& rhs) const {
 template<class T>
 std::ostream& operator << (std::ostream& outs, const LinkedSet<T>& s) {
     outs << "set[";
-    int index = 0;
+    size_type index = 0;
     if(!(s.empty())){
         for(auto &node : s){
             outs << node;
@@ -439,7 +491,7 @@ auto LinkedSet<T>::end () const -> LinkedSet<T>::Iterator {
 template<class T>
 int LinkedSet<T>::erase_at(LN* p) {
     LinkedSet<T>::LN* temp = p->next;
-    *p = *temp;
+    *p = std::move(*temp);
     delete temp;
     ++mod_count;
     --used;
@@ -5,8 +5,10 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
+#include "node_pool.hpp"
 #include "array_queue.hpp"   //For traversal
 // Submitter jpascasc(Pascascio, Joshua)
 
@@ -34,6 +36,7 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
 
     BSTMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
     BSTMap          (const BSTMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    BSTMap          (BSTMap<KEY,T,tlt>&& to_move);  //Uses to_move's lt; to_move is left empty
     explicit BSTMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -51,9 +54,15 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
 
     //Commands
     T    put   (const KEY& key, const T& value);
+    T    put   (const KEY& key, T&& value);
     T    erase (const KEY& key);
     void clear ();
 
+    //If key is not in the map, put key with the value T(args...); if it is, leave
+    //  its value unchanged (and construct no T). Either way, return key's value.
+    template <class... Args>
+    T&   emplace (const KEY& key, Args&&... args);
+
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
     int put_all(const Iterable& i);
@@ -64,6 +73,7 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
     T&       operator [] (const KEY&);
     const T& operator [] (const KEY&) const;
     BSTMap<KEY,T,tlt>& operator = (const BSTMap<KEY,T,tlt>& rhs);
+    BSTMap<KEY,T,tlt>& operator = (BSTMap<KEY,T,tlt>&& rhs);   //Swaps contents (and lt) with rhs
     bool operator == (const BSTMap<KEY,T,tlt>& rhs) const;
     bool operator != (const BSTMap<KEY,T,tlt>& rhs) const;
 
@@ -108,12 +118,12 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
 
 
   private:
-    class TN {
+    class TN : public PoolAllocated {
       public:
         TN ()                     : left(nullptr), right(nullptr){}
         TN (const TN& tn)         : value(tn.value), left(tn.left), right(tn.right){}
         TN (Entry v, TN* l = nullptr,
-                     TN* r = nullptr) : value(v), left(l), right(r){}
+                     TN* r = nullptr) : value(std::move(v)), left(l), right(r){}
 
         Entry value;
         TN*   left;
@@ -125,8 +135,10 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
   int used      = 0;                       //Cache the number of key->value pairs in the BST
   int mod_count = 0;                       //For sensing concurrent modification
 
-  //Helper methods (find_key written iteratively, the rest recursively)
+  //Helper methods (find_key/find_link written iteratively, the rest recursively)
+  bool  call_lt             (const KEY& a, const KEY& b)                const; //tlt(a,b) if given (a direct call: inlinable), else lt(a,b)
   TN*   find_key            (TN*  root, const KEY& key)                 const; //Returns reference to key's node or nullptr
+  TN*&  find_link           (TN*& root, const KEY& key);                       //Returns the pointer to key's node (nullptr: where key belongs)
   bool  has_value           (TN*  root, const T& value)                 const; //Returns whether value is is root's tree
   TN*   copy                (TN*  root)                                 const; //Copy the keys/values in root's tree (identical structure)
   void  copy_to_queue       (TN* root, ArrayQueue<Entry>& q)            const; //Fill queue with root's tree value
@@ -188,6 +200,16 @@ BSTMap<KEY,T,tlt>::BSTMap(const BSTMap<KEY,T,tlt>& to_copy, bool (*clt)(const KE
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BSTMap<KEY,T,tlt>::BSTMap(BSTMap<KEY,T,tlt>&& to_move)
+:lt(to_move.lt)
+{
+    std::swap(map,to_move.map);
+    std::swap(used,to_move.used);
+    ++to_move.mod_count;
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 BSTMap<KEY,T,tlt>::BSTMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
 :lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
@@ -266,6 +288,21 @@ T BSTMap<KEY,T,tlt>::put(const KEY& key, const T& value) {
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T BSTMap<KEY,T,tlt>::put(const KEY& key, T&& value) {
+    TN*& node = find_link(map,key);
+    ++mod_count;
+    if(node == nullptr){
+        ++used;
+        node = new TN(Entry(key,std::move(value)));
+        return node->value.second;
+    }
+    T temp = std::move(node->value.second);
+    node->value.second = std::move(value);
+    return temp;
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 T BSTMap<KEY,T,tlt>::erase(const KEY& key) {
     T result = remove(map,key);
@@ -295,6 +332,19 @@ int BSTMap<KEY,T,tlt>::put_all(const Iterable& i) {
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class... Args>
+T& BSTMap<KEY,T,tlt>::emplace(const KEY& key, Args&&... args) {
+    TN*& node = find_link(map,key);
+    if(node == nullptr){
+        ++used;
+        ++mod_count;
+        node = new TN(Entry(key,T(std::forward<Args>(args)...)));
+    }
+    return node->value.second;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
@@ -335,6 +385,19 @@ BSTMap<KEY,T,tlt>& BSTMap<KEY,T,tlt>::operator = (const BSTMap<KEY,T,tlt>& rhs)
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BSTMap<KEY,T,tlt>& BSTMap<KEY,T,tlt>::operator = (BSTMap<KEY,T,tlt>&& rhs) {
+    if(this == &rhs)
+        return *this;
+    std::swap(lt,rhs.lt);
+    std::swap(map,rhs.map);
+    std::swap(used,rhs.used);
+    ++mod_count;
+    ++rhs.mod_count;
+    return *this;
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 bool BSTMap<KEY,T,tlt>::operator == (const BSTMap<KEY,T,tlt>& rhs) const {
     if(this == &rhs)
@@ -386,13 +449,19 @@ auto BSTMap<KEY,T,tlt>::end () const -> BSTMap<KEY,T,tlt>::Iterator {
 //
 //Private helper methods
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BSTMap<KEY,T,tlt>::call_lt (const KEY& a, const KEY& b) const {
+    return tlt != (ltfunc)undefinedlt<KEY> ? tlt(a,b) : lt(a,b);
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 typename BSTMap<KEY,T,tlt>::TN* BSTMap<KEY,T,tlt>::find_key (TN* root, const KEY& key) const {
     TN* next;
     for(TN* temp = root; temp != nullptr; temp = next ){
         if(temp->value.first == key)
             return temp;
-        if(lt(temp->value.first,key))
+        if(call_lt(temp->value.first,key))
             next = temp->right;
         else
             next = temp->left;
@@ -401,6 +470,19 @@ typename BSTMap<KEY,T,tlt>::TN* BSTMap<KEY,T,tlt>::find_key (TN* root, const KEY
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename BSTMap<KEY,T,tlt>::TN*& BSTMap<KEY,T,tlt>::find_link (TN*& root, const KEY& key) {
+    TN** link = &root;
+    while(*link != nullptr && !((*link)->value.first == key)){
+        if(call_lt((*link)->value.first,key))
+            link = &(*link)->right;
+        else
+            link = &(*link)->left;
+    }
+    return *link;
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 bool BSTMap<KEY,T,tlt>::has_value (TN* root, const T& value) const {
     if(root == nullptr)
@@ -475,7 +557,7 @@ T BSTMap<KEY,T,tlt>::insert (TN*& root, const KEY& key, const T& value) {
             return temp;
         }
         else{
-            if(lt(root->value.first,key))
+            if(call_lt(root->value.first,key))
                 return insert(root->right,key,value);
             else
                 return insert(root->left,key,value);
@@ -496,7 +578,7 @@ T& BSTMap<KEY,T,tlt>::find_addempty (TN*& root, const KEY& key) {
         return root->value.second;
     }
     else{
-        if(lt(root->value.first,key))
+        if(call_lt(root->value.first,key))
             return find_addempty(root->right,key);
         else
             return find_addempty(root->left,key);
@@ -509,7 +591,7 @@ pair<KEY,T> BSTMap<KEY,T,tlt>::remove_closest(TN*& root) {
   if (root->right != nullptr)
     return remove_closest(root->right);
   else{
-    Entry to_return = root->value;
+    Entry to_return = std::move(root->value);
     TN* to_delete = root;
     root = root->left;
     delete to_delete;
@@ -526,7 +608,7 @@ T BSTMap<KEY,T,tlt>::remove (TN*& root, const KEY& key) {
     throw KeyError(answer.str());
   }else
     if (key == root->value.first) {
-      T to_return = root->value.second;
+      T to_return = std::move(root->value.second);
       if (root->left == nullptr) {
         TN* to_delete = root;
         root = root->right;
@@ -539,7 +621,7 @@ T BSTMap<KEY,T,tlt>::remove (TN*& root, const KEY& key) {
         root->value = remove_closest(root->left);
       return to_return;
     }else
-      return remove( (lt(key,root->value.first) ? root->left : root->right), key);
+      return remove( (call_lt(key,root->value.first) ? root->left : root->right), key);
 }
 
 
@@ -8,6 +8,7 @@
 #include "ics_exceptions.hpp"
 #include <utility>              //For std::swap function
 #include "array_stack.hpp"      //See operator <<
+#include "size_hint.hpp"
 
 // Submitter jpascasc(Pascascio,Joshua)
 namespace ics {
@@ -32,6 +33,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
     HeapPriorityQueue(bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     explicit HeapPriorityQueue(int initial_length, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
     HeapPriorityQueue(const HeapPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    HeapPriorityQueue(HeapPriorityQueue<T,tgt>&& to_move);  //Uses to_move's gt; to_move is left empty
     explicit HeapPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -40,24 +42,31 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    T&   peek       () const;
+    bool      empty      () const;
+    size_type size       () const;
+    T&        peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     int  enqueue (const T& element);
+    int  enqueue (T&& element);
     T    dequeue ();
     void clear   ();
+    void reserve (size_type n);   //Room for n values: no reallocation while size() <= n
+
+    //Enqueue T(args...)
+    template <class... Args>
+    int emplace (Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int enqueue_all (const Iterable& i);
+    size_type enqueue_all (const Iterable& i);
 
 
     //Operators
     HeapPriorityQueue<T,tgt>& operator = (const HeapPriorityQueue<T,tgt>& rhs);
+    HeapPriorityQueue<T,tgt>& operator = (HeapPriorityQueue<T,tgt>&& rhs);  //Swaps contents (and gt) with rhs
     bool operator == (const HeapPriorityQueue<T,tgt>& rhs) const;
     bool operator != (const HeapPriorityQueue<T,tgt>& rhs) const;
 
@@ -90,7 +99,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
         //If can_erase is false, the value has been removed from "it" (++ does nothing)
         HeapPriorityQueue<T,tgt>  it;                 //copy of HPQ (from begin), to use as iterator via dequeue
         HeapPriorityQueue<T,tgt>* ref_pq;
-        int                       expected_mod_count;
+        size_type                 expected_mod_count;
         bool                      can_erase = true;
 
         //Called in friends begin/end
@@ -107,20 +116,21 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
   private:
     bool (*gt) (const T& a, const T& b); //The gt used by enqueue (from template or constructor)
     T*  pq;                              //Array stores a heap, so it uses the heap ordering property
-    int length    = 0;                   //Physical length of array: must be >= .size()
-    int used      = 0;                   //Amount of array used: invariant: 0 <= used <= length
-    int mod_count = 0;                   //For sensing concurrent modification
+    size_type length    = 0;             //Physical length of array: must be >= .size()
+    size_type used      = 0;             //Amount of array used: invariant: 0 <= used <= length
+    size_type mod_count = 0;             //For sensing concurrent modification
 
     //Helper methods
-    void ensure_length  (int new_length);
-    int  left_child     (int i) const;         //Useful abstractions for heaps as arrays
-    int  right_child    (int i) const;
-    int  parent         (int i) const;
-    bool is_root        (int i) const;
-    bool in_heap        (int i) const;
-    void percolate_up   (int i);
-    void percolate_down (int i);
-    void heapify        ();                   // Percolate down all value is array (from indexes used-1 to 0): O(N)
+    bool      call_gt        (const T& a, const T& b) const;  //tgt(a,b) if given (a direct call: inlinable), else gt(a,b)
+    void      ensure_length  (size_type new_length);
+    size_type left_child     (size_type i) const;         //Useful abstractions for heaps as arrays
+    size_type right_child    (size_type i) const;
+    size_type parent         (size_type i) const;
+    bool      is_root        (size_type i) const;
+    bool      in_heap        (size_type i) const;
+    void      percolate_up   (size_type i);
+    void      percolate_down (size_type i);
+    void      heapify        ();                   // Percolate down all value is array (from indexes used-1 to 0): O(N)
   };
 
 
@@ -177,7 +187,7 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const HeapPriorityQueue<T,tgt>& to_c
     used = to_copy.used;
     length = to_copy.length;
     pq = new T[length];
-    for(int i = 0; i < used; i++)
+    for(size_type i = 0; i < used; i++)
         pq[i] = to_copy.pq[i];
     if(gt != to_copy.gt) {
         heapify();
@@ -185,6 +195,18 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const HeapPriorityQueue<T,tgt>& to_c
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+HeapPriorityQueue<T,tgt>::HeapPriorityQueue(HeapPriorityQueue<T,tgt>&& to_move)
+:gt(to_move.gt)
+{
+    pq = new T[length];
+    std::swap(pq,to_move.pq);
+    std::swap(length,to_move.length);
+    std::swap(used,to_move.used);
+    ++to_move.mod_count;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
 :gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt),length(il.size()),used(il.size())
@@ -194,7 +216,7 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const std::initializer_list<T>& il,
     if(tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
         throw ics::TemplateFunctionError("HeapPriorityQueue::initializer_list constructor: both specified and different");
     pq = new T[length];
-    int count = 0;
+    size_type count = 0;
     for(const T& elem : il){
         pq[count++] = elem;
     }
@@ -212,7 +234,7 @@ HeapPriorityQueue<T,tgt>::HeapPriorityQueue(const Iterable& i, bool (*cgt)(const
     if(tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
         throw ics::TemplateFunctionError("HeapPriorityQueue::Iterable constructor: both specified and different");
     pq = new T[length];
-    int count = 0;
+    size_type count = 0;
     for(const T& elem : i)
         pq[count++] = elem;
     heapify();
@@ -230,7 +252,7 @@ bool HeapPriorityQueue<T,tgt>::empty() const {
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::size() const {
+size_type HeapPriorityQueue<T,tgt>::size() const {
     return used;
 }
 
@@ -250,10 +272,10 @@ std::string HeapPriorityQueue<T,tgt>::str() const {
     if(length != 0){
         std::stringstream backup;
         HeapPriorityQueue<T,tgt> copy(*this);
-        int count = 0;
-        int stop = used;
-        int lstop = length - 1;
-        for(int i = 0; i < length; i++){
+        size_type count = 0;
+        size_type stop = used;
+        size_type lstop = length - 1;
+        for(size_type i = 0; i < length; i++){
             backup << i << ":";
             if(i < stop)
                 backup << copy.dequeue();
@@ -281,13 +303,30 @@ int HeapPriorityQueue<T,tgt>::enqueue(const T& element) {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int HeapPriorityQueue<T,tgt>::enqueue(T&& element) {
+    this->ensure_length(used + 2);
+    pq[used++] = std::move(element);
+    percolate_up(used - 1);
+    ++mod_count;
+    return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class... Args>
+int HeapPriorityQueue<T,tgt>::emplace(Args&&... args) {
+    return enqueue(T(std::forward<Args>(args)...));
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T HeapPriorityQueue<T,tgt>::dequeue() {
     if(empty())
         throw ics::EmptyError("HeapPriorityQueue::dequeue");
-    T val = pq[0];
+    T val = std::move(pq[0]);
     ++mod_count;
-    pq[0] = pq[--used];
+    pq[0] = std::move(pq[--used]);
     if(!empty())
         percolate_down(0);
     return val;
@@ -301,12 +340,31 @@ void HeapPriorityQueue<T,tgt>::clear() {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::reserve(size_type n) {
+    this->ensure_length(n + 1);
+    ++mod_count;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 template <class Iterable>
-int HeapPriorityQueue<T,tgt>::enqueue_all(const Iterable& i) {
-    int count = 0;
-    for (const T& e : i)
-        count += enqueue(e);
+size_type HeapPriorityQueue<T,tgt>::enqueue_all(const Iterable& i) {
+    //Append all; with at least as many new values as old, heapify (O(N)) beats percolating each up
+    this->ensure_length(used + size_hint(i) + 1);
+    size_type old_used = used;
+    for (const T& e : i){
+        this->ensure_length(used + 2);
+        pq[used++] = e;
+    }
+    size_type count = used - old_used;
+    if(count >= old_used)
+        heapify();
+    else
+        for(size_type j = old_used; j < used; j++)
+            percolate_up(j);
+    if(count != 0)
+        ++mod_count;
     return count;
 }
 
@@ -323,7 +381,7 @@ HeapPriorityQueue<T,tgt>& HeapPriorityQueue<T,tgt>::operator = (const HeapPriori
         gt = rhs.gt;
     this->ensure_length(rhs.used);
     used = rhs.used;
-    for(int i = 0; i < used; i++)
+    for(size_type i = 0; i < used; i++)
         pq[i] = rhs.pq[i];
     if(gt != rhs.gt){
         gt = rhs.gt;
@@ -334,6 +392,20 @@ HeapPriorityQueue<T,tgt>& HeapPriorityQueue<T,tgt>::operator = (const HeapPriori
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+HeapPriorityQueue<T,tgt>& HeapPriorityQueue<T,tgt>::operator = (HeapPriorityQueue<T,tgt>&& rhs) {
+    if(this == &rhs)
+        return *this;
+    std::swap(gt,rhs.gt);
+    std::swap(pq,rhs.pq);
+    std::swap(length,rhs.length);
+    std::swap(used,rhs.used);
+    ++mod_count;
+    ++rhs.mod_count;
+    return *this;
+}
+
+
 template<class T, bool (*tgt)(const T& a, const T& b)>
 bool HeapPriorityQueue<T,tgt>::operator == (const HeapPriorityQueue<T,tgt>& rhs) const {
     if(this == &rhs)
@@ -359,8 +431,8 @@ bool HeapPriorityQueue<T,tgt>::operator != (const HeapPriorityQueue<T,tgt>& rhs)
 template<class T, bool (*tgt)(const T& a, const T& b)>
 std::ostream& operator << (std::ostream& outs, const HeapPriorityQueue<T,tgt>& pq) {
     outs << "priority_queue[";
-    int max = pq.size() - 1;
-    int count = 0;
+    size_type max = pq.size() - 1;
+    size_type count = 0;
     if(!(pq.empty())){
         std::stringstream sstream;
         for(const T& item : pq){
@@ -370,7 +442,7 @@ std::ostream& operator << (std::ostream& outs, const HeapPriorityQueue<T,tgt>& p
             count++;
         }
         std::string reverse = sstream.str();
-        for(int i = (reverse.length() - 1) ; i >= 0; i--)
+        for(size_type i = (reverse.length() - 1) ; i >= 0; i--)
             outs << reverse[i];
     }
     outs << "]:highest";
@@ -399,38 +471,44 @@ auto HeapPriorityQueue<T,tgt>::end () const -> HeapPriorityQueue<T,tgt>::Iterato
 //Private helper methods
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void HeapPriorityQueue<T,tgt>::ensure_length(int new_length) {
+bool HeapPriorityQueue<T,tgt>::call_gt (const T& a, const T& b) const {
+    return tgt != (gtfunc)undefinedgt<T> ? tgt(a,b) : gt(a,b);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::ensure_length(size_type new_length) {
     if(length >= new_length)
         return;
     T* oldpq = pq;
     length = std::max(new_length, 2 * length);
     pq = new T[length];
-    for(int i = 0; i < used; i++)
-        pq[i] = oldpq[i];
+    for(size_type i = 0; i < used; i++)
+        pq[i] = std::move(oldpq[i]);
     delete[] oldpq;
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::left_child(int i) const
+size_type HeapPriorityQueue<T,tgt>::left_child(size_type i) const
 {
     return ((2 * i) + 1);
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::right_child(int i) const
+size_type HeapPriorityQueue<T,tgt>::right_child(size_type i) const
 {
     return ((2 * i) + 2);
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-int HeapPriorityQueue<T,tgt>::parent(int i) const
+size_type HeapPriorityQueue<T,tgt>::parent(size_type i) const
 {
     return ((i - 1) / 2);
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-bool HeapPriorityQueue<T,tgt>::is_root(int i) const
+bool HeapPriorityQueue<T,tgt>::is_root(size_type i) const
 {
     if(empty())
         return false;
@@ -438,15 +516,15 @@ bool HeapPriorityQueue<T,tgt>::is_root(int i) const
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-bool HeapPriorityQueue<T,tgt>::in_heap(int i) const
+bool HeapPriorityQueue<T,tgt>::in_heap(size_type i) const
 {
     return used != 0 && i < used;
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void HeapPriorityQueue<T,tgt>::percolate_up(int i) {
-    for(int e = i; ( !(is_root(i)) && gt(pq[e],pq[parent(e)])); e = parent(e)){
+void HeapPriorityQueue<T,tgt>::percolate_up(size_type i) {
+    for(size_type e = i; ( !(is_root(i)) && call_gt(pq[e],pq[parent(e)])); e = parent(e)){
         std::swap(pq[e],pq[parent(e)]);
         percolate_down(e);
     }
@@ -454,14 +532,14 @@ void HeapPriorityQueue<T,tgt>::percolate_up(int i) {
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void HeapPriorityQueue<T,tgt>::percolate_down(int i) {
-    int child, right;
-    for(int e = i; (in_heap(e)) ; e = child){
+void HeapPriorityQueue<T,tgt>::percolate_down(size_type i) {
+    size_type child, right;
+    for(size_type e = i; (in_heap(e)) ; e = child){
         child = left_child(e);
         right = right_child(e);
-        if(in_heap(right) && gt(pq[right],pq[child]))
+        if(in_heap(right) && call_gt(pq[right],pq[child]))
             child = right;
-        if(in_heap(child) && gt(pq[child],pq[e]))
+        if(in_heap(child) && call_gt(pq[child],pq[e]))
             std::swap(pq[child],pq[e]);
         else
             break;
@@ -471,7 +549,7 @@ void HeapPriorityQueue<T,tgt>::percolate_down(int i) {
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 void HeapPriorityQueue<T,tgt>::heapify() {
-for (int i = used-1; i >= 0; --i)
+for (size_type i = used-1; i >= 0; --i)
   percolate_down(i);
 }
 
@@ -514,18 +592,20 @@ T HeapPriorityQueue<T,tgt>::Iterator::erase() {
         throw ics::CannotEraseError("HeapPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
     can_erase = false;
     T erasedVal = it.dequeue();
-    int erasedIndex;
-    for(int i = 0; i < ref_pq->used; i++){
+    size_type erasedIndex;
+    for(size_type i = 0; i < ref_pq->used; i++){
         if(erasedVal == ref_pq->pq[i]){
             erasedIndex = i;
             break;
         }
     }
-    ref_pq->pq[erasedIndex] = ref_pq->pq[--ref_pq->used];
-    if(erasedIndex != 0 && ref_pq->gt(ref_pq->pq[erasedIndex],ref_pq->pq[ref_pq->parent(erasedIndex)]))
-        ref_pq->percolate_up(erasedIndex);
-    else
-        ref_pq->percolate_down(erasedIndex);
+    if(erasedIndex != --ref_pq->used){
+        ref_pq->pq[erasedIndex] = std::move(ref_pq->pq[ref_pq->used]);
+        if(erasedIndex != 0 && ref_pq->call_gt(ref_pq->pq[erasedIndex],ref_pq->pq[ref_pq->parent(erasedIndex)]))
+            ref_pq->percolate_up(erasedIndex);
+        else
+            ref_pq->percolate_down(erasedIndex);
+    }
     ref_pq->mod_count++;
     expected_mod_count = ref_pq->mod_count;
     return erasedVal;
@@ -791,6 +791,27 @@
 //}
 //
 //
+//TEST_F(MapTest, move_and_emplace) {
+//  MapTypeStr m;
+//  load(m,"abc", new int[3]{1,2,3});
+//  MapTypeStr moved(std::move(m));
+//  ASSERT_EQ(3,moved.size());
+//  ASSERT_TRUE(m.empty());
+//  m["d"] = 4;                        //a moved-from map is still usable
+//  m = std::move(moved);
+//  ASSERT_EQ(3,m.size());
+//  ASSERT_EQ(1,moved.size());
+//  ASSERT_EQ(2,m["b"]);
+//
+//  int five = 5;
+//  m.put("e",std::move(five));
+//  ASSERT_EQ(7,m.emplace("f",7));
+//  ASSERT_EQ(7,m.emplace("f",8));     //key already in the map: its value is unchanged
+//  ASSERT_EQ(5,m.size());
+//  ASSERT_EQ(5,m["e"]);
+//}
+//
+//
 //TEST_F(MapTest, large_scale) {
 //  MapTypeInt lm;
 //
@@ -6,6 +6,7 @@
 //#include "array_stack.hpp"           // must leave in for constructor
 //#include "array_priority_queue.hpp"  // must leave in for large_scale
 //#include "heap_priority_queue.hpp"
+//#include "functor.hpp"
 //
 //bool gt_string  (const std::string& a, const std::string& b) {return a < b;}
 //bool gt_string2 (const std::string& a, const std::string& b) {return a > b;}
@@ -568,6 +569,60 @@
 //}
 //
 //
+//TEST_F(PriorityQueueTest, move_and_emplace) {
+//  PriorityQueueTypeStr q;
+//  load(q,"cab");
+//  PriorityQueueTypeStr moved(std::move(q));
+//  ASSERT_EQ(3,moved.size());
+//  ASSERT_TRUE(q.empty());
+//  q.enqueue("d");                    //a moved-from priority queue is still usable
+//  q = std::move(moved);
+//  ASSERT_EQ(1,moved.size());
+//  ASSERT_EQ("d",moved.peek());
+//
+//  ASSERT_EQ(1,q.emplace(2,'b'));     //std::string(2,'b')
+//  ASSERT_EQ("a",q.dequeue());
+//  ASSERT_EQ("b",q.dequeue());
+//  ASSERT_EQ("bb",q.dequeue());
+//  ASSERT_EQ("c",q.dequeue());
+//  ASSERT_TRUE(q.empty());
+//}
+//
+//
+//TEST_F(PriorityQueueTest, enqueue_all_bulk) {
+//  PriorityQueueTypeInt q;
+//  q.enqueue(500);
+//  ics::ArrayStack<int> many, few;
+//  for (int i=0; i<1000; ++i)
+//    many.push(i*7919%1000);          //0..999, scrambled
+//  for (int i=0; i<5; ++i)
+//    few.push(1000-i);
+//  ASSERT_EQ(1000,q.enqueue_all(many));
+//  ASSERT_EQ(5,q.enqueue_all(few));
+//  ASSERT_EQ(1006,q.size());
+//
+//  int previous = q.dequeue();
+//  for (int i=1; i<1006; ++i) {
+//    int next = q.dequeue();
+//    ASSERT_LE(previous,next);
+//    previous = next;
+//  }
+//  ASSERT_EQ(1000,previous);
+//}
+//
+//
+//TEST_F(PriorityQueueTest, functor_compare) {
+//  ics::HeapPriorityQueue<int,ics::functor_compare<int,std::greater<int>>> q;  //larger is higher priority
+//  ics::ArrayStack<int> values;
+//  for (int i=0; i<100; ++i)
+//    values.push(i*37%100);
+//  ASSERT_EQ(100,q.enqueue_all(values));
+//  for (int i=99; i>=0; --i)
+//    ASSERT_EQ(i,q.dequeue());
+//  ASSERT_TRUE(q.empty());
+//}
+//
+//
 //TEST_F(PriorityQueueTest, large_scale) {
 //  PriorityQueueTypeInt lq;
 //  ics::ArrayPriorityQueue<int,gt_int> lq_ref;
@@ -118,7 +118,7 @@ WordQueue produce_text(const Corpus& corpus, const WordQueue& start, int count)
     std::string r = random_in_set(corpus[keys]);
     result.enqueue(r);
     keys.dequeue();
-    keys.enqueue(r);
+    keys.enqueue(std::move(r));
   }
 
   return result;
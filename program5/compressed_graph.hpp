@@ -0,0 +1,330 @@
+#ifndef COMPRESSED_GRAPH_HPP_
+#define COMPRESSED_GRAPH_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include "ics_exceptions.hpp"
+#include "ics_hash.hpp"
+#include "string_view.hpp"
+#include "size_hint.hpp"
+#include "hash_map.hpp"
+#include "frozen_hash_map.hpp"
+
+
+namespace ics {
+
+
+template<class T> class HashGraph;
+
+
+//An immutable graph, usually made by HashGraph::freeze() from a graph that is
+//  built once and then only traversed (e.g., by many shortest-path searches).
+//Each node gets a dense id in [0,node_count()), in alphabetical order of the
+//  node names (so the same graph always gets the same ids); a FrozenHashMap
+//  maps names to ids and a vector maps ids back to names.
+//Edges are stored in CSR (compressed sparse row) form, once by origin and once
+//  by destination: node n's out-edges are out_target[out_offset[n]..out_offset[n+1]-1]
+//  (and their values are at the same indexes of out_value), sorted by id. So
+//  scanning a node's edges reads contiguous ints: no hashing, no string
+//  compares, and no pointer chasing through sets of (string,string) pairs.
+//Query nodes by id in hot loops; id(name)/name(id) translate at the edges of
+//  an algorithm. Any id outside [0,node_count()) raises GraphError.
+template<class T>
+class CompressedGraph {
+  public:
+    typedef int         NodeId;
+    typedef std::string NodeName;
+    typedef StringView  NodeView;
+
+    static int hash_str  (const NodeName& s) {return hash_of(s);}
+    static int hash_view (const NodeView& s) {return hash_of(s);}   //Equal to hash_str for the same characters
+
+    //A node's out-edges (or in-edges) as two parallel arrays: node(i) is the
+    //  i-th destination (or origin), in increasing id order, and value(i) is
+    //  that edge's value. It refers into its graph, so must not outlive it.
+    //Iterating produces the node ids: for (NodeId d : g.out_edges(o)) ...
+    class Adjacency {
+      public:
+        int           size  ()      const {return int(last-first);}
+        bool          empty ()      const {return first == last;}
+        NodeId        node  (int i) const {return first[i];}
+        const T&      value (int i) const {return values[i];}
+        const NodeId* begin ()      const {return first;}
+        const NodeId* end   ()      const {return last;}
+
+      private:
+        friend class CompressedGraph<T>;
+        Adjacency(const NodeId* f, const NodeId* l, const T* v) : first(f), last(l), values(v) {}
+
+        const NodeId* first;
+        const NodeId* last;
+        const T*      values;
+    };
+
+
+    //Destructor/Constructors (copying/moving copies/moves each array)
+    ~CompressedGraph();
+    CompressedGraph();                                 //Empty
+    explicit CompressedGraph(const HashGraph<T>& g);   //Same as g.freeze()
+
+    //Queries
+    bool        empty      ()                              const;
+    int         node_count ()                              const;
+    size_type   edge_count ()                              const;
+    bool        has_node   (NodeView node_name)            const;
+    NodeId      id         (NodeView node_name)            const;   //GraphError if absent
+    const NodeName& name   (NodeId node)                   const;
+    bool        has_edge   (NodeId origin, NodeId destination) const;
+    T           edge_value (NodeId origin, NodeId destination) const;   //GraphError if absent
+    int         in_degree  (NodeId node)                   const;
+    int         out_degree (NodeId node)                   const;
+    int         degree     (NodeId node)                   const;
+    Adjacency   out_edges  (NodeId node)                   const;
+    Adjacency   in_edges   (NodeId node)                   const;
+
+    template<class T2>
+    friend std::ostream& operator<<(std::ostream& outs, const CompressedGraph<T2>& g);
+
+
+  private:
+    typedef HashMap<NodeName,NodeId,hash_str>       NameMap;   //Only used while building ids
+    typedef FrozenHashMap<NodeName,NodeId,hash_str> IdMap;
+
+    //An edge while building: from/to are (origin,destination) or (destination,origin)
+    struct Link {
+      NodeId   from;
+      NodeId   to;
+      const T* value;
+    };
+
+    std::vector<NodeName>  names;        //names[n] is node n's name; sorted
+    IdMap                  ids;          //ids[names[n]] == n
+    std::vector<size_type> out_offset;   //node_count()+1 entries: node n's out-edges are at [out_offset[n],out_offset[n+1])
+    std::vector<NodeId>    out_target;   //Destinations, by origin (then destination)
+    std::vector<T>         out_value;    //out_value[i] is the value of the edge to out_target[i]
+    std::vector<size_type> in_offset;    //As above, for in-edges
+    std::vector<NodeId>    in_source;    //Origins, by destination (then origin)
+    std::vector<T>         in_value;
+
+    //Helper methods
+    void check_node (NodeId node, const char* where) const;   //GraphError if node is not an id
+    void build_rows (std::vector<Link>& links, std::vector<size_type>& offset,
+                     std::vector<NodeId>& other, std::vector<T>& value);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CompressedGraph class and related definitions
+
+//Destructor/Constructors
+
+template<class T>
+CompressedGraph<T>::~CompressedGraph() {
+}
+
+
+template<class T>
+CompressedGraph<T>::CompressedGraph()
+: out_offset(1,0), in_offset(1,0) {
+}
+
+
+//Ids are assigned in alphabetical order of names; each edge is stored twice:
+//  in its origin's out-row and in its destination's in-row
+template<class T>
+CompressedGraph<T>::CompressedGraph(const HashGraph<T>& g) {
+  names.reserve(g.node_count());
+  for (const typename HashGraph<T>::NodeMapEntry& ne : g.all_nodes())
+    names.push_back(ne.first);
+  std::sort(names.begin(),names.end());
+
+  NameMap to_id;
+  to_id.reserve(names.size());
+  for (NodeId n=0; n<node_count(); ++n)
+    to_id.put(names[n],n);
+  ids = to_id.freeze();
+
+  std::vector<Link> links;
+  links.reserve(g.edge_count());
+  for (const typename HashGraph<T>::EdgeMapEntry& ee : g.all_edges())
+    links.push_back(Link{ids[ee.first.first], ids[ee.first.second], &ee.second});
+  build_rows(links,out_offset,out_target,out_value);
+
+  for (Link& l : links)
+    std::swap(l.from,l.to);
+  build_rows(links,in_offset,in_source,in_value);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T>
+bool CompressedGraph<T>::empty() const {
+  return names.empty();
+}
+
+
+template<class T>
+int CompressedGraph<T>::node_count() const {
+  return int(names.size());
+}
+
+
+template<class T>
+size_type CompressedGraph<T>::edge_count() const {
+  return size_type(out_target.size());
+}
+
+
+template<class T>
+bool CompressedGraph<T>::has_node(NodeView node_name) const {
+  return ids.has_key(node_name,hash_view);
+}
+
+
+template<class T>
+auto CompressedGraph<T>::id(NodeView node_name) const -> NodeId {
+  if (!ids.has_key(node_name,hash_view)) {
+    std::ostringstream answer;
+    answer << "CompressedGraph::id: node(" << node_name << ") not in graph";
+    throw GraphError(answer.str());
+  }
+  return ids.get(node_name,hash_view);
+}
+
+
+template<class T>
+auto CompressedGraph<T>::name(NodeId node) const -> const NodeName& {
+  check_node(node,"name");
+  return names[node];
+}
+
+
+//Binary search of origin's out-row (sorted by destination id)
+template<class T>
+bool CompressedGraph<T>::has_edge(NodeId origin, NodeId destination) const {
+  check_node(origin,"has_edge");
+  check_node(destination,"has_edge");
+  const NodeId* first = out_target.data()+out_offset[origin];
+  const NodeId* last  = out_target.data()+out_offset[origin+1];
+  return std::binary_search(first,last,destination);
+}
+
+
+template<class T>
+T CompressedGraph<T>::edge_value(NodeId origin, NodeId destination) const {
+  check_node(origin,"edge_value");
+  check_node(destination,"edge_value");
+  const NodeId* first = out_target.data()+out_offset[origin];
+  const NodeId* last  = out_target.data()+out_offset[origin+1];
+  const NodeId* at    = std::lower_bound(first,last,destination);
+  if (at == last || *at != destination)
+    throw GraphError("CompressedGraph::edge_value: edge not in graph");
+  return out_value[at-out_target.data()];
+}
+
+
+template<class T>
+int CompressedGraph<T>::in_degree(NodeId node) const {
+  check_node(node,"in_degree");
+  return int(in_offset[node+1]-in_offset[node]);
+}
+
+
+template<class T>
+int CompressedGraph<T>::out_degree(NodeId node) const {
+  check_node(node,"out_degree");
+  return int(out_offset[node+1]-out_offset[node]);
+}
+
+
+template<class T>
+int CompressedGraph<T>::degree(NodeId node) const {
+  return in_degree(node) + out_degree(node);
+}
+
+
+template<class T>
+auto CompressedGraph<T>::out_edges(NodeId node) const -> Adjacency {
+  check_node(node,"out_edges");
+  return Adjacency(out_target.data()+out_offset[node], out_target.data()+out_offset[node+1],
+                   out_value.data()+out_offset[node]);
+}
+
+
+template<class T>
+auto CompressedGraph<T>::in_edges(NodeId node) const -> Adjacency {
+  check_node(node,"in_edges");
+  return Adjacency(in_source.data()+in_offset[node], in_source.data()+in_offset[node+1],
+                   in_value.data()+in_offset[node]);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+//Nodes in id (alphabetical) order, each with its out-edges: a -> b(12),c(13)
+template<class T>
+std::ostream& operator<<(std::ostream& outs, const CompressedGraph<T>& g) {
+  outs << "compressed_graph[" << std::endl;
+  for (int n=0; n<g.node_count(); ++n) {
+    outs << g.names[n] << "(" << n << ") ->";
+    typename CompressedGraph<T>::Adjacency out = g.out_edges(n);
+    for (int i=0; i<out.size(); ++i)
+      outs << (i == 0 ? " " : ",") << g.names[out.node(i)] << "(" << out.value(i) << ")";
+    outs << std::endl;
+  }
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T>
+void CompressedGraph<T>::check_node(NodeId node, const char* where) const {
+  if (node < 0 || node >= node_count()) {
+    std::ostringstream answer;
+    answer << "CompressedGraph::" << where << ": node id(" << node << ") not in [0," << node_count() << ")";
+    throw GraphError(answer.str());
+  }
+}
+
+
+//Sorts links by (from,to), then stores them as rows: row n (the links with
+//  from == n) is other/value[offset[n]..offset[n+1]-1]
+template<class T>
+void CompressedGraph<T>::build_rows(std::vector<Link>& links, std::vector<size_type>& offset,
+                                    std::vector<NodeId>& other, std::vector<T>& value) {
+  std::sort(links.begin(),links.end(),
+            [] (const Link& a, const Link& b) {return a.from < b.from || (a.from == b.from && a.to < b.to);});
+
+  offset.assign(names.size()+1,0);
+  other.clear();
+  value.clear();
+  other.reserve(links.size());
+  value.reserve(links.size());
+  for (const Link& l : links) {
+    ++offset[l.from+1];
+    other.push_back(l.to);
+    value.push_back(*l.value);
+  }
+  for (NodeId n=0; n<node_count(); ++n)
+    offset[n+1] += offset[n];
+}
+
+}
+
+#endif /* COMPRESSED_GRAPH_HPP_ */
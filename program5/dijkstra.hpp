@@ -6,15 +6,17 @@
 #include <fstream>
 #include <sstream>
 #include <limits>                    //Biggest int: std::numeric_limits<int>::max()
+#include <vector>
 #include "array_queue.hpp"
 #include "array_stack.hpp"
 #include "heap_priority_queue.hpp"
 #include "hash_graph.hpp"
+#include "indexed_heap.hpp"
 
 // Submitter jpascasc(Pascascio, Joshua)
 namespace ics {
 
-int str_hash(const std::string& s){std::hash<std::string> hashStr; return hashStr(s);}
+int str_hash(const std::string& s){return hash_of(s);}
 class Info {
   public:
     Info() { }
@@ -105,6 +107,76 @@ class Info {
        returnQueue.enqueue_all(routeStack);
        return returnQueue;
     }
+
+
+//Extended Dijkstra over node ids, for a graph frozen once (see DistGraph::freeze)
+//  and then searched from many start nodes: cost[n] is the least cost of a path
+//  from the start node to n (std::numeric_limits<int>::max() if there is none),
+//  and from[n] is the node before n on that path (the start node for itself;
+//  -1 if there is no path)
+  typedef ics::CompressedGraph<int> FrozenDistGraph;
+
+  class CostTable {
+  public:
+    std::vector<int> cost;
+    std::vector<int> from;
+  };
+
+  inline bool lt_cost(const int &a, const int &b) { return a < b; }
+
+  typedef ics::IndexedHeap<int, lt_cost> CostHeap;
+
+
+//Each node is in the heap at most once: finding a cheaper path to a node that
+//  is already there moves it up in place (decrease_key), so nothing is skipped
+//  when dequeued; the inner loop reads only ints (no strings, no hashing)
+  inline CostTable extended_dijkstra(const FrozenDistGraph &g, int start_node) {
+    if (start_node < 0 || start_node >= g.node_count())
+      throw GraphError("extended_dijkstra: start node id not in graph");
+    CostTable answer;
+    answer.cost.assign(g.node_count(), std::numeric_limits<int>::max());
+    answer.from.assign(g.node_count(), -1);
+    answer.cost[start_node] = 0;
+    answer.from[start_node] = start_node;
+
+    CostHeap frontier(g.node_count());
+    frontier.push(start_node, 0);
+    while (!frontier.empty()) {
+      int min_node = frontier.pop();
+      int min_cost = answer.cost[min_node];
+      FrozenDistGraph::Adjacency out = g.out_edges(min_node);
+      for (int i = 0; i < out.size(); ++i) {
+        int to = out.node(i);
+        int edge_cost = min_cost + out.value(i);
+        if (edge_cost < answer.cost[to]) {      //Never true for a dequeued node (costs are >= 0)
+          answer.cost[to] = edge_cost;
+          answer.from[to] = min_node;
+          if (frontier.contains(to))
+            frontier.decrease_key(to, edge_cost);
+          else
+            frontier.push(to, edge_cost);
+        }
+      }
+    }
+    return answer;
+  }
+
+
+//Return a queue of node ids whose front is the start node (implicit in answer)
+//  and whose rear is end_node; empty if there is no path to end_node
+  inline ArrayQueue<int> recover_path(const CostTable &answer, int end_node) {
+    ArrayQueue<int> path;
+    if (end_node < 0 || end_node >= int(answer.from.size()) || answer.from[end_node] == -1)
+      return path;
+    ArrayStack<int> route;
+    for (int n = end_node; ; n = answer.from[n]) {
+      route.push(n);
+      if (answer.from[n] == n)
+        break;
+    }
+    path.enqueue_all(route);
+    return path;
+  }
 }
 
 #endif /* DIJKSTRA_HPP_ */
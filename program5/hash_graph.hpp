@@ -8,9 +8,12 @@
 #include <initializer_list>
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
+#include "ics_hash.hpp"
+#include "string_view.hpp"
 #include "heap_priority_queue.hpp"
 #include "hash_set.hpp"
 #include "hash_map.hpp"
+#include "compressed_graph.hpp"
 
 //Submitter jpascasc(Pascascio,Joshua)
 namespace ics {
@@ -28,16 +31,29 @@ namespace ics {
     typedef pair<NodeName, NodeName>   Edge;
     typedef pair<NodeName, LocalInfo>  NodeLocalEntry;
 
+    //Queries take node names as views: a std::string, C-string, or StringView
+    //  (e.g., part of a line being parsed) is looked up without copying it
+    typedef StringView                 NodeView;
+    typedef pair<NodeView, NodeView>   EdgeView;
+
     //Static methods for hashing (in the maps) and for printing in alphabetic
     //  order the nodes in a graph (see << for HashGraph<T>)
     static int hash_str(const NodeName& s) {
-      std::hash<std::string> str_hash;
-      return str_hash(s);
+      return hash_of(s);
     }
 
+    //Order-sensitive: (a,b) and (b,a) hash differently
     static int hash_pair_str(const Edge& s) {
-      std::hash<std::string> str_hash;
-      return str_hash(s.first) * str_hash(s.second);
+      return hash_of(s);
+    }
+
+    //Equal to hash_str/hash_pair_str for the same characters
+    static int hash_view(const NodeView& s) {
+      return hash_of(s);
+    }
+
+    static int hash_pair_view(const EdgeView& s) {
+      return hash_of(s);
     }
 
     static bool LocalInfo_gt(const NodeLocalEntry& a, const NodeLocalEntry& b)
@@ -62,19 +78,23 @@ namespace ics {
     bool empty      ()                                     const;
     int  node_count ()                                     const;
     int  edge_count ()                                     const;
-    bool has_node  (std::string node_name)                 const;
-    bool has_edge  (NodeName origin, NodeName destination) const;
-    T    edge_value(NodeName origin, NodeName destination) const;
-    int  in_degree (NodeName node_name)                    const;
-    int  out_degree(NodeName node_name)                    const;
-    int  degree    (NodeName node_name)                    const;
+    bool has_node  (NodeView node_name)                    const;
+    bool has_edge  (NodeView origin, NodeView destination) const;
+    T    edge_value(NodeView origin, NodeView destination) const;
+    int  in_degree (NodeView node_name)                    const;
+    int  out_degree(NodeView node_name)                    const;
+    int  degree    (NodeView node_name)                    const;
 
     const NodeMap& all_nodes()                   const;
     const EdgeMap& all_edges()                   const;
-    const NodeSet& out_nodes(NodeName node_name) const;
-    const NodeSet& in_nodes (NodeName node_name) const;
-    const EdgeSet& out_edges(NodeName node_name) const;
-    const EdgeSet& in_edges (NodeName node_name) const;
+    const NodeSet& out_nodes(NodeView node_name) const;
+    const NodeSet& in_nodes (NodeView node_name) const;
+    const EdgeSet& out_edges(NodeView node_name) const;
+    const EdgeSet& in_edges (NodeView node_name) const;
+
+    //An immutable copy with dense int node ids and CSR adjacency arrays (see
+    //  compressed_graph.hpp): for graphs that are built once and then traversed
+    CompressedGraph<T> freeze() const;
 
     //Commands
     void add_node   (NodeName node_name);
@@ -82,6 +102,7 @@ namespace ics {
     void remove_node(NodeName node_name);
     void remove_edge(NodeName origin, NodeName destination);
     void clear      ();
+    void use_bloom_filters (bool on = true);   //In front of has_node/has_edge: helps when most return false
     void load       (std::ifstream& in_file,  std::string separator = ";");
     void store      (std::ofstream& out_file, std::string separator = ";");
 
@@ -173,6 +194,7 @@ HashGraph<T>::HashGraph (const HashGraph& g) {
        node_values[nE.first] = nE.second;
        node_values[nE.first].connect(this);
    }
+   use_bloom_filters(g.edge_values.bloom_filter() != nullptr);
 }
 
 
@@ -203,55 +225,56 @@ int HashGraph<T>::edge_count() const {
 
 //Returns whether or not node_name is in the graph
 template<class T>
-bool HashGraph<T>::has_node(NodeName node_name) const {
-    return node_values.has_key(node_name);
+bool HashGraph<T>::has_node(NodeView node_name) const {
+    return node_values.has_key(node_name,hash_view);
 }
 
 //Returns whether or not the edge is in the graph
 template<class T>
-bool HashGraph<T>::has_edge(NodeName origin, NodeName destination) const {
-    return edge_values.has_key(ics::pair<NodeName,NodeName>(origin,destination));
+bool HashGraph<T>::has_edge(NodeView origin, NodeView destination) const {
+    return edge_values.has_key(EdgeView(origin,destination),hash_pair_view);
     }
 
 
 //Returns the value of the edge in the graph; if the edge is not in the graph,
 //  throw a GraphError exception with appropriate descriptive text
 template<class T>
-T HashGraph<T>::edge_value(NodeName origin, NodeName destination) const {
-    if(!edge_values.has_key(ics::pair<NodeName,NodeName>(origin,destination)))
+T HashGraph<T>::edge_value(NodeView origin, NodeView destination) const {
+    EdgeView currentEdge(origin,destination);
+    if(!edge_values.has_key(currentEdge,hash_pair_view))
         throw ics::GraphError("HashGraph::edge_value: edge not in edge map");
-    Edge currentEdge = ics::pair<NodeName,NodeName>(origin,destination);
-    return edge_values[currentEdge];
+    return edge_values.get(currentEdge,hash_pair_view);
 }
 
 
 //Returns the in-degree of node_name; if that node is not in the graph,
 //  throw a GraphError exception with appropriate descriptive text
 template<class T>
-int HashGraph<T>::in_degree(NodeName node_name) const {
-    if(!node_values.has_key(node_name))
+int HashGraph<T>::in_degree(NodeView node_name) const {
+    if(!node_values.has_key(node_name,hash_view))
         throw ics::GraphError("HashGraph::in_degree: node not in HashGraph");
-    return node_values[node_name].in_edges.size();
+    return node_values.get(node_name,hash_view).in_edges.size();
 }
 
 
 //Returns the out-degree of node_name; if that node is not in the graph,
 //  throw a GraphError exception with appropriate descriptive text
 template<class T>
-int HashGraph<T>::out_degree(NodeName node_name) const {
-        if(!node_values.has_key(node_name))
+int HashGraph<T>::out_degree(NodeView node_name) const {
+        if(!node_values.has_key(node_name,hash_view))
             throw ics::GraphError("HashGraph::out_degree: node not in HashGraph");
-        return node_values[node_name].out_edges.size();
+        return node_values.get(node_name,hash_view).out_edges.size();
     }
 
 
 //Returns the degree of node_name; if that node is not in the graph,
 //  throw a GraphError exception with appropriate descriptive text.
 template<class T>
-int HashGraph<T>::degree(NodeName node_name) const {
-    if(!node_values.has_key(node_name))
+int HashGraph<T>::degree(NodeView node_name) const {
+    if(!node_values.has_key(node_name,hash_view))
         throw ics::GraphError("HashGraph::degree: node not in HashGraph");
-    return node_values[node_name].in_edges.size() + node_values[node_name].out_edges.size();
+    const LocalInfo& li = node_values.get(node_name,hash_view);
+    return li.in_edges.size() + li.out_edges.size();
     }
 
 
@@ -275,10 +298,10 @@ auto HashGraph<T>::all_edges () const -> const EdgeMap& {
 //  if that node is not in the graph, throw a GraphError exception with
 //  appropriate  descriptive text
 template<class T>
-auto HashGraph<T>::out_nodes(NodeName node_name) const -> const NodeSet& {
-    if(!node_values.has_key(node_name))
+auto HashGraph<T>::out_nodes(NodeView node_name) const -> const NodeSet& {
+    if(!node_values.has_key(node_name,hash_view))
         throw ics::GraphError("HashGraph::out_node: node not in HashGraph");
-    return node_values[node_name].out_nodes;
+    return node_values.get(node_name,hash_view).out_nodes;
     }
 
 
@@ -287,10 +310,10 @@ auto HashGraph<T>::out_nodes(NodeName node_name) const -> const NodeSet& {
 //  if that node is not in the graph, throw a GraphError exception with
 //  appropriate descriptive text
 template<class T>
-auto HashGraph<T>::in_nodes(NodeName node_name) const -> const NodeSet& {
-        if(!node_values.has_key(node_name))
+auto HashGraph<T>::in_nodes(NodeView node_name) const -> const NodeSet& {
+        if(!node_values.has_key(node_name,hash_view))
             throw ics::GraphError("HashGraph::in_node: node not in HashGraph");
-        return node_values[node_name].in_nodes;
+        return node_values.get(node_name,hash_view).in_nodes;
     }
 
 
@@ -299,10 +322,10 @@ auto HashGraph<T>::in_nodes(NodeName node_name) const -> const NodeSet& {
 //  if that node is not in the graph, throw a GraphError exception with
 //  appropriate descriptive text
 template<class T>
-auto HashGraph<T>::out_edges(NodeName node_name) const -> const EdgeSet& {
-        if(!node_values.has_key(node_name))
+auto HashGraph<T>::out_edges(NodeView node_name) const -> const EdgeSet& {
+        if(!node_values.has_key(node_name,hash_view))
             throw ics::GraphError("HashGraph::out_node: node not in HashGraph");
-        return node_values[node_name].out_edges;
+        return node_values.get(node_name,hash_view).out_edges;
     }
 
 
@@ -311,13 +334,21 @@ auto HashGraph<T>::out_edges(NodeName node_name) const -> const EdgeSet& {
 //  if that node is not in the graph, throw a GraphError exception with
 //  appropriate descriptive text
 template<class T>
-auto HashGraph<T>::in_edges(NodeName node_name) const -> const EdgeSet& {
-        if(!node_values.has_key(node_name))
+auto HashGraph<T>::in_edges(NodeView node_name) const -> const EdgeSet& {
+        if(!node_values.has_key(node_name,hash_view))
             throw ics::GraphError("HashGraph::out_node: node not in HashGraph");
-        return node_values[node_name].in_edges;
+        return node_values.get(node_name,hash_view).in_edges;
     }
 
 
+//Returns a CompressedGraph of this graph's current nodes and edges; later
+//  changes to this graph do not affect it
+template<class T>
+CompressedGraph<T> HashGraph<T>::freeze() const {
+    return CompressedGraph<T>(*this);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Commands
@@ -399,6 +430,15 @@ void HashGraph<T>::clear() {
 }
 
 
+//Turn on (or off) the Bloom filters of the node and edge maps, so that looking
+//  up an absent node or edge usually searches no bin
+template<class T>
+void HashGraph<T>::use_bloom_filters(bool on) {
+    node_values.use_bloom_filter(on);
+    edge_values.use_bloom_filter(on);
+}
+
+
 //Load the nodes and edges for a graph from a text file whose form is
 // (a) a node name (one per line)
 // followed by
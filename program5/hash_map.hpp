@@ -3,9 +3,21 @@
 
 #include <string>
 #include <iostream>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <initializer_list>
+#include <utility>
+#include <vector>
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
+#include "node_pool.hpp"
+#include "size_hint.hpp"
+#include "bloom_filter.hpp"
+#include "hash_stats.hpp"
+#include "prefetch.hpp"
+#include "parallel.hpp"
+#include "frozen_hash_map.hpp"
 
 
 namespace ics {
@@ -33,6 +45,7 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
     HashMap          (double the_load_threshold = 1.0, int (*chash)(const KEY& a) = undefinedhash<KEY>);
     explicit HashMap (int initial_bins, double the_load_threshold = 1.0, int (*chash)(const KEY& k) = undefinedhash<KEY>);
     HashMap          (const HashMap<KEY,T,thash>& to_copy, double the_load_threshold = 1.0, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    HashMap          (HashMap<KEY,T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
     explicit HashMap (const std::initializer_list<Entry>& il, double the_load_threshold = 1.0, int (*chash)(const KEY& a) = undefinedhash<KEY>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -41,21 +54,77 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    bool has_key    (const KEY& key) const;
-    bool has_value  (const T& value) const;
+    bool      empty      () const;
+    size_type size       () const;
+    bool      has_key    (const KEY& key) const;
+    bool      has_value  (const T& value) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
+    HashStats   stats () const; //Chain lengths, rehashes, and probes per search (see hash_stats.hpp): for big tables
+
+    //Heterogeneous lookup: key is a LOOKUP (e.g., StringView for std::string keys), so no KEY
+    //  is built; LOOKUP == KEY must be defined and lookup_hash(key) must equal hash(KEY(key))
+    template <class LOOKUP>
+    bool     has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;
+    template <class LOOKUP>
+    const T& get     (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const;  //KeyError if absent, like []
+
+    //Batched lookup of keys[0..n-1]: each batch of keys is hashed and its bins prefetched
+    //  before any is searched (see prefetch.hpp), so for many keys it beats has_key/[] in a loop.
+    //  found[i] points to keys[i]'s value (nullptr if absent); returns the # of keys found
+    size_type find_many (const KEY keys[], size_type n, const T* found[]) const;
+
+    //An immutable copy for a map that is now only read (see frozen_hash_map.hpp):
+    //  keys/values in flat arrays, placed by a minimal perfect hash, so it is
+    //  smaller and each lookup is one probe
+    FrozenHashMap<KEY,T,thash> freeze () const;
 
 
     //Commands
     T    put   (const KEY& key, const T& value);
+    T    put   (const KEY& key, T&& value);
     T    erase (const KEY& key);
     void clear ();
+    void set_incremental_rehash (size_type bins_per_op);  //0 (the default): move all bins at once when growing (>0: erase never shrinks)
+    void reserve (size_type n);   //Grow now, so putting up to n keys never rehashes (and erase never shrinks the table below that)
+    void rehash  (size_type n);   //Use >= n bins (fewer if possible, but enough for size() keys); moves all keys now
+    void shrink_to_fit ();  //Fewest bins holding size() keys (erase/clear shrink only below load_threshold/4; undoes reserve)
+    void clear_stats ();    //Restart counting the rehashes and probes reported by stats()
+
+    //A BloomFilter (off by default) rejects most absent keys before any bin is searched:
+    //  turn it on when most has_key/get/put calls are for absent keys
+    void use_bloom_filter (bool on = true);
+    const BloomFilter* bloom_filter () const;   //nullptr when off; has the false_positive_rate
+
+    //If key is not in the map, put key with the value T(args...); if it is, leave
+    //  its value unchanged (and construct no T). Either way, return key's value.
+    template <class... Args>
+    T&   emplace (const KEY& key, Args&&... args);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
-    int put_all(const Iterable& i);
+    size_type put_all(const Iterable& i);
+
+    //Puts each entry (with .first/.second) in [begin,end) like put_all does (for a key put
+    //  more than once, the last value wins), but on threads threads (0 means hardware_concurrency;
+    //  fewer for few entries): keys are hashed in parallel and grouped by the range of bins each
+    //  thread owns, then each thread links the nodes into its own bins, with no locking.
+    //  hash, KEY's ==, and KEY's/T's copy constructors are called on several threads at once.
+    //  Returns the # of entries put
+    template <class Iter>
+    size_type build_parallel(Iter begin, Iter end, int threads = 0);
+
+    //Moving nodes between maps (with the same KEY/T/thash) by relinking them: no node is
+    //  allocated and no key/value is copied (a node's cached hash code is reused when both
+    //  maps use the same hash).
+    //extract unlinks key's node and returns it in a Node (empty if key is not in the map).
+    //insert links node's node in, if its key is not in the map: then node becomes empty and
+    //  true is returned; otherwise node is unchanged and false is returned.
+    //merge moves each of other's nodes whose key is not in this map into it (a key in both
+    //  stays in other, with its value); returns the # of nodes moved
+    class Node;
+    Node      extract (const KEY& key);
+    bool      insert  (Node&& node);
+    size_type merge   (HashMap<KEY,T,thash>& other);
 
 
     //Operators
@@ -63,6 +132,7 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
     T&       operator [] (const KEY&);
     const T& operator [] (const KEY&) const;
     HashMap<KEY,T,thash>& operator = (const HashMap<KEY,T,thash>& rhs);
+    HashMap<KEY,T,thash>& operator = (HashMap<KEY,T,thash>&& rhs);   //Swaps contents (and hash) with rhs
     bool operator == (const HashMap<KEY,T,thash>& rhs) const;
     bool operator != (const HashMap<KEY,T,thash>& rhs) const;
 
@@ -77,7 +147,7 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
   public:
     class Iterator {
       public:
-         typedef pair<int,LN*> Cursor;
+         typedef pair<size_type,LN*> Cursor;
 
         //Private constructor called in begin/end, which are friends of HashMap<T>
         ~Iterator();
@@ -100,7 +170,7 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
         Cursor                current; //Bin Index and Cursor; stop: LN* == nullptr
         HashMap<KEY,T,thash>* ref_map;
-        int                   expected_mod_count;
+        size_type             expected_mod_count;
         bool                  can_erase = true;
 
         //Helper methods
@@ -115,33 +185,87 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
     Iterator end   () const;
 
 
+    //Owns a node extracted from a HashMap (see extract/insert): it can be moved, not copied.
+    //key/value throw EmptyError when it is empty (by default, and after being moved from or inserted)
+    class Node {
+      public:
+        Node () {}
+        Node (Node&& to_move);
+        ~Node ();
+        Node& operator = (Node&& rhs);
+        bool       empty () const;
+        const KEY& key   () const;
+        T&         value () const;
+
+      private:
+        LN*      node = nullptr;
+        hashfunc hash = nullptr;      //The hash of the map node came from: node->hash_code is hash(key())
+
+        Node (LN* n, hashfunc h);     //Called in extract; HashMap reads/clears node in insert
+        friend class HashMap<KEY,T,thash>;
+    };
+
+
   private:
-    class LN {
+    class LN : public PoolAllocated {
     public:
-      LN ()                         : next(nullptr){}
-      LN (const LN& ln)             : value(ln.value), next(ln.next){}
-      LN (Entry v, LN* n = nullptr) : value(v), next(n){}
+      LN ()                                : hash_code(0), next(nullptr){}
+      LN (const LN& ln)                    : value(ln.value), hash_code(ln.hash_code), next(ln.next){}
+      LN (Entry v, int h, LN* n = nullptr) : value(std::move(v)), hash_code(h), next(n){}
+      LN& operator = (LN&& ln) = default;
 
       Entry value;
+      int   hash_code;        //hash(value.first): compared before keys; reused when rehashing
       LN*   next;
   };
 
+public:
   int (*hash)(const KEY& k);  //Hashing function used (from template or constructor)
+private:
   LN** map      = nullptr;    //Pointer to array of pointers: each bin stores a list with a trailer node
   double load_threshold;      //used/bins <= load_threshold
-  int bins      = 1;          //# bins in array (should start at 1 so hash_compress doesn't % 0)
-  int used      = 0;          //Cache for number of key->value pairs in the hash table
-  int mod_count = 0;          //For sensing concurrent modification
+  size_type bins      = 1;    //# bins in array (should start at 1 so compress doesn't % 0)
+  size_type used      = 0;    //Cache for number of key->value pairs in the hash table
+  size_type mod_count = 0;    //For sensing concurrent modification
+  size_type reserved_bins = 1;  //reserve()'s bins: erase never shrinks below them; shrink_to_fit/clear reset it
 
+  LN**      old_map     = nullptr; //While growing incrementally: the smaller table whose bins are moving into map
+  size_type old_bins    = 0;       //# bins in old_map
+  size_type migrated    = 0;       //old_map[0..migrated-1] have been moved (and are nullptr);
+                                   //  map[b] gets its trailer when old_map[b % old_bins] is moved (nullptr before)
+  size_type rehash_step = 0;       //# old_map bins moved per put/erase; 0 means grow all at once
+  BloomFilter* bloom = nullptr; //If not nullptr: has the hash_code of every key (and maybe erased ones)
+  size_type rehashes    = 0;       //For stats(): # times keys were moved to a table with a different # of bins
+  ProbeCounter probes;        //For stats(): searches and the keys they compared
+
+  static const size_type parallel_grain = 4096;   //Fewest entries worth starting another thread for
 
-  //Helper methods
-  int   hash_compress        (const KEY& key)          const;  //hash function ranged to [0,bins-1]
-  LN*   find_key             (const KEY& key)          const;  //Returns reference to key's node or nullptr
-  LN*   copy_list            (LN*   l)                 const;  //Copy the keys/values in a bin (order irrelevant)
-  LN**  copy_hash_table      (LN** ht, int bins)       const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
 
-  void  ensure_load_threshold(int new_used);                   //Reallocate if load_factor > load_threshold
-  void  delete_hash_table    (LN**& ht, int bins);             //Deallocate all LN in ht (and the ht itself; ht == nullptr)
+  //Helper methods
+  int       call_hash            (const KEY& key)          const;  //thash(key) if given (a direct call: inlinable), else hash(key)
+  size_type compress             (int hash_code)           const;  //hash code ranged to [0,bins-1] (bins is a power of 2)
+  static size_type power_of_2_bins (size_type at_least);           //Smallest power of 2 >= at_least (and >= 1)
+  size_type bins_for             (size_type n)             const;  //Fewest bins (a power of 2) holding n keys within load_threshold
+  template <class LOOKUP>
+  LN*       find_key             (const LOOKUP& key, int hash_code) const;  //Returns reference to key's node or nullptr
+  LN*&      home_bin             (int hash_code)           const;  //Bin storing keys with hash_code: in map or old_map
+  size_type all_bins             ()                        const;  //# bins in map and old_map, for iterating over both
+  LN*       bin_list             (size_type b)             const;  //b < bins: map[b]; otherwise old_map[b-bins]
+  LN*       copy_list            (LN*   l)                 const;  //Copy the keys/values in a bin (order irrelevant)
+  LN**      copy_hash_table      (LN** ht, size_type bins) const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
+  void      copy_nodes           (const HashMap<KEY,T,thash>& from);  //Link copies of from's nodes in: none of its keys here, same hash
+  LN*       unlink_key           (const KEY& key, int hash_code);     //Unlink and return key's node (nullptr if none); moves no value
+  void      link_node            (LN* node);                          //Link in node, whose key is not here (its hash_code is set)
+
+  void  ensure_load_threshold    (size_type new_used);             //Reallocate if load_factor > load_threshold
+  void  ensure_load_threshold_low(size_type new_used);             //Reallocate if load_factor < load_threshold/4
+  void  grow_for             (size_type n);                        //Grow now to hold n keys: reserve without raising reserved_bins
+  void  rehash_some          (size_type old_bins_to_move);         //Move bins from old_map to map; delete it when empty
+  void  delete_hash_table    (LN**& ht, size_type bins);           //Deallocate all LN in ht (and the ht itself; ht == nullptr)
+
+  void  bloom_insert         (int hash_code);                  //Record a new key in bloom (if any)
+  void  bloom_erase          ();                               //Record an erased key; rebuild bloom if stale
+  void  rebuild_bloom        ();                               //Reset bloom for 2*used keys and insert all
 };
 
 
@@ -156,6 +280,8 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
 template<class KEY,class T, int (*thash)(const KEY& a)>
 HashMap<KEY,T,thash>::~HashMap() {
   delete_hash_table(map,bins);
+  delete_hash_table(old_map,old_bins);
+  delete bloom;
 }
 
 
@@ -168,7 +294,7 @@ HashMap<KEY,T,thash>::HashMap(double the_load_threshold, int (*chash)(const KEY&
     throw TemplateFunctionError("HashMap::default constructor: both specified and different");
 
   map = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     map[b] = new LN();         //Put a trailer node in bin
 }
 
@@ -181,10 +307,9 @@ HashMap<KEY,T,thash>::HashMap(int initial_bins, double the_load_threshold, int (
   if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
     throw TemplateFunctionError("HashMap::length constructor: both specified and different");
 
-  if (bins < 1)
-    bins = 1;
+  bins = power_of_2_bins(bins);
   map = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     map[b] = new LN();         //Put a trailer node in bin
 }
 
@@ -197,32 +322,57 @@ HashMap<KEY,T,thash>::HashMap(const HashMap<KEY,T,thash>& to_copy, double the_lo
   if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
     throw TemplateFunctionError("HashMap::copy constructor: both specified and different");
 
-  if (hash == to_copy.hash && (double)to_copy.size()/to_copy.bins <= the_load_threshold) {
+  if (hash == to_copy.hash && to_copy.old_map == nullptr && (double)to_copy.size()/to_copy.bins <= the_load_threshold) {
     used = to_copy.used;
     map  = copy_hash_table(to_copy.map,to_copy.bins);
   }else {
-    bins = std::max(1,int(to_copy.size()/load_threshold));
+    bins = power_of_2_bins(size_type(to_copy.size()/load_threshold));
     map = new LN*[bins];
-    for (int b=0; b<bins; ++b)
+    for (size_type b=0; b<bins; ++b)
       map[b] = new LN();         //Put a trailer node in bin
 
-    for (int b=0; b<to_copy.bins; ++b)
-      for (LN* c = to_copy.map[b]; c->next!=nullptr; c=c->next)
-        put(c->value.first,c->value.second);
+    if (hash == to_copy.hash)
+      copy_nodes(to_copy);
+    else
+      for (size_type b=0; b<to_copy.all_bins(); ++b)
+        for (LN* c = to_copy.bin_list(b); c->next!=nullptr; c=c->next)
+          put(c->value.first,c->value.second);
   }
+
+  if (to_copy.bloom != nullptr)
+    use_bloom_filter();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+HashMap<KEY,T,thash>::HashMap(HashMap<KEY,T,thash>&& to_move)
+: hash(to_move.hash), load_threshold(to_move.load_threshold), rehash_step(to_move.rehash_step) {
+  map = new LN*[bins];
+  for (size_type b=0; b<bins; ++b)
+    map[b] = new LN();         //Put a trailer node in bin (for to_move, after swapping)
+
+  std::swap(map,     to_move.map);
+  std::swap(bins,    to_move.bins);
+  std::swap(used,    to_move.used);
+  std::swap(reserved_bins,to_move.reserved_bins);
+  std::swap(old_map, to_move.old_map);
+  std::swap(old_bins,to_move.old_bins);
+  std::swap(migrated,to_move.migrated);
+  std::swap(bloom,   to_move.bloom);
+  ++to_move.mod_count;
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 HashMap<KEY,T,thash>::HashMap(const std::initializer_list<Entry>& il, double the_load_threshold, int (*chash)(const KEY& k))
-: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold), bins(std::max(1,int(il.size()/the_load_threshold))) {
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold), bins(power_of_2_bins(size_type(il.size()/the_load_threshold))) {
   if (hash == (hashfunc)undefinedhash<KEY>)
     throw TemplateFunctionError("HashMap::initializer_list constructor: neither specified");
   if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
     throw TemplateFunctionError("HashMap::initializer_list constructor: both specified and different");
 
   map = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     map[b] = new LN();
 
   for (const Entry& m_entry : il)
@@ -233,14 +383,14 @@ HashMap<KEY,T,thash>::HashMap(const std::initializer_list<Entry>& il, double the
 template<class KEY,class T, int (*thash)(const KEY& a)>
 template <class Iterable>
 HashMap<KEY,T,thash>::HashMap(const Iterable& i, double the_load_threshold, int (*chash)(const KEY& k))
-: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold), bins(std::max(1,int(i.size()/the_load_threshold))) {
+: hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash), load_threshold(the_load_threshold), bins(power_of_2_bins(size_type(i.size()/the_load_threshold))) {
   if (hash == (hashfunc)undefinedhash<KEY>)
     throw TemplateFunctionError("HashMap::Iterable constructor: neither specified");
   if (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash)
     throw TemplateFunctionError("HashMap::Iterable constructor: both specified and different");
 
   map = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     map[b] = new LN();
 
   for (const Entry& m_entry : i)
@@ -259,21 +409,83 @@ bool HashMap<KEY,T,thash>::empty() const {
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
-int HashMap<KEY,T,thash>::size() const {
+size_type HashMap<KEY,T,thash>::size() const {
   return used;
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 bool HashMap<KEY,T,thash>::has_key (const KEY& key) const {
-  return find_key(key) != nullptr;
+  return find_key(key,call_hash(key)) != nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+bool HashMap<KEY,T,thash>::has_key (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  return find_key(key,lookup_hash(key)) != nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template <class LOOKUP>
+const T& HashMap<KEY,T,thash>::get (const LOOKUP& key, int (*lookup_hash)(const LOOKUP& k)) const {
+  LN* c = find_key(key,lookup_hash(key));
+  if (c != nullptr)
+    return c->value.second;
+
+  std::ostringstream answer;
+  answer << "HashMap::get: key(" << key << ") not in Map";
+  throw KeyError(answer.str());
+}
+
+
+//Three passes over each batch: hash the keys and prefetch their bins' pointers;
+//  prefetch each bin's first node; then search, finding most of it in the cache
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type HashMap<KEY,T,thash>::find_many (const KEY keys[], size_type n, const T* found[]) const {
+  size_type count = 0;
+  int       codes[lookup_batch];
+  LN**      heads[lookup_batch];
+  for (size_type i=0; i<n; i+=lookup_batch) {
+    size_type in_batch = std::min<size_type>(lookup_batch,n-i);
+    for (size_type j=0; j<in_batch; ++j) {
+      codes[j] = call_hash(keys[i+j]);
+      heads[j] = &home_bin(codes[j]);
+      prefetch(heads[j]);
+    }
+    for (size_type j=0; j<in_batch; ++j)
+      prefetch(*heads[j]);
+    for (size_type j=0; j<in_batch; ++j) {
+      LN* c = find_key(keys[i+j],codes[j]);
+      found[i+j] = (c == nullptr ? nullptr : &c->value.second);
+      if (c != nullptr)
+        ++count;
+    }
+  }
+  return count;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+FrozenHashMap<KEY,T,thash> HashMap<KEY,T,thash>::freeze () const {
+  std::vector<Entry> entries;
+  std::vector<int>   codes;
+  entries.reserve(used);
+  codes.reserve(used);
+  for (size_type b=0; b<all_bins(); ++b)
+    for (LN* c = bin_list(b); c->next!=nullptr; c=c->next) {
+      entries.push_back(c->value);
+      codes.push_back(c->hash_code);
+    }
+  return FrozenHashMap<KEY,T,thash>(std::move(entries),std::move(codes),hash);
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 bool HashMap<KEY,T,thash>::has_value (const T& value) const {
-  for (int b=0; b<bins; ++b)
-    for (LN* c = map[b]; c->next!=nullptr; c=c->next)
+  for (size_type b=0; b<all_bins(); ++b)
+    for (LN* c = bin_list(b); c->next!=nullptr; c=c->next)
       if (value == c->value.second)
         return true;
 
@@ -287,18 +499,45 @@ std::string HashMap<KEY,T,thash>::str() const {
   answer << "HashMap[";
   if (bins != 0) {
     answer << std::endl;
-    for (int b=0; b<bins; ++b) {
+    for (size_type b=0; b<bins; ++b) {
       answer << "  bin[" << b << "] = ";
-      for (LN* c = map[b]; c->next!=nullptr; c=c->next)
+      for (LN* c = bin_list(b); c->next!=nullptr; c=c->next)
+        answer << c->value.first << "->" << c->value.second << " -> " ;
+      answer << "TRAILER" << std::endl;
+    }
+    for (size_type b=0; b<old_bins; ++b) {
+      answer << "  old bin[" << b << "] = ";
+      for (LN* c = bin_list(bins+b); c->next!=nullptr; c=c->next)
         answer << c->value.first << "->" << c->value.second << " -> " ;
       answer << "TRAILER" << std::endl;
     }
   }
-  answer  << "](load_threshold=" << load_threshold << ",bins=" << bins << ",used=" <<used <<",mod_count=" << mod_count << ")";
+  answer  << "](load_threshold=" << load_threshold << ",bins=" << bins << ",used=" <<used <<",mod_count=" << mod_count;
+  if (old_map != nullptr)
+    answer << ",old_bins=" << old_bins << ",migrated=" << migrated;
+  answer << ")";
   return answer.str();
 }
 
 
+template<class KEY,class T, int (*thash)(const KEY& a)>
+HashStats HashMap<KEY,T,thash>::stats() const {
+  HashStats answer;
+  answer.bins        = all_bins();
+  answer.used        = used;
+  answer.load_factor = double(used)/double(answer.bins);
+  for (size_type b=0; b<all_bins(); ++b) {
+    size_type length = 0;
+    for (LN* c = bin_list(b); c->next!=nullptr; c=c->next)
+      ++length;
+    answer.add_chain(length);
+  }
+  answer.rehashes = rehashes;
+  probes.fill(answer);
+  return answer;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Commands
@@ -306,7 +545,9 @@ std::string HashMap<KEY,T,thash>::str() const {
 template<class KEY,class T, int (*thash)(const KEY& a)>
 T HashMap<KEY,T,thash>::put(const KEY& key, const T& value) {
   T to_return;
-  LN* c = find_key(key);
+  rehash_some(rehash_step);
+  int code = call_hash(key);
+  LN* c = find_key(key,code);
   if (c != nullptr) {
     to_return = c->value.second;
     c->value.second = value;
@@ -314,8 +555,32 @@ T HashMap<KEY,T,thash>::put(const KEY& key, const T& value) {
     to_return = value;
     ensure_load_threshold(used+1);
     ++used;
-    int bin = hash_compress(key);                  //bins may have changed in ensure_load_threshold!
-    map[bin] = new LN(Entry(key,value),map[bin]);  //easy to put at front: bin LNs unordered
+    LN*& bin = home_bin(code);                //bins may have changed in ensure_load_threshold!
+    bin = new LN(Entry(key,value),code,bin);  //easy to put at front: bin LNs unordered
+    bloom_insert(code);
+  }
+
+  ++mod_count;
+  return to_return;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T HashMap<KEY,T,thash>::put(const KEY& key, T&& value) {
+  T to_return;
+  rehash_some(rehash_step);
+  int code = call_hash(key);
+  LN* c = find_key(key,code);
+  if (c != nullptr) {
+    to_return = std::move(c->value.second);
+    c->value.second = std::move(value);
+  }else{
+    to_return = value;
+    ensure_load_threshold(used+1);
+    ++used;
+    LN*& bin = home_bin(code);
+    bin = new LN(Entry(key,std::move(value)),code,bin);
+    bloom_insert(code);
   }
 
   ++mod_count;
@@ -325,27 +590,32 @@ T HashMap<KEY,T,thash>::put(const KEY& key, const T& value) {
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 T HashMap<KEY,T,thash>::erase(const KEY& key) {
-  LN* c = find_key(key);
+  LN* c = find_key(key,call_hash(key));
   if (c == nullptr) {
     std::ostringstream answer;
     answer << "HashMap::erase: key(" << key << ") not in Map";
     throw KeyError(answer.str());
   }
-  T to_return = c->value.second;
+  T to_return = std::move(c->value.second);
   LN* to_delete = c->next;
-  *c = *(c->next);
+  *c = std::move(*(c->next));
   delete to_delete;
+  rehash_some(rehash_step);
 
   --used;
   ++mod_count;
+  bloom_erase();
+  ensure_load_threshold_low(used);
   return to_return;
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 void HashMap<KEY,T,thash>::clear() {
+  rehash_some(old_bins);  //So every bin in map has a trailer
+
   //Leave Trailers in bins
-  for (int b=0; b<bins; ++b) {
+  for (size_type b=0; b<bins; ++b) {
     LN* c=map[b];
     for (; c->next!=nullptr; /*See body*/) {
       LN* to_delete = c;
@@ -357,13 +627,121 @@ void HashMap<KEY,T,thash>::clear() {
 
   used = 0;
   ++mod_count;
+  reserved_bins = 1;
+  rehash(0);              //Release all but 1 bin
+  if (bloom != nullptr)
+    bloom->reset(0);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::set_incremental_rehash(size_type bins_per_op) {
+  rehash_step = std::max<size_type>(0,bins_per_op);
+  if (rehash_step == 0)
+    rehash_some(old_bins);      //Finish any growth in progress
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::reserve(size_type n) {
+  reserved_bins = std::max(reserved_bins,bins_for(n));
+  grow_for(n);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::rehash(size_type n) {
+  rehash_some(old_bins);      //Finish moving bins from any earlier growth
+  size_type new_bins = power_of_2_bins(std::max(n,bins_for(used)));
+  ++mod_count;
+  if (new_bins == bins)
+    return;
+
+  ++rehashes;
+  LN**      old_table = map;
+  size_type old_count = bins;
+  bins      = new_bins;
+  map       = new LN*[bins];
+  for (size_type b=0; b<bins; ++b)
+    map[b] = new LN();
+
+  for (size_type b=0; b<old_count; ++b) {
+    LN* c = old_table[b];
+    for (; c->next!=nullptr; /*See body*/) {
+      size_type bin = compress(c->hash_code);  //no need to call hash again
+      LN* to_move = c;
+      c = c->next;
+      to_move->next = map[bin];
+      map[bin] = to_move;
+    }
+    delete c;           //deallocate trailer in old_table
+  }
+  delete[] old_table;
+
+  if (bloom != nullptr)
+    rebuild_bloom();      //resized to the (possibly smaller) size()
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::shrink_to_fit() {
+  reserved_bins = 1;
+  rehash(0);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::clear_stats() {
+  rehashes = 0;
+  probes.clear();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::use_bloom_filter(bool on) {
+  if (!on) {
+    delete bloom;
+    bloom = nullptr;
+    return;
+  }
+
+  if (bloom == nullptr)
+    bloom = new BloomFilter();
+  rebuild_bloom();
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const BloomFilter* HashMap<KEY,T,thash>::bloom_filter() const {
+  return bloom;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class... Args>
+T& HashMap<KEY,T,thash>::emplace(const KEY& key, Args&&... args) {
+  int code = call_hash(key);
+  LN* c = find_key(key,code);
+  if (c != nullptr)
+    return c->value.second;
+
+  rehash_some(rehash_step);
+  ensure_load_threshold(used+1);
+  ++used;
+  ++mod_count;
+  LN*& bin = home_bin(code);
+
+  bin = new LN(Entry(key,T(std::forward<Args>(args)...)),code,bin);
+  bloom_insert(code);
+  return bin->value.second;
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 template<class Iterable>
-int HashMap<KEY,T,thash>::put_all(const Iterable& i) {
-  int count = 0;
+size_type HashMap<KEY,T,thash>::put_all(const Iterable& i) {
+  grow_for(used+size_hint(i));
+  size_type count = 0;
   for (const Entry& m_entry : i) {
     ++count;
     put(m_entry.first, m_entry.second);
@@ -373,29 +751,155 @@ int HashMap<KEY,T,thash>::put_all(const Iterable& i) {
 }
 
 
+//Each thread writes only its own bins (and allocates their nodes from its own
+//  NodePool free lists). Probes are not counted: when counting is on (see
+//  ICS_HASH_PROBE_STATS), a ProbeCounter is not thread-safe.
+template<class KEY,class T, int (*thash)(const KEY& a)>
+template<class Iter>
+size_type HashMap<KEY,T,thash>::build_parallel(Iter begin, Iter end, int threads) {
+  std::vector<decltype(&*begin)> entries;
+  for (Iter i=begin; i!=end; ++i)
+    entries.push_back(&*i);
+  size_type n = entries.size();
+  rehash_some(old_bins);  //So every key's bin is in map
+  grow_for(used+n);
+  ++mod_count;
+  threads = int(std::min<size_type>(threads_for(threads,n,parallel_grain),bins));
+
+  std::vector<int> codes(n);
+  on_threads(threads, [&] (int t) {
+    for (size_type i=chunk_begin(n,t,threads); i<chunk_begin(n,t+1,threads); ++i)
+      codes[i] = call_hash(entries[i]->first);
+  });
+
+  size_type bins_per_thread = (bins+threads-1)/threads;
+  std::vector<size_type> order, start;
+  partition_parallel(n, threads, [&] (size_type i) {return int(compress(codes[i])/bins_per_thread);},
+                     threads, order, start);
+
+  std::vector<size_type> added(threads,0);
+  on_threads(threads, [&] (int t) {
+    size_type count = 0;
+    for (size_type k=start[t]; k<start[t+1]; ++k) {
+      size_type i = order[k];
+      LN*& bin = map[compress(codes[i])];
+      LN*  c   = bin;
+      while (c->next!=nullptr && !(codes[i] == c->hash_code && entries[i]->first == c->value.first))
+        c = c->next;
+      if (c->next != nullptr)
+        c->value.second = entries[i]->second;
+      else {
+        bin = new LN(Entry(entries[i]->first,entries[i]->second),codes[i],bin);
+        ++count;
+      }
+    }
+    added[t] = count;
+  });
+
+  for (size_type count : added)
+    used += count;
+  if (bloom != nullptr)
+    rebuild_bloom();
+  return n;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+typename HashMap<KEY,T,thash>::Node HashMap<KEY,T,thash>::extract(const KEY& key) {
+  LN* c = unlink_key(key,call_hash(key));
+  if (c == nullptr)
+    return Node();
+  rehash_some(rehash_step);
+
+  --used;
+  ++mod_count;
+  bloom_erase();
+  ensure_load_threshold_low(used);
+  return Node(c,hash);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool HashMap<KEY,T,thash>::insert(Node&& node) {
+  if (node.empty())
+    return false;
+
+  LN* c    = node.node;
+  int code = (node.hash == hash ? c->hash_code : call_hash(c->value.first));
+  if (find_key(c->value.first,code) != nullptr)
+    return false;
+
+  rehash_some(rehash_step);
+  ++mod_count;
+  c->hash_code = code;
+  link_node(c);
+  node.node = nullptr;
+  return true;
+}
+
+
+//Keeps a pointer to the link to each of other's nodes, so a node is unlinked
+//  from other's bin without moving any value (as erase does)
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type HashMap<KEY,T,thash>::merge(HashMap<KEY,T,thash>& other) {
+  if (this == &other || other.used == 0)
+    return 0;
+  other.rehash_some(other.old_bins);  //So all of other's nodes are in other.map
+  grow_for(used+other.used);
+
+  size_type moved = 0;
+  for (size_type b=0; b<other.bins; ++b)
+    for (LN** link = &other.map[b]; (*link)->next!=nullptr; /*See body*/) {
+      LN* c    = *link;
+      int code = (other.hash == hash ? c->hash_code : call_hash(c->value.first));
+      if (find_key(c->value.first,code) != nullptr)
+        link = &c->next;
+      else {
+        *link = c->next;
+        c->hash_code = code;
+        link_node(c);
+        ++moved;
+      }
+    }
+
+  if (moved > 0) {
+    ++mod_count;
+    ++other.mod_count;
+    other.used -= moved;
+    if (other.bloom != nullptr)
+      other.rebuild_bloom();
+    other.ensure_load_threshold_low(other.used);
+  }
+  return moved;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 T& HashMap<KEY,T,thash>::operator [] (const KEY& key) {
-  LN* c = find_key(key);
+  int code = call_hash(key);
+  LN* c = find_key(key,code);
   if (c != nullptr)
     return c->value.second;
 
+  rehash_some(rehash_step);
   ensure_load_threshold(used+1);
   ++used;
   ++mod_count;
-  int bin = hash_compress(key);                //bins may have changed in ensure_load_threshold!
+  LN*& bin = home_bin(code);              //bins may have changed in ensure_load_threshold!
 
-  map[bin] = new LN(Entry(key,T()),map[bin]);  //easy to put at front: bin LNs unordered
-  return map[bin]->value.second;
+  bin = new LN(Entry(key,T()),code,bin);  //easy to put at front: bin LNs unordered
+  bloom_insert(code);
+  return bin->value.second;
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 const T& HashMap<KEY,T,thash>::operator [] (const KEY& key) const {
-  LN* c = find_key(key);
+  LN* c = find_key(key,call_hash(key));
   if (c != nullptr)
     return c->value.second;
 
@@ -410,18 +914,49 @@ HashMap<KEY,T,thash>& HashMap<KEY,T,thash>::operator = (const HashMap<KEY,T,thas
   if (this == &rhs)
     return *this;
 
-  if (hash == rhs.hash && (double)rhs.size()/rhs.bins <= load_threshold) {
+  if (hash == rhs.hash && rhs.old_map == nullptr && (double)rhs.size()/rhs.bins <= load_threshold) {
     delete_hash_table(map,bins);
+    delete_hash_table(old_map,old_bins);
+    old_bins = 0;
+    migrated = 0;
     map  = copy_hash_table(rhs.map,rhs.bins);
     bins = rhs.bins;
     used = rhs.used;
   }else{
     clear();
-    for (int b=0; b<rhs.bins; ++b)
-      for (LN* c = rhs.map[b]; c->next!=nullptr; c=c->next)
-        put(c->value.first,c->value.second);
+    if (hash == rhs.hash)
+      copy_nodes(rhs);
+    else
+      for (size_type b=0; b<rhs.all_bins(); ++b)
+        for (LN* c = rhs.bin_list(b); c->next!=nullptr; c=c->next)
+          put(c->value.first,c->value.second);
   }
+
+  if (bloom != nullptr)
+    rebuild_bloom();
+  ++mod_count;
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+HashMap<KEY,T,thash>& HashMap<KEY,T,thash>::operator = (HashMap<KEY,T,thash>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(hash,          rhs.hash);
+  std::swap(load_threshold,rhs.load_threshold);
+  std::swap(map,           rhs.map);
+  std::swap(bins,          rhs.bins);
+  std::swap(used,          rhs.used);
+  std::swap(reserved_bins, rhs.reserved_bins);
+  std::swap(old_map,       rhs.old_map);
+  std::swap(old_bins,      rhs.old_bins);
+  std::swap(migrated,      rhs.migrated);
+  std::swap(rehash_step,   rhs.rehash_step);
+  std::swap(bloom,         rhs.bloom);
   ++mod_count;
+  ++rhs.mod_count;
   return *this;
 }
 
@@ -433,10 +968,10 @@ bool HashMap<KEY,T,thash>::operator == (const HashMap<KEY,T,thash>& rhs) const {
   if (used != rhs.size())
     return false;
 
-  for (int b=0; b<bins; ++b)
-    for (LN* c=map[b]; c->next!=nullptr; c=c->next) {
+  for (size_type b=0; b<all_bins(); ++b)
+    for (LN* c=bin_list(b); c->next!=nullptr; c=c->next) {
       // Uses ! and ==, so != on T need not be defined
-      LN* rhs_pair = rhs.find_key(c->value.first);
+      LN* rhs_pair = rhs.find_key(c->value.first,rhs.call_hash(c->value.first));
       if (rhs_pair == nullptr || !(c->value.second == rhs_pair->value.second))
         return false;
       //More efficient than
@@ -458,9 +993,9 @@ template<class KEY,class T, int (*thash)(const KEY& a)>
 std::ostream& operator << (std::ostream& outs, const HashMap<KEY,T,thash>& m) {
   outs << "map[";
 
-  int printed = 0;
-  for (int b=0; b<m.bins; ++b)
-    for (typename HashMap<KEY,T,thash>::LN* c = m.map[b]; c->next!=nullptr; c = c->next)
+  size_type printed = 0;
+  for (size_type b=0; b<m.all_bins(); ++b)
+    for (typename HashMap<KEY,T,thash>::LN* c = m.bin_list(b); c->next!=nullptr; c = c->next)
       outs << (printed++ == 0? "" : ",") << c->value.first << "->" << c->value.second;
 
   outs << "]";
@@ -489,84 +1024,277 @@ auto HashMap<KEY,T,thash>::end () const -> HashMap<KEY,T,thash>::Iterator {
 //Private helper methods
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
-int HashMap<KEY,T,thash>::hash_compress (const KEY& key) const {
-  return abs(hash(key)) % bins;
+int HashMap<KEY,T,thash>::call_hash (const KEY& key) const {
+  return thash != (hashfunc)undefinedhash<KEY> ? thash(key) : hash(key);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type HashMap<KEY,T,thash>::compress (int hash_code) const {
+  //Multiply-shift (Fibonacci hashing): the high 32 bits of hash_code * 2^64/phi depend
+  //  on all of hash_code's bits, so a mask (no divide) spreads even similar codes
+  //hash_code has only 32 bits, so mixed does too: at most 2^32 bins are ever used
+  //  (see hash_fold in ics_hash.hpp for what that means past 2^32 keys)
+  std::uint64_t mixed = (std::uint64_t(std::uint32_t(hash_code)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  return size_type(mixed & std::uint64_t(bins-1));
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type HashMap<KEY,T,thash>::power_of_2_bins (size_type at_least) {
+  size_type answer = 1;
+  while (answer < at_least)
+    answer *= 2;
+  return answer;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type HashMap<KEY,T,thash>::bins_for (size_type n) const {
+  return power_of_2_bins(size_type(std::ceil(n/load_threshold)));
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
-typename HashMap<KEY,T,thash>::LN* HashMap<KEY,T,thash>::find_key (const KEY& key) const {
-  int bin = hash_compress(key);
-  for (LN* c = map[bin]; c->next!=nullptr; c=c->next)
-    if (key == c->value.first)
+template <class LOOKUP>
+typename HashMap<KEY,T,thash>::LN* HashMap<KEY,T,thash>::find_key (const LOOKUP& key, int hash_code) const {
+  if (bloom != nullptr && !bloom->may_contain(hash_code)) {
+    probes.miss(0);
+    return nullptr;
+  }
+
+  int probed = 0;
+  for (LN* c = home_bin(hash_code); c->next!=nullptr; c=c->next) {
+    ++probed;
+    if (hash_code == c->hash_code && key == c->value.first) { //cheap int test first
+      probes.hit(probed);
       return c;
+    }
+  }
 
+  probes.miss(probed);
+  if (bloom != nullptr)
+    bloom->note_false_positive();
   return nullptr;
 }
 
 
+//A key whose old_map bin has not yet been moved is still there (and new keys
+//  with that hash code are put there too), so every key is in exactly one bin
+template<class KEY,class T, int (*thash)(const KEY& a)>
+typename HashMap<KEY,T,thash>::LN*& HashMap<KEY,T,thash>::home_bin (int hash_code) const {
+  if (old_map != nullptr) {
+    size_type old_bin = compress(hash_code) & (old_bins-1);   //Same low bits: bins == 2*old_bins
+    if (old_bin >= migrated)
+      return old_map[old_bin];
+  }
+  return map[compress(hash_code)];
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+size_type HashMap<KEY,T,thash>::all_bins () const {
+  return bins + old_bins;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+typename HashMap<KEY,T,thash>::LN* HashMap<KEY,T,thash>::bin_list (size_type b) const {
+  static LN no_trailer_yet;     //Empty list standing in for bins without a trailer (see rehash_some)
+  LN* l = b < bins ? map[b] : old_map[b-bins];
+  return l != nullptr ? l : &no_trailer_yet;
+}
+
+
 template<class KEY,class T, int (*thash)(const KEY& a)>
 typename HashMap<KEY,T,thash>::LN* HashMap<KEY,T,thash>::copy_list (LN* l) const {
   //  //Recursive
   //  if (l == nullptr)
   //    return nullptr;
   //  else
-  //    return new LN(l->value, copy_list(l->next));
+  //    return new LN(l->value, l->hash_code, copy_list(l->next));
 
   //Iterative: order in bin makes no difference, but Trailer must be at end
   if (l->next == nullptr)
     return new LN();
 
-   LN* answer = new LN(l->value, new LN());
+   LN* answer = new LN(l->value, l->hash_code, new LN());
    for (LN* c = l->next; c->next != nullptr; c = c->next)
-     answer = new LN(c->value,answer);
+     answer = new LN(c->value,c->hash_code,answer);
 
   return answer;
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
-typename HashMap<KEY,T,thash>::LN** HashMap<KEY,T,thash>::copy_hash_table (LN** ht, int bins) const {
+typename HashMap<KEY,T,thash>::LN** HashMap<KEY,T,thash>::copy_hash_table (LN** ht, size_type bins) const {
   LN** answer = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
      answer[b] = copy_list(ht[b]);
   return answer;
 }
 
 
+//For copying into an empty map from one with a different load_threshold or one
+//  growing incrementally: the table is sized once and no keys are hashed or compared
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::copy_nodes (const HashMap<KEY,T,thash>& from) {
+  grow_for(used+from.used);
+  for (size_type b=0; b<from.all_bins(); ++b)
+    for (LN* c = from.bin_list(b); c->next!=nullptr; c=c->next) {
+      LN*& bin = home_bin(c->hash_code);
+      bin = new LN(c->value,c->hash_code,bin);
+    }
+  used += from.used;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+typename HashMap<KEY,T,thash>::LN* HashMap<KEY,T,thash>::unlink_key (const KEY& key, int hash_code) {
+  if (bloom != nullptr && !bloom->may_contain(hash_code)) {
+    probes.miss(0);
+    return nullptr;
+  }
+
+  int probed = 0;
+  for (LN** link = &home_bin(hash_code); (*link)->next!=nullptr; link = &(*link)->next) {
+    ++probed;
+    LN* c = *link;
+    if (hash_code == c->hash_code && key == c->value.first) {
+      probes.hit(probed);
+      *link   = c->next;
+      c->next = nullptr;
+      return c;
+    }
+  }
+
+  probes.miss(probed);
+  return nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::link_node (LN* node) {
+  ensure_load_threshold(++used);
+  LN*& bin = home_bin(node->hash_code);
+  node->next = bin;
+  bin        = node;
+  bloom_insert(node->hash_code);
+}
+
+
 template<class KEY,class T, int (*thash)(const KEY& a)>
-void HashMap<KEY,T,thash>::ensure_load_threshold(int new_used) {
+void HashMap<KEY,T,thash>::ensure_load_threshold(size_type new_used) {
   if (double(new_used)/double(bins) <= load_threshold)
     return;
 
-  LN** old_map  = map;
-  int  old_bins = bins;
+  rehash_some(old_bins);  //Finish moving bins from any earlier growth
+
+  ++rehashes;
+  old_map  = map;
+  old_bins = bins;
+  migrated = 0;
 
   bins = 2*old_bins;
-  map = new LN*[bins];
+  map = new LN*[bins](); //trailers allocated in rehash_some: allocating them all here takes as long as moving
+
+  rehash_some(rehash_step == 0 ? old_bins : rehash_step);
+}
+
+
+//Bulk operations (put_all, build_parallel, copies, merge) size the table with this, not with
+//  reserve, so the bins they need do not stop later erases from shrinking it
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::grow_for(size_type n) {
+  if (bins_for(n) > bins)
+    rehash(bins_for(n));
+}
+
+
+//Shrinking to half of load_threshold (not to load_threshold/4) leaves room to
+//  grow back by 2x before growing again, so alternating put/erase near a
+//  boundary never rehashes on each call.
+//Never shrinks below reserved_bins. While an incremental growth is in progress,
+//  wait for it to finish; in incremental mode (rehash_step > 0) never shrink
+//  here: rehash moves every key at once, the pause that mode exists to avoid
+//  (shrink_to_fit still shrinks).
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::ensure_load_threshold_low(size_type new_used) {
+  if (bins <= reserved_bins || rehash_step > 0 || old_map != nullptr || double(new_used)/double(bins) >= load_threshold/4)
+    return;
 
-  for (int b=0; b<bins; ++b)
-    map[b] = new LN();  //allocate trailers in new maps
+  rehash(std::max(bins_for(2*new_used),reserved_bins));
+}
+
+
+//Each put/erase moves only a few bins (and deletes their trailers), bounding its cost.
+//Doubling splits old bin b's keys between map[b] and map[b+old_bins]: no
+//  key can go into either of those until old bin b is moved
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::rehash_some(size_type old_bins_to_move) {
+  if (old_map == nullptr)
+    return;
 
-  for (int b=0; b<old_bins; ++b) {
-    LN* c = old_map[b];
+  for (; old_bins_to_move > 0 && migrated < old_bins; --old_bins_to_move, ++migrated) {
+    map[migrated]          = new LN();
+    map[migrated+old_bins] = new LN();
+    LN* c = old_map[migrated];
     for (; c->next!=nullptr; /*See body*/) {
-      int bin = hash_compress(c->value.first);
+      size_type bin = compress(c->hash_code);  //no need to call hash again
       LN* to_move = c;
       c = c->next;
       to_move->next = map[bin];
       map[bin] = to_move;
     }
-    delete c;           //deallocate trailers in old_map
+    delete c;           //deallocate trailer in old_map
+    old_map[migrated] = nullptr;
+  }
+
+  if (migrated == old_bins) {
+    delete_hash_table(old_map,old_bins);  //all bins are nullptr: just deallocates the array
+    old_bins = 0;
+    migrated = 0;
   }
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::bloom_insert(int hash_code) {
+  if (bloom == nullptr)
+    return;
+
+  if (bloom->full())
+    rebuild_bloom();            //the new key's node is already linked
+  else
+    bloom->insert(hash_code);
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::bloom_erase() {
+  if (bloom == nullptr)
+    return;
 
-  delete [] old_map;
+  bloom->note_erase();
+  if (bloom->stale())
+    rebuild_bloom();
+}
+
+
+//Moves no nodes, so it is safe while an Iterator is erasing (or bins are
+//  moving from old_map); like a full rehash, it takes time proportional to size()
+template<class KEY,class T, int (*thash)(const KEY& a)>
+void HashMap<KEY,T,thash>::rebuild_bloom() {
+  bloom->reset(2*used);
+  for (size_type b=0; b<all_bins(); ++b)
+    for (LN* c=bin_list(b); c->next!=nullptr; c=c->next)
+      bloom->insert(c->hash_code);
 }
 
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
-void HashMap<KEY,T,thash>::delete_hash_table (LN**& ht, int bins) {
-  for (int b=0; b<bins; ++b)
+void HashMap<KEY,T,thash>::delete_hash_table (LN**& ht, size_type bins) {
+  for (size_type b=0; b<bins; ++b)
     for (LN* c=ht[b]; c!=nullptr; /*See body*/) {
       LN* to_delete = c;
       c = c->next;
@@ -591,10 +1319,10 @@ void HashMap<KEY,T,thash>::Iterator::advance_cursors(){
     current.second = current.second->next;
     return;
   }else
-    for (int b=current.first+1; b<ref_map->bins; ++b)
-      if (ref_map->map[b]->next != nullptr) {
+    for (size_type b=current.first+1; b<ref_map->all_bins(); ++b)
+      if (ref_map->bin_list(b)->next != nullptr) {
         current.first  = b;
-        current.second = ref_map->map[b];
+        current.second = ref_map->bin_list(b);
         return;
       }
 
@@ -628,12 +1356,13 @@ auto HashMap<KEY,T,thash>::Iterator::erase() -> Entry {
     throw CannotEraseError("HashMap::Iterator::erase Iterator cursor beyond data structure");
 
   can_erase = false;
-  Entry to_return = current.second->value;
+  Entry to_return = std::move(current.second->value);
   LN* to_delete = current.second->next;
-  *current.second = *(current.second->next);
+  *current.second = std::move(*(current.second->next));
 
   --ref_map->used;
   ++ref_map->mod_count;
+  ref_map->bloom_erase();
   expected_mod_count = ref_map->mod_count;
   delete to_delete;
 
@@ -733,6 +1462,62 @@ pair<KEY,T>* HashMap<KEY,T,thash>::Iterator::operator ->() const {
 }
 
 
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Node class definitions
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+HashMap<KEY,T,thash>::Node::Node(LN* n, hashfunc h)
+: node(n), hash(h)
+{}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+HashMap<KEY,T,thash>::Node::Node(Node&& to_move)
+: node(to_move.node), hash(to_move.hash) {
+  to_move.node = nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+HashMap<KEY,T,thash>::Node::~Node() {
+  delete node;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+auto HashMap<KEY,T,thash>::Node::operator = (Node&& rhs) -> Node& {
+  std::swap(node,rhs.node);
+  std::swap(hash,rhs.hash);
+  return *this;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+bool HashMap<KEY,T,thash>::Node::empty() const {
+  return node == nullptr;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const KEY& HashMap<KEY,T,thash>::Node::key() const {
+  if (node == nullptr)
+    throw EmptyError("HashMap::Node::key: empty Node");
+  return node->value.first;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T& HashMap<KEY,T,thash>::Node::value() const {
+  if (node == nullptr)
+    throw EmptyError("HashMap::Node::value: empty Node");
+  return node->value.second;
+}
+
+
 }
 
 #endif /* HASH_MAP_HPP_ */
@@ -4,9 +4,21 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <initializer_list>
+#include <utility>
+#include <vector>
+#include <thread>
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
+#include "node_pool.hpp"
+#include "size_hint.hpp"
+#include "bloom_filter.hpp"
+#include "hash_stats.hpp"
+#include "prefetch.hpp"
+#include "parallel.hpp"
 
 
 namespace ics {
@@ -33,6 +45,7 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
     HashSet (double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
     explicit HashSet (int initial_bins, double the_load_threshold = 1.0, int (*chash)(const T& k) = undefinedhash<T>);
     HashSet (const HashSet<T,thash>& to_copy, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
+    HashSet (HashSet<T,thash>&& to_move);  //Same hash/load_threshold as to_move; to_move is left empty
     explicit HashSet (const std::initializer_list<T>& il, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -41,10 +54,21 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
 
 
     //Queries
-    bool empty      () const;
-    int  size       () const;
-    bool contains   (const T& element) const;
+    bool      empty      () const;
+    size_type size       () const;
+    bool      contains   (const T& element) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
+    HashStats   stats () const; //Chain lengths, rehashes, and probes per search (see hash_stats.hpp): for big tables
+
+    //Heterogeneous lookup: element is a LOOKUP (e.g., StringView for std::string elements), so no T
+    //  is built; LOOKUP == T must be defined and lookup_hash(element) must equal hash(T(element))
+    template <class LOOKUP>
+    bool contains   (const LOOKUP& element, int (*lookup_hash)(const LOOKUP& e)) const;
+
+    //Batched membership test of elements[0..n-1]: each batch is hashed and its bins prefetched
+    //  before any is searched (see prefetch.hpp), so for many elements it beats contains in a loop.
+    //  found[i] is contains(elements[i]); returns the # of elements found
+    size_type contains_many (const T elements[], size_type n, bool found[]) const;
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
@@ -52,24 +76,64 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
 
 
     //Commands
-    int  insert (const T& element);
-    int  erase  (const T& element);
-    void clear  ();
+    int       insert (const T& element);
+    int       insert (T&& element);
+    int       erase  (const T& element);
+    void      clear  ();
+    void      reserve(size_type n);   //Grow now, so inserting up to n elements never rehashes (and erase never shrinks the table below that)
+    void      rehash (size_type n);   //Use >= n bins (fewer if possible, but enough for size() elements)
+    void      shrink_to_fit ();  //Fewest bins holding size() elements (erase/clear shrink only below load_threshold/4; undoes reserve)
+    void      clear_stats ();    //Restart counting the rehashes and probes reported by stats()
+
+    //A BloomFilter (off by default) rejects most absent elements before any bin is searched:
+    //  turn it on when most contains/insert calls are for absent elements
+    void use_bloom_filter (bool on = true);
+    const BloomFilter* bloom_filter () const;   //nullptr when off; has the false_positive_rate
+
+    //Insert T(args...)
+    template <class... Args>
+    int  emplace (Args&&... args);
 
     //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
 
     template <class Iterable>
-    int insert_all(const Iterable& i);
+    size_type insert_all(const Iterable& i);
+
+    //Inserts each element in [begin,end) like insert_all does, but on threads threads (0 means
+    //  hardware_concurrency; fewer for few elements): elements are hashed in parallel and grouped
+    //  by the range of bins each thread owns, then each thread links the nodes into its own bins,
+    //  with no locking. hash, T's ==, and T's copy constructor are called on several threads at once.
+    //  Returns the # of elements inserted
+    template <class Iter>
+    size_type build_parallel(Iter begin, Iter end, int threads = 0);
 
     template <class Iterable>
-    int erase_all(const Iterable& i);
+    size_type erase_all(const Iterable& i);
 
     template<class Iterable>
-    int retain_all(const Iterable& i);
+    size_type retain_all(const Iterable& i);
+    size_type retain_all(const HashSet<T,thash>& s);   //Looks up in s directly: builds no copy of it
+
+    //Set algebra: iterates the smaller operand when the result allows it (and both use the same
+    //  hash), sizes the result once, reuses the hash codes cached in the nodes, and copies no operand
+    HashSet<T,thash>  operator |  (const HashSet<T,thash>& rhs) const;   //union
+    HashSet<T,thash>  operator &  (const HashSet<T,thash>& rhs) const;   //intersection
+    HashSet<T,thash>  operator -  (const HashSet<T,thash>& rhs) const;   //difference
+    HashSet<T,thash>  operator ^  (const HashSet<T,thash>& rhs) const;   //symmetric difference
+    HashSet<T,thash>& operator |= (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator &= (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator -= (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator ^= (const HashSet<T,thash>& rhs);
+
+    //The same as & and -, but each of threads (0 means hardware_concurrency) threads fills a
+    //  disjoint range of the result's bins; fewer threads are used for small sets
+    HashSet<T,thash> parallel_intersection (const HashSet<T,thash>& rhs, int threads = 0) const;
+    HashSet<T,thash> parallel_difference   (const HashSet<T,thash>& rhs, int threads = 0) const;
 
 
     //Operators
     HashSet<T,thash>& operator = (const HashSet<T,thash>& rhs);
+    HashSet<T,thash>& operator = (HashSet<T,thash>&& rhs);   //Swaps contents (and hash) with rhs
     bool operator == (const HashSet<T,thash>& rhs) const;
     bool operator != (const HashSet<T,thash>& rhs) const;
     bool operator <= (const HashSet<T,thash>& rhs) const;
@@ -88,7 +152,7 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
   public:
     class Iterator {
       public:
-        typedef pair<int,LN*> Cursor;
+        typedef pair<size_type,LN*> Cursor;
 
         //Private constructor called in begin/end, which are friends of HashSet<T,thash>
         ~Iterator();
@@ -111,7 +175,7 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
         Cursor              current; //Bin Index and Cursor; stop: LN* == nullptr
         HashSet<T,thash>*   ref_set;
-        int                 expected_mod_count;
+        size_type           expected_mod_count;
         bool                can_erase = true;
 
         //Helper methods
@@ -127,13 +191,15 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
 
 
   private:
-    class LN {
+    class LN : public PoolAllocated {
       public:
-        LN ()                      {}
-        LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+        LN ()                             {}
+        LN (const LN& ln)                 : value(ln.value), hash_code(ln.hash_code), next(ln.next){}
+        LN (T v, int h, LN* n = nullptr)  : value(std::move(v)), hash_code(h), next(n){}
+        LN& operator = (LN&& ln) = default;
 
         T   value;
+        int hash_code = 0;  //hash(value): compared before values; reused when rehashing
         LN* next   = nullptr;
     };
 
@@ -142,19 +208,42 @@ public:
 private:
   LN** set      = nullptr;   //Pointer to array of pointers: each bin stores a list with a trailer node
   double load_threshold;     //used/bins <= load_threshold
-  int bins      = 1;         //# bins in array (should start at 1 so hash_compress doesn't % 0)
-  int used      = 0;         //Cache for number of key->value pairs in the hash table
-  int mod_count = 0;         //For sensing concurrent modification
+  size_type bins      = 1;   //# bins in array (should start at 1 so compress doesn't % 0)
+  size_type used      = 0;   //Cache for number of key->value pairs in the hash table
+  size_type mod_count = 0;   //For sensing concurrent modification
+  size_type reserved_bins = 1;  //reserve()'s bins: erase never shrinks below them; shrink_to_fit/clear reset it
+  BloomFilter* bloom = nullptr;  //If not nullptr: has the hash_code of every element (and maybe erased ones)
+  size_type rehashes  = 0;   //For stats(): # times elements were moved to a table with a different # of bins
+  ProbeCounter probes;       //For stats(): searches and the elements they compared
 
+  static const size_type parallel_grain = 4096;   //Fewest elements worth starting another thread for
 
   //Helper methods
-  int   hash_compress        (const T& key)              const;  //hash function ranged to [0,bins-1]
-  LN*   find_element         (const T& element)          const;  //Returns reference to element's node or nullptr
-  LN*   copy_list            (LN*   l)                   const;  //Copy the elements in a bin (order irrelevant)
-  LN**  copy_hash_table      (LN** ht, int bins)         const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
-
-  void  ensure_load_threshold(int new_used);                     //Reallocate if load_threshold > load_threshold
-  void  delete_hash_table    (LN**& ht, int bins);               //Deallocate all LN in ht (and the ht itself; ht == nullptr)
+  int       call_hash            (const T& element)          const;  //thash(element) if given (a direct call: inlinable), else hash(element)
+  size_type compress             (int hash_code)             const;  //hash code ranged to [0,bins-1] (bins is a power of 2)
+  static size_type power_of_2_bins (size_type at_least);             //Smallest power of 2 >= at_least (and >= 1)
+  size_type bins_for             (size_type n)               const;  //Fewest bins (a power of 2) holding n elements within load_threshold
+  template <class LOOKUP>
+  LN*       find_element         (const LOOKUP& element, int hash_code) const;  //Returns reference to element's node or nullptr
+  LN*       copy_list            (LN*   l)                   const;  //Copy the elements in a bin (order irrelevant)
+  LN**      copy_hash_table      (LN** ht, size_type bins)   const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
+  bool      contains_node        (const HashSet<T,thash>& from, const LN* n) const;  //n (a node of from) is in this set; no rehashing if same hash
+  bool      all_in               (const HashSet<T,thash>& s) const;  //Every element is in s
+  HashSet<T,thash> filter        (const HashSet<T,thash>& s, bool in_s, int threads) const;  //Elements whose s.contains is in_s (same bins)
+
+  int       insert_hashed        (const T& element, int hash_code);  //insert, with hash_code == hash(element)
+  int       erase_hashed         (const T& element, int hash_code);  //erase, with hash_code == hash(element); never shrinks
+  size_type erase_where          (const HashSet<T,thash>& s, bool in_s);  //Erase elements whose s.contains is in_s
+
+  void  bloom_insert         (int hash_code);                    //Record a new element in bloom (if any)
+  void  bloom_erase          (size_type count);                  //Record erased elements; rebuild bloom if stale
+  void  rebuild_bloom        ();                                 //Reset bloom for 2*used elements and insert all
+
+  void  ensure_load_threshold(size_type new_used);               //Reallocate if load_threshold > load_threshold
+  void  ensure_load_threshold_low(size_type new_used);           //Reallocate if load_factor < load_threshold/4
+  void  grow_for             (size_type n);                      //Grow now to hold n elements: reserve without raising reserved_bins
+  void  resize_table         (size_type new_bins);               //Move all elements into a new table with new_bins bins
+  void  delete_hash_table    (LN**& ht, size_type bins);         //Deallocate all LN in ht (and the ht itself; ht == nullptr)
 };
 
 
@@ -170,6 +259,7 @@ private:
 template<class T, int (*thash)(const T& a)>
 HashSet<T,thash>::~HashSet() {
   delete_hash_table(set,bins);
+  delete bloom;
 }
 
 
@@ -182,7 +272,7 @@ HashSet<T,thash>::HashSet(double the_load_threshold, int (*chash)(const T& eleme
     throw TemplateFunctionError("HashSet::default constructor: both specified and different");
 
   set = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     set[b] = new LN();
 }
 
@@ -195,10 +285,9 @@ HashSet<T,thash>::HashSet(int initial_bins, double the_load_threshold, int (*cha
   if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
     throw TemplateFunctionError("HashSet::length constructor: both specified and different");
 
-  if (bins < 1)
-    bins = 1;
+  bins = power_of_2_bins(bins);
   set = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     set[b] = new LN();
 }
 
@@ -215,28 +304,47 @@ HashSet<T,thash>::HashSet(const HashSet<T,thash>& to_copy, double the_load_thres
     used = to_copy.used;
     set  = copy_hash_table(to_copy.set,to_copy.bins);
   }else {
-    bins = std::max(1,int(to_copy.size()/load_threshold));
+    bins = power_of_2_bins(size_type(to_copy.size()/load_threshold));
     set = new LN*[bins];
-    for (int b=0; b<bins; ++b)
+    for (size_type b=0; b<bins; ++b)
       set[b] = new LN();         //Put a trailer node in bin
 
-    for (int b=0; b<to_copy.bins; ++b)
+    for (size_type b=0; b<to_copy.bins; ++b)
       for (LN* c = to_copy.set[b]; c->next!=nullptr; c=c->next)
         insert(c->value);
   }
+
+  if (to_copy.bloom != nullptr)
+    use_bloom_filter();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>::HashSet(HashSet<T,thash>&& to_move)
+: hash(to_move.hash), load_threshold(to_move.load_threshold) {
+  set = new LN*[bins];
+  for (size_type b=0; b<bins; ++b)
+    set[b] = new LN();         //Put a trailer node in bin (for to_move, after swapping)
+
+  std::swap(set, to_move.set);
+  std::swap(bins,to_move.bins);
+  std::swap(used,to_move.used);
+  std::swap(reserved_bins,to_move.reserved_bins);
+  std::swap(bloom,to_move.bloom);
+  ++to_move.mod_count;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 HashSet<T,thash>::HashSet(const std::initializer_list<T>& il, double the_load_threshold, int (*chash)(const T& element))
-: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold), bins(std::max(1,int(il.size()/the_load_threshold))) {
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold), bins(power_of_2_bins(size_type(il.size()/the_load_threshold))) {
   if (hash == (hashfunc)undefinedhash<T>)
     throw TemplateFunctionError("HashSet::initializer_list constructor: neither specified");
   if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
     throw TemplateFunctionError("HashSet::initializer_list constructor: both specified and different");
 
   set = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     set[b] = new LN();
 
   for (const T& v : il)
@@ -247,14 +355,14 @@ HashSet<T,thash>::HashSet(const std::initializer_list<T>& il, double the_load_th
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
 HashSet<T,thash>::HashSet(const Iterable& i, double the_load_threshold, int (*chash)(const T& a))
-: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold), bins(std::max(1,int(i.size()/the_load_threshold))) {
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold), bins(power_of_2_bins(size_type(i.size()/the_load_threshold))) {
   if (hash == (hashfunc)undefinedhash<T>)
     throw TemplateFunctionError("HashSet::Iterable constructor: neither specified");
   if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
     throw TemplateFunctionError("HashSet::Iterable constructor: both specified and different");
 
   set = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     set[b] = new LN();
 
   for (const T& v : i)
@@ -273,14 +381,21 @@ bool HashSet<T,thash>::empty() const {
 
 
 template<class T, int (*thash)(const T& a)>
-int HashSet<T,thash>::size() const {
+size_type HashSet<T,thash>::size() const {
   return used;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 bool HashSet<T,thash>::contains (const T& element) const {
-  return find_element(element) != nullptr;
+  return find_element(element,call_hash(element)) != nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template <class LOOKUP>
+bool HashSet<T,thash>::contains (const LOOKUP& element, int (*lookup_hash)(const LOOKUP& e)) const {
+  return find_element(element,lookup_hash(element)) != nullptr;
 }
 
 
@@ -290,7 +405,7 @@ std::string HashSet<T,thash>::str() const {
   answer << "HashSet[";
   if (bins != 0) {
     answer << std::endl;
-    for (int b=0; b<bins; ++b) {
+    for (size_type b=0; b<bins; ++b) {
       answer << "bin[" << b << "] = ";
       for (LN* c = set[b]; c->next!=nullptr; c=c->next)
         answer << c->value << " -> " ;
@@ -303,6 +418,48 @@ std::string HashSet<T,thash>::str() const {
 }
 
 
+template<class T, int (*thash)(const T& a)>
+HashStats HashSet<T,thash>::stats() const {
+  HashStats answer;
+  answer.bins        = bins;
+  answer.used        = used;
+  answer.load_factor = double(used)/double(bins);
+  for (size_type b=0; b<bins; ++b) {
+    size_type length = 0;
+    for (LN* c = set[b]; c->next!=nullptr; c=c->next)
+      ++length;
+    answer.add_chain(length);
+  }
+  answer.rehashes = rehashes;
+  probes.fill(answer);
+  return answer;
+}
+
+
+//Three passes over each batch: hash the elements and prefetch their bins' pointers;
+//  prefetch each bin's first node; then search, finding most of it in the cache
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::contains_many (const T elements[], size_type n, bool found[]) const {
+  size_type count = 0;
+  int codes[lookup_batch];
+  for (size_type i=0; i<n; i+=lookup_batch) {
+    size_type in_batch = std::min<size_type>(lookup_batch,n-i);
+    for (size_type j=0; j<in_batch; ++j) {
+      codes[j] = call_hash(elements[i+j]);
+      prefetch(&set[compress(codes[j])]);
+    }
+    for (size_type j=0; j<in_batch; ++j)
+      prefetch(set[compress(codes[j])]);
+    for (size_type j=0; j<in_batch; ++j) {
+      found[i+j] = find_element(elements[i+j],codes[j]) != nullptr;
+      if (found[i+j])
+        ++count;
+    }
+  }
+  return count;
+}
+
+
 template<class T, int (*thash)(const T& a)>
 template <class Iterable>
 bool HashSet<T,thash>::contains_all(const Iterable& i) const {
@@ -320,7 +477,14 @@ bool HashSet<T,thash>::contains_all(const Iterable& i) const {
 
 template<class T, int (*thash)(const T& a)>
 int HashSet<T,thash>::insert(const T& element) {
-  LN* c = find_element(element);
+  return insert_hashed(element,call_hash(element));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::insert(T&& element) {
+  int code = call_hash(element);
+  LN* c = find_element(element,code);
   if (c != nullptr)
       return 0;
 
@@ -328,30 +492,31 @@ int HashSet<T,thash>::insert(const T& element) {
 
   ++used;
   ++mod_count;
-  int bin = hash_compress(element);     //bins may have changed in ensure_load_threshold!
-  set[bin] = new LN(element,set[bin]);  //easy to put at front: bin LNs unordered
+  size_type bin = compress(code);
+  set[bin] = new LN(std::move(element),code,set[bin]);
+  bloom_insert(code);
   return 1;
 }
 
 
 template<class T, int (*thash)(const T& a)>
-int HashSet<T,thash>::erase(const T& element) {
-  LN* c = find_element(element);
-  if (c == nullptr)
-    return 0;
+template<class... Args>
+int HashSet<T,thash>::emplace(Args&&... args) {
+  return insert(T(std::forward<Args>(args)...));
+}
 
-  LN* to_delete = c->next;
-  *c = *(c->next);
-  delete to_delete;
-  --used;
-  ++mod_count;
-  return 1;
+
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::erase(const T& element) {
+  int answer = erase_hashed(element,call_hash(element));
+  ensure_load_threshold_low(used);
+  return answer;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 void HashSet<T,thash>::clear() {
-  for (int b=0; b<bins; ++b) {
+  for (size_type b=0; b<bins; ++b) {
     LN* l=set[b];
     for (; l->next!=nullptr; /*See body*/) {
       LN* to_delete = l;
@@ -363,13 +528,68 @@ void HashSet<T,thash>::clear() {
 
   used = 0;
   ++mod_count;
+  reserved_bins = 1;
+  rehash(0);              //Release all but 1 bin
+  if (bloom != nullptr)
+    bloom->reset(0);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::reserve(size_type n) {
+  reserved_bins = std::max(reserved_bins,bins_for(n));
+  grow_for(n);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::rehash(size_type n) {
+  size_type new_bins = power_of_2_bins(std::max(n,bins_for(used)));
+  ++mod_count;
+  if (new_bins != bins)
+    resize_table(new_bins);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::shrink_to_fit() {
+  reserved_bins = 1;
+  rehash(0);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::clear_stats() {
+  rehashes = 0;
+  probes.clear();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::use_bloom_filter(bool on) {
+  if (!on) {
+    delete bloom;
+    bloom = nullptr;
+    return;
+  }
+
+  if (bloom == nullptr)
+    bloom = new BloomFilter();
+  rebuild_bloom();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+const BloomFilter* HashSet<T,thash>::bloom_filter() const {
+  return bloom;
 }
 
 
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
-int HashSet<T,thash>::insert_all(const Iterable& i) {
-  int count = 0;
+size_type HashSet<T,thash>::insert_all(const Iterable& i) {
+  grow_for(used+size_hint(i));
+  size_type count = 0;
   for (const T& v : i)
     count += insert(v);
 
@@ -377,10 +597,62 @@ int HashSet<T,thash>::insert_all(const Iterable& i) {
 }
 
 
+//Each thread writes only its own bins (and allocates their nodes from its own
+//  NodePool free lists). Probes are not counted: when counting is on (see
+//  ICS_HASH_PROBE_STATS), a ProbeCounter is not thread-safe.
+template<class T, int (*thash)(const T& a)>
+template<class Iter>
+size_type HashSet<T,thash>::build_parallel(Iter begin, Iter end, int threads) {
+  std::vector<decltype(&*begin)> elements;
+  for (Iter i=begin; i!=end; ++i)
+    elements.push_back(&*i);
+  size_type n = elements.size();
+  grow_for(used+n);
+  ++mod_count;
+  threads = int(std::min<size_type>(threads_for(threads,n,parallel_grain),bins));
+
+  std::vector<int> codes(n);
+  on_threads(threads, [&] (int t) {
+    for (size_type i=chunk_begin(n,t,threads); i<chunk_begin(n,t+1,threads); ++i)
+      codes[i] = call_hash(*elements[i]);
+  });
+
+  size_type bins_per_thread = (bins+threads-1)/threads;
+  std::vector<size_type> order, start;
+  partition_parallel(n, threads, [&] (size_type i) {return int(compress(codes[i])/bins_per_thread);},
+                     threads, order, start);
+
+  std::vector<size_type> added(threads,0);
+  on_threads(threads, [&] (int t) {
+    size_type count = 0;
+    for (size_type k=start[t]; k<start[t+1]; ++k) {
+      size_type i = order[k];
+      LN*& bin = set[compress(codes[i])];
+      LN*  c   = bin;
+      while (c->next!=nullptr && !(codes[i] == c->hash_code && *elements[i] == c->value))
+        c = c->next;
+      if (c->next == nullptr) {
+        bin = new LN(*elements[i],codes[i],bin);
+        ++count;
+      }
+    }
+    added[t] = count;
+  });
+
+  size_type count = 0;
+  for (size_type a : added)
+    count += a;
+  used += count;
+  if (bloom != nullptr)
+    rebuild_bloom();
+  return count;
+}
+
+
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
-int HashSet<T,thash>::erase_all(const Iterable& i) {
-  int count = 0;
+size_type HashSet<T,thash>::erase_all(const Iterable& i) {
+  size_type count = 0;
   for (const T& v : i)
     count += erase(v);
   return count;
@@ -389,27 +661,193 @@ int HashSet<T,thash>::erase_all(const Iterable& i) {
 
 template<class T, int (*thash)(const T& a)>
 template<class Iterable>
-int HashSet<T,thash>::retain_all(const Iterable& i) {
-  HashSet<T,thash> s(i);
-
-  int count = 0;
-  for (int b=0; b<bins; ++b)
-    for (LN* c=set[b]; c->next!=nullptr; /*See body*/) {
-      if (s.contains(c->value))
-        c = c-> next;
-      else{
-        LN* to_delete = c->next;
-        *c = *(c->next);
-        delete to_delete;
-        ++count;
+size_type HashSet<T,thash>::retain_all(const Iterable& i) {
+  //Swap each element of i that is here into the kept[b]-node prefix of its bin b (no copy
+  //  of i is built), then cut every bin after its prefix
+  std::vector<size_type> kept(bins,0);
+  bool moved = false;
+  for (const T& v : i) {
+    int hash_code = call_hash(v);
+    if (bloom != nullptr && !bloom->may_contain(hash_code))
+      continue;
+    size_type b = compress(hash_code);
+    LN* front = set[b];
+    size_type position = 0;
+    for (LN* temp = set[b]; temp->next != nullptr; temp = temp->next, ++position) {
+      if (position == kept[b])
+        front = temp;
+      if (temp->hash_code == hash_code && temp->value == v) {
+        if (position >= kept[b]) {        //Not yet kept (i may repeat an element)
+          if (temp != front) {
+            std::swap(temp->value,front->value);
+            std::swap(temp->hash_code,front->hash_code);
+            moved = true;
+          }
+          ++kept[b];
+        }
+        break;
       }
     }
+  }
 
-  used -= count;
+  size_type count = 0;
+  for (size_type b = 0; b < bins; ++b) {
+    LN** link = &set[b];
+    for (size_type j = 0; j < kept[b]; ++j)
+      link = &(*link)->next;
+    while ((*link)->next != nullptr) {   //Not the trailer
+      LN* to_delete = *link;
+      *link = to_delete->next;
+      delete to_delete;
+      ++count;
+    }
+  }
+
+  if (count > 0 || moved)
+    ++mod_count;
+  if (count > 0) {
+    used -= count;
+    bloom_erase(count);
+    ensure_load_threshold_low(used);
+  }
   return count;
 }
 
 
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::retain_all(const HashSet<T,thash>& s) {
+  if (this == &s)
+    return 0;
+
+  return erase_where(s,false);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator | (const HashSet<T,thash>& rhs) const {
+  HashSet<T,thash> answer(load_threshold,hash);
+  answer.grow_for(used+rhs.used);
+  answer |= *this;
+  answer |= rhs;
+  return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator & (const HashSet<T,thash>& rhs) const {
+  if (hash == rhs.hash && rhs.used < used)
+    return rhs.filter(*this,true,1);
+  return filter(rhs,true,1);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator - (const HashSet<T,thash>& rhs) const {
+  return filter(rhs,false,1);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::operator ^ (const HashSet<T,thash>& rhs) const {
+  HashSet<T,thash> answer(load_threshold,hash);
+  answer.grow_for(used+rhs.used);
+  for (size_type b=0; b<bins; ++b)
+    for (LN* c=set[b]; c->next!=nullptr; c=c->next)
+      if (!rhs.contains_node(*this,c))
+        answer.insert_hashed(c->value,c->hash_code);
+
+  for (size_type b=0; b<rhs.bins; ++b)
+    for (LN* c=rhs.set[b]; c->next!=nullptr; c=c->next)
+      if (!contains_node(rhs,c))
+        answer.insert_hashed(c->value, hash == rhs.hash ? c->hash_code : call_hash(c->value));
+
+  answer.ensure_load_threshold_low(answer.used);
+  return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator |= (const HashSet<T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  grow_for(used+rhs.used);
+  for (size_type b=0; b<rhs.bins; ++b)
+    for (LN* c=rhs.set[b]; c->next!=nullptr; c=c->next)
+      insert_hashed(c->value, hash == rhs.hash ? c->hash_code : call_hash(c->value));
+  return *this;
+}
+
+
+//Keeping the few elements of a smaller rhs builds a table sized for them,
+//  instead of erasing nearly all of this set's elements one at a time
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator &= (const HashSet<T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  if (hash == rhs.hash && load_threshold == rhs.load_threshold && rhs.used < used/2) {
+    bool had_bloom = bloom != nullptr;
+    *this = rhs.filter(*this,true,1);
+    use_bloom_filter(had_bloom);
+  }else
+    erase_where(rhs,false);
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator -= (const HashSet<T,thash>& rhs) {
+  if (this == &rhs) {
+    clear();
+    return *this;
+  }
+
+  if (rhs.used >= used) {
+    erase_where(rhs,true);
+    return *this;
+  }
+  for (size_type b=0; b<rhs.bins; ++b)
+    for (LN* c=rhs.set[b]; c->next!=nullptr; c=c->next)
+      erase_hashed(c->value, hash == rhs.hash ? c->hash_code : call_hash(c->value));
+  ensure_load_threshold_low(used);
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator ^= (const HashSet<T,thash>& rhs) {
+  if (this == &rhs) {
+    clear();
+    return *this;
+  }
+
+  grow_for(used+rhs.used);
+  for (size_type b=0; b<rhs.bins; ++b)
+    for (LN* c=rhs.set[b]; c->next!=nullptr; c=c->next) {
+      int code = hash == rhs.hash ? c->hash_code : call_hash(c->value);
+      if (erase_hashed(c->value,code) == 0)
+        insert_hashed(c->value,code);
+    }
+  ensure_load_threshold_low(used);
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::parallel_intersection(const HashSet<T,thash>& rhs, int threads) const {
+  if (hash == rhs.hash && rhs.used < used)
+    return rhs.filter(*this,true,threads);
+  return filter(rhs,true,threads);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::parallel_difference(const HashSet<T,thash>& rhs, int threads) const {
+  return filter(rhs,false,threads);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
@@ -426,12 +864,32 @@ HashSet<T,thash>& HashSet<T,thash>::operator = (const HashSet<T,thash>& rhs) {
     used = rhs.used;
   }else{
     clear();
-    for (int b=0; b<rhs.bins; ++b)
+    for (size_type b=0; b<rhs.bins; ++b)
       for (LN* c = rhs.set[b]; c->next!=nullptr; c=c->next)
         insert(c->value);
   }
 
+  if (bloom != nullptr)
+    rebuild_bloom();
+  ++mod_count;
+  return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash>& HashSet<T,thash>::operator = (HashSet<T,thash>&& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  std::swap(hash,          rhs.hash);
+  std::swap(load_threshold,rhs.load_threshold);
+  std::swap(set,           rhs.set);
+  std::swap(bins,          rhs.bins);
+  std::swap(used,          rhs.used);
+  std::swap(reserved_bins, rhs.reserved_bins);
+  std::swap(bloom,         rhs.bloom);
   ++mod_count;
+  ++rhs.mod_count;
   return *this;
 }
 
@@ -443,12 +901,7 @@ bool HashSet<T,thash>::operator == (const HashSet<T,thash>& rhs) const {
   if (used != rhs.size())
     return false;
 
-  for (int b=0; b<bins; ++b)
-    for (LN* c=set[b]; c->next!=nullptr; c=c->next)
-       if (!rhs.contains(c->value))
-         return false;
-
-  return true;
+  return all_in(rhs);
 }
 
 
@@ -465,12 +918,7 @@ bool HashSet<T,thash>::operator <= (const HashSet<T,thash>& rhs) const {
   if (used > rhs.size())
     return false;
 
-  for (int b=0; b<bins; ++b)
-    for (LN* c=set[b]; c->next!=nullptr; c=c->next)
-      if (!rhs.contains(c->value))
-        return false;
-
-  return true;
+  return all_in(rhs);
 }
 
 template<class T, int (*thash)(const T& a)>
@@ -480,12 +928,7 @@ bool HashSet<T,thash>::operator < (const HashSet<T,thash>& rhs) const {
   if (used >= rhs.size())
     return false;
 
-  for (int b=0; b<bins; ++b)
-    for (LN* c=set[b]; c->next!=nullptr; c=c->next)
-      if (!rhs.contains(c->value))
-        return false;
-
-  return true;
+  return all_in(rhs);
 }
 
 
@@ -505,8 +948,8 @@ template<class T, int (*thash)(const T& a)>
 std::ostream& operator << (std::ostream& outs, const HashSet<T,thash>& s) {
   outs  << "set[";
 
-  int printed = 0;
-  for (int b=0; b<s.bins; ++b)
+  size_type printed = 0;
+  for (size_type b=0; b<s.bins; ++b)
     for (typename HashSet<T,thash>::LN* c = s.set[b]; c->next != nullptr; c = c->next)
       outs << (printed++ == 0? "" : ",") << c->value;
 
@@ -536,18 +979,58 @@ auto HashSet<T,thash>::end () const -> HashSet<T,thash>::Iterator {
 //Private helper methods
 
 template<class T, int (*thash)(const T& a)>
-int HashSet<T,thash>::hash_compress (const T& element) const {
-  return abs(hash(element)) % bins;
+int HashSet<T,thash>::call_hash (const T& element) const {
+  return thash != (hashfunc)undefinedhash<T> ? thash(element) : hash(element);
 }
 
 
 template<class T, int (*thash)(const T& a)>
-typename HashSet<T,thash>::LN* HashSet<T,thash>::find_element (const T& element) const {
-  int bin = hash_compress(element);
-  for (LN* c = set[bin]; c->next!=nullptr; c=c->next)
-    if (element == c->value)
+size_type HashSet<T,thash>::compress (int hash_code) const {
+  //Multiply-shift (Fibonacci hashing): the high 32 bits of hash_code * 2^64/phi depend
+  //  on all of hash_code's bits, so a mask (no divide) spreads even similar codes
+  //hash_code has only 32 bits, so mixed does too: at most 2^32 bins are ever used
+  //  (see hash_fold in ics_hash.hpp for what that means past 2^32 keys)
+  std::uint64_t mixed = (std::uint64_t(std::uint32_t(hash_code)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+  return size_type(mixed & std::uint64_t(bins-1));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::power_of_2_bins (size_type at_least) {
+  size_type answer = 1;
+  while (answer < at_least)
+    answer *= 2;
+  return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::bins_for (size_type n) const {
+  return power_of_2_bins(size_type(std::ceil(n/load_threshold)));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template <class LOOKUP>
+typename HashSet<T,thash>::LN* HashSet<T,thash>::find_element (const LOOKUP& element, int hash_code) const {
+  if (bloom != nullptr && !bloom->may_contain(hash_code)) {
+    probes.miss(0);
+    return nullptr;
+  }
+
+  size_type bin = compress(hash_code);
+  int probed = 0;
+  for (LN* c = set[bin]; c->next!=nullptr; c=c->next) {
+    ++probed;
+    if (hash_code == c->hash_code && element == c->value) { //cheap int test first
+      probes.hit(probed);
       return c;
+    }
+  }
 
+  probes.miss(probed);
+  if (bloom != nullptr)
+    bloom->note_false_positive();
   return nullptr;
 }
 
@@ -557,47 +1040,189 @@ typename HashSet<T,thash>::LN* HashSet<T,thash>::copy_list (LN* l) const {
 //    if (l == nullptr)
 //      return nullptr;
 //    else
-//      return new LN(l->value, copy_list(l->next));
+//      return new LN(l->value, l->hash_code, copy_list(l->next));
 
   //Iterative: order in bin makes no difference, but Trailer must be at end
   if (l->next == nullptr)
     return new LN();
 
-   LN* answer = new LN(l->value,new LN());
+   LN* answer = new LN(l->value,l->hash_code,new LN());
    for (LN* c = l->next; c->next != nullptr; c = c->next)
-     answer = new LN(c->value,answer);
+     answer = new LN(c->value,c->hash_code,answer);
 
   return answer;
 }
 
 
 template<class T, int (*thash)(const T& a)>
-typename HashSet<T,thash>::LN** HashSet<T,thash>::copy_hash_table (LN** ht, int bins) const {
+typename HashSet<T,thash>::LN** HashSet<T,thash>::copy_hash_table (LN** ht, size_type bins) const {
   LN** answer = new LN*[bins];
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
      answer[b] = copy_list(ht[b]);
   return answer;
 }
 
 
 template<class T, int (*thash)(const T& a)>
-void HashSet<T,thash>::ensure_load_threshold(int new_used) {
+bool HashSet<T,thash>::contains_node (const HashSet<T,thash>& from, const LN* n) const {
+  return find_element(n->value, hash == from.hash ? n->hash_code : call_hash(n->value)) != nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool HashSet<T,thash>::all_in (const HashSet<T,thash>& s) const {
+  for (size_type b=0; b<bins; ++b)
+    for (LN* c=set[b]; c->next!=nullptr; c=c->next)
+      if (!s.contains_node(*this,c))
+        return false;
+
+  return true;
+}
+
+
+//The answer has as many bins as this set (and its hash), so the elements kept
+//  from set[b] all go into answer.set[b]: threads filling disjoint ranges of
+//  bins need no locking. The answer is shrunk afterward if it kept few elements.
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::filter (const HashSet<T,thash>& s, bool in_s, int threads) const {
+  HashSet<T,thash> answer(load_threshold,hash);
+  answer.rehash(bins);
+  if (threads <= 0)
+    threads = std::max(1,int(std::thread::hardware_concurrency()));
+  threads = int(std::max<size_type>(1,std::min<size_type>(threads,used/parallel_grain)));
+
+  std::vector<size_type> kept(threads,0);
+  auto fill = [&] (int t) {
+    size_type count = 0;
+    size_type last  = bins*(t+1)/threads;
+    for (size_type b=bins*t/threads; b<last; ++b)
+      for (LN* c=set[b]; c->next!=nullptr; c=c->next)
+        if (s.contains_node(*this,c) == in_s) {
+          answer.set[b] = new LN(c->value,c->hash_code,answer.set[b]);
+          ++count;
+        }
+    kept[t] = count;
+  };
+
+  std::vector<std::thread> workers;
+  for (int t=1; t<threads; ++t)
+    workers.push_back(std::thread(fill,t));
+  fill(0);
+  for (std::thread& w : workers)
+    w.join();
+
+  for (size_type count : kept)
+    answer.used += count;
+  answer.ensure_load_threshold_low(answer.used);
+  return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::insert_hashed(const T& element, int hash_code) {
+  LN* c = find_element(element,hash_code);
+  if (c != nullptr)
+      return 0;
+
+  ensure_load_threshold(used+1);
+
+  ++used;
+  ++mod_count;
+  size_type bin = compress(hash_code);                  //bins may have changed in ensure_load_threshold!
+  set[bin] = new LN(element,hash_code,set[bin]);  //easy to put at front: bin LNs unordered
+  bloom_insert(hash_code);
+  return 1;
+}
+
+
+//Callers erasing many elements shrink the table once, at the end
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::erase_hashed(const T& element, int hash_code) {
+  LN* c = find_element(element,hash_code);
+  if (c == nullptr)
+    return 0;
+
+  LN* to_delete = c->next;
+  *c = std::move(*(c->next));
+  delete to_delete;
+  --used;
+  ++mod_count;
+  bloom_erase(1);
+  return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+size_type HashSet<T,thash>::erase_where(const HashSet<T,thash>& s, bool in_s) {
+  size_type count = 0;
+  for (size_type b=0; b<bins; ++b)
+    for (LN* c=set[b]; c->next!=nullptr; /*See body*/) {
+      if (s.contains_node(*this,c) != in_s)
+        c = c-> next;
+      else{
+        LN* to_delete = c->next;
+        *c = std::move(*(c->next));
+        delete to_delete;
+        ++count;
+      }
+    }
+
+  if (count > 0) {
+    used -= count;
+    ++mod_count;
+    bloom_erase(count);
+    ensure_load_threshold_low(used);
+  }
+  return count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::ensure_load_threshold(size_type new_used) {
   if (double(new_used)/double(bins) <= load_threshold)
     return;
 
-  LN** old_set  = set;
-  int  old_bins = bins;
+  resize_table(2*bins);
+}
+
+
+//Bulk operations (insert_all, build_parallel, set operators) size the table with this, not with
+//  reserve, so the bins they need do not stop later erases from shrinking it
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::grow_for(size_type n) {
+  if (bins_for(n) > bins)
+    rehash(bins_for(n));
+}
+
+
+//Shrinking to half of load_threshold (not to load_threshold/4) leaves room to
+//  grow back by 2x before growing again, so alternating insert/erase near a
+//  boundary never rehashes on each call; never shrinks below reserved_bins
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::ensure_load_threshold_low(size_type new_used) {
+  if (bins <= reserved_bins || double(new_used)/double(bins) >= load_threshold/4)
+    return;
+
+  rehash(std::max(bins_for(2*new_used),reserved_bins));
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::resize_table(size_type new_bins) {
+  ++rehashes;
+  LN**      old_set  = set;
+  size_type old_bins = bins;
 
-  bins = 2*old_bins;
+  bins = new_bins;
   set = new LN*[bins];
 
-  for (int b=0; b<bins; ++b)
+  for (size_type b=0; b<bins; ++b)
     set[b] = new LN();
 
-  for (int b=0; b<old_bins; ++b) {
+  for (size_type b=0; b<old_bins; ++b) {
     LN* c = old_set[b];
     for (; c->next!=nullptr; /*See body*/) {
-      int bin = hash_compress(c->value);
+      size_type bin = compress(c->hash_code);  //no need to call hash again
       LN* to_move = c;
       c = c->next;
       to_move->next = set[bin];
@@ -606,12 +1231,48 @@ void HashSet<T,thash>::ensure_load_threshold(int new_used) {
     delete c;           //deallocate trailers in old_map
   }
   delete [] old_set;
+
+  if (bloom != nullptr)
+    rebuild_bloom();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::bloom_insert(int hash_code) {
+  if (bloom == nullptr)
+    return;
+
+  if (bloom->full())
+    rebuild_bloom();            //the new element's node is already linked
+  else
+    bloom->insert(hash_code);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::bloom_erase(size_type count) {
+  if (bloom == nullptr)
+    return;
+
+  bloom->note_erase(count);
+  if (bloom->stale())
+    rebuild_bloom();
+}
+
+
+//Moves no nodes, so it is safe while an Iterator is erasing
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::rebuild_bloom() {
+  bloom->reset(2*used);
+  for (size_type b=0; b<bins; ++b)
+    for (LN* c=set[b]; c->next!=nullptr; c=c->next)
+      bloom->insert(c->hash_code);
 }
 
 
 template<class T, int (*thash)(const T& a)>
-void HashSet<T,thash>::delete_hash_table (LN**& ht, int bins) {
-  for (int b=0; b<bins; ++b)
+void HashSet<T,thash>::delete_hash_table (LN**& ht, size_type bins) {
+  for (size_type b=0; b<bins; ++b)
     for (LN* c=ht[b]; c!=nullptr; /*See body*/) {
       LN* to_delete = c;
       c = c->next;
@@ -636,7 +1297,7 @@ void HashSet<T,thash>::Iterator::advance_cursors() {
     current.second = current.second->next;
     return;
   }else
-    for (int b=current.first+1; b<ref_set->bins; ++b)
+    for (size_type b=current.first+1; b<ref_set->bins; ++b)
       if (ref_set->set[b]->next != nullptr) {
         current.first  = b;
         current.second = ref_set->set[b];
@@ -673,12 +1334,13 @@ T HashSet<T,thash>::Iterator::erase() {
     throw CannotEraseError("HashSet::Iterator::erase Iterator cursor beyond data structure");
 
   can_erase = false;
-  T to_return = current.second->value;
+  T to_return = std::move(current.second->value);
   LN* to_delete = current.second->next;
 
-  *current.second = *(current.second->next);
+  *current.second = std::move(*(current.second->next));
   --ref_set->used;
   ++ref_set->mod_count;
+  ref_set->bloom_erase(1);
   expected_mod_count = ref_set->mod_count;
   delete to_delete;
 
@@ -0,0 +1,320 @@
+#ifndef INDEXED_HEAP_HPP_
+#define INDEXED_HEAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include "ics_exceptions.hpp"
+#include "size_hint.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedgtdefined
+#define undefinedgtdefined
+template<class T>
+bool undefinedgt (const T& a, const T& b) {return false;}
+#endif /* undefinedgtdefined */
+
+//A binary heap of the indexes 0..capacity()-1 (e.g., a CompressedGraph's node
+//  ids), each with a key: the index whose key has the highest priority comes
+//  out first. The index is the handle: each index is in the heap at most once,
+//  and decrease_key(index,key) moves it up in place (O(log N)) instead of
+//  enqueueing a second entry to be skipped later, as a HeapPriorityQueue must.
+//The heap array holds (key,index) entries, so sifting compares keys without
+//  indirection; position[index] tracks where each index's entry is.
+//
+//Instantiate the templated class supplying tgt(a,b): true, iff key a has higher priority than key b.
+//If tgt is defaulted to undefinedgt in the template, then a constructor must supply cgt.
+//If both tgt and cgt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedgt value supplied by tgt/cgt is stored in the instance variable gt.
+template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class IndexedHeap {
+  public:
+    typedef bool (*gtfunc) (const T& a, const T& b);
+
+    //Destructor/Constructors (copying/moving copies/moves each array)
+    ~IndexedHeap();
+    explicit IndexedHeap(int capacity = 0, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+
+    //Queries
+    bool      empty    ()          const;
+    size_type size     ()          const;
+    int       capacity ()          const;   //Indexes are in [0,capacity())
+    bool      contains (int index) const;
+    const T&  key      (int index) const;   //KeyError if index is not in the heap
+    int       peek     ()          const;   //The index with the highest-priority key; EmptyError if empty
+    const T&  peek_key ()          const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Commands
+    void push         (int index, const T& key);   //KeyError if index is already in the heap
+    int  pop          ();                          //Removes and returns peek(); EmptyError if empty
+    void decrease_key (int index, const T& key);   //key must not have lower priority than key(index): else IcsError
+    void erase        (int index);                 //Does nothing if index is not in the heap
+    void clear        ();                          //O(size()): the arrays keep their capacity
+    void reset        (int capacity);              //Clears, and allows indexes in [0,capacity)
+
+    template<class T2, bool (*gt2)(const T2& a, const T2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const IndexedHeap<T2,gt2>& h);
+
+
+  private:
+    struct Entry {
+      T   key;
+      int index;
+    };
+
+    bool (*gt) (const T& a, const T& b);   //The gt used to order keys (from template or constructor)
+    std::vector<Entry> heap;                //heap[0..size()-1] has the heap ordering property
+    std::vector<int>   position;            //position[index] is index's place in heap; -1 if not in it
+
+    //Helper methods
+    bool call_gt    (const T& a, const T& b) const;   //tgt(a,b) if given (a direct call: inlinable), else gt(a,b)
+    void check      (int index, const char* where) const;   //IcsError if index is not in [0,capacity())
+    void sift_up    (size_type i, Entry e);           //Place e at i or above it (moving the hole, not swapping)
+    void sift_down  (size_type i, Entry e);           //Place e at i or below it
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//IndexedHeap class and related definitions
+
+//Destructor/Constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+IndexedHeap<T,tgt>::~IndexedHeap() {
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+IndexedHeap<T,tgt>::IndexedHeap(int capacity, bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+  if (gt == (gtfunc)undefinedgt<T>)
+    throw TemplateFunctionError("IndexedHeap::constructor: neither specified");
+  if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+    throw TemplateFunctionError("IndexedHeap::constructor: both specified and different");
+  reset(capacity);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool IndexedHeap<T,tgt>::empty() const {
+  return heap.empty();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+size_type IndexedHeap<T,tgt>::size() const {
+  return size_type(heap.size());
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int IndexedHeap<T,tgt>::capacity() const {
+  return int(position.size());
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool IndexedHeap<T,tgt>::contains(int index) const {
+  return index >= 0 && index < capacity() && position[index] != -1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+const T& IndexedHeap<T,tgt>::key(int index) const {
+  if (!contains(index)) {
+    std::ostringstream answer;
+    answer << "IndexedHeap::key: index(" << index << ") not in heap";
+    throw KeyError(answer.str());
+  }
+  return heap[position[index]].key;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int IndexedHeap<T,tgt>::peek() const {
+  if (empty())
+    throw EmptyError("IndexedHeap::peek");
+  return heap[0].index;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+const T& IndexedHeap<T,tgt>::peek_key() const {
+  if (empty())
+    throw EmptyError("IndexedHeap::peek_key");
+  return heap[0].key;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::string IndexedHeap<T,tgt>::str() const {
+  std::ostringstream answer;
+  answer << "IndexedHeap[";
+  for (size_type i=0; i<size(); ++i)
+    answer << (i == 0 ? "" : ",") << i << ":" << heap[i].index << "(" << heap[i].key << ")";
+  answer << "](size=" << size() << ",capacity=" << capacity() << ")";
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::push(int index, const T& key) {
+  check(index,"push");
+  if (position[index] != -1) {
+    std::ostringstream answer;
+    answer << "IndexedHeap::push: index(" << index << ") already in heap";
+    throw KeyError(answer.str());
+  }
+  heap.push_back(Entry{key,index});
+  sift_up(size()-1,heap.back());
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int IndexedHeap<T,tgt>::pop() {
+  if (empty())
+    throw EmptyError("IndexedHeap::pop");
+  int answer = heap[0].index;
+  position[answer] = -1;
+  Entry last = heap.back();
+  heap.pop_back();
+  if (!empty())
+    sift_down(0,last);
+  return answer;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::decrease_key(int index, const T& key) {
+  if (!contains(index)) {
+    std::ostringstream answer;
+    answer << "IndexedHeap::decrease_key: index(" << index << ") not in heap";
+    throw KeyError(answer.str());
+  }
+  size_type i = position[index];
+  if (call_gt(heap[i].key,key))
+    throw IcsError("IndexedHeap::decrease_key: new key has lower priority");
+  sift_up(i,Entry{key,index});
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::erase(int index) {
+  if (!contains(index))
+    return;
+  size_type i = position[index];
+  position[index] = -1;
+  Entry last = heap.back();
+  heap.pop_back();
+  if (i == size())                    //Erased the last entry: nothing to fill
+    return;
+  if (i != 0 && call_gt(last.key,heap[(i-1)/2].key))
+    sift_up(i,last);
+  else
+    sift_down(i,last);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::clear() {
+  for (const Entry& e : heap)
+    position[e.index] = -1;
+  heap.clear();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::reset(int capacity) {
+  heap.clear();
+  position.assign(std::max(capacity,0),-1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+//Entries in heap-array order (the first has the highest priority), not sorted
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::ostream& operator << (std::ostream& outs, const IndexedHeap<T,tgt>& h) {
+  outs << "indexed_heap[";
+  for (size_type i=0; i<h.size(); ++i)
+    outs << (i == 0 ? "" : ",") << h.heap[i].index << ":" << h.heap[i].key;
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool IndexedHeap<T,tgt>::call_gt (const T& a, const T& b) const {
+  return tgt != (gtfunc)undefinedgt<T> ? tgt(a,b) : gt(a,b);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::check(int index, const char* where) const {
+  if (index < 0 || index >= capacity()) {
+    std::ostringstream answer;
+    answer << "IndexedHeap::" << where << ": index(" << index << ") not in [0," << capacity() << ")";
+    throw IcsError(answer.str());
+  }
+}
+
+
+//Parents with lower-priority keys move down into the hole at i until e fits
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::sift_up(size_type i, Entry e) {
+  while (i != 0) {
+    size_type parent = (i-1)/2;
+    if (!call_gt(e.key,heap[parent].key))
+      break;
+    heap[i] = heap[parent];
+    position[heap[i].index] = int(i);
+    i = parent;
+  }
+  heap[i] = e;
+  position[e.index] = int(i);
+}
+
+
+//Children with higher-priority keys move up into the hole at i until e fits
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void IndexedHeap<T,tgt>::sift_down(size_type i, Entry e) {
+  for (size_type child = 2*i+1; child < size(); child = 2*i+1) {
+    if (child+1 < size() && call_gt(heap[child+1].key,heap[child].key))
+      ++child;
+    if (!call_gt(heap[child].key,e.key))
+      break;
+    heap[i] = heap[child];
+    position[heap[i].index] = int(i);
+    i = child;
+  }
+  heap[i] = e;
+  position[e.index] = int(i);
+}
+
+}
+
+#endif /* INDEXED_HEAP_HPP_ */